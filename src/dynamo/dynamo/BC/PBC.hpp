@@ -17,6 +17,8 @@
 
 #pragma once
 #include <dynamo/BC/BC.hpp>
+#include <dynamo/simulation.hpp>
+#include <cmath>
 
 namespace dynamo {
   /*! \brief A simple rectangular periodic boundary condition, also a
@@ -39,6 +41,19 @@ namespace dynamo {
     virtual void outputXML(magnet::xml::XmlStream&) const;
     virtual void operator<<(const magnet::xml::Node&);
 
+    /*! \brief The minimum image of a position vector in the primary
+      cell.
+
+      This is the non-virtual implementation of applyBC(), so it can
+      be inlined by code which has already checked that the boundary
+      condition is exactly a BCPeriodic.
+     */
+    inline void minimumImage(Vector& pos) const
+    {
+      for (size_t n = 0; n < NDIM; ++n)
+	pos[n] -= Sim->primaryCellSize[n] * lrint(pos[n] / Sim->primaryCellSize[n]);
+    }
+
   protected:
     BCPeriodic(const dynamo::Simulation* const SD, const char *aName):
       BoundaryCondition(SD, aName) {}
@@ -18,9 +18,17 @@
 #pragma once
 
 #include <dynamo/2particleEventData.hpp>
-#include <list>
+#include <magnet/containers/small_vector.hpp>
+#include <memory>
+#include <vector>
 
 namespace dynamo {
+  /*! \brief The changes made to the particles by an event.
+
+    The changes are stored contiguously. The common single particle
+    and pair events are stored inside the NEventData without
+    allocating.
+   */
   class NEventData
   {
   public:
@@ -31,7 +39,59 @@ namespace dynamo {
     NEventData&  operator+=(const ParticleEventData& p) { L1partChanges.push_back(p); return *this; }
     NEventData&  operator+=(const PairEventData& p) { L2partChanges.push_back(p); return *this; }
 
-    std::list<ParticleEventData> L1partChanges;
-    std::list<PairEventData> L2partChanges;
+    //! \brief Remove all the changes, keeping any allocated storage.
+    void clear() { L1partChanges.clear(); L2partChanges.clear(); }
+
+    magnet::containers::SmallVector<ParticleEventData, 2> L1partChanges;
+    magnet::containers::SmallVector<PairEventData, 1> L2partChanges;
+  };
+
+  /*! \brief A pool of NEventData buffers owned by the Simulation,
+    which are reused between events.
+
+    Events which change many particles (e.g., SysRescale) borrow a
+    buffer through a NEventDataPool::Buffer, which returns it to the
+    pool when destroyed. The buffers keep their storage, so after the
+    first few events recording an event does not allocate. More than
+    one buffer may be borrowed at a time, in case an event is run
+    while another is being processed.
+   */
+  class NEventDataPool
+  {
+  public:
+    //! \brief A cleared NEventData borrowed from a NEventDataPool.
+    class Buffer
+    {
+    public:
+      explicit Buffer(NEventDataPool& pool): _pool(pool), _data(pool.take()) {}
+      ~Buffer() { _pool.give(std::move(_data)); }
+
+      NEventData& operator*() const { return *_data; }
+      NEventData* operator->() const { return _data.get(); }
+
+    private:
+      Buffer(const Buffer&);
+      Buffer& operator=(const Buffer&);
+
+      NEventDataPool& _pool;
+      std::unique_ptr<NEventData> _data;
+    };
+
+  private:
+    std::unique_ptr<NEventData> take()
+    {
+      if (_free.empty())
+	return std::unique_ptr<NEventData>(new NEventData);
+
+      std::unique_ptr<NEventData> data(std::move(_free.back()));
+      _free.pop_back();
+      data->clear();
+      return data;
+    }
+
+    void give(std::unique_ptr<NEventData>&& data)
+    { _free.push_back(std::move(data)); }
+
+    std::vector<std::unique_ptr<NEventData> > _free;
   };
 }
@@ -63,7 +63,7 @@ namespace dynamo {
     systemopts.add_options()
       ("help", "Produces this message")
       ("n-threads,N", po::value<unsigned int>(),
-       "Number of threads to spawn for concurrent processing. (Only utilised by certain engine/sim configurations)")
+       "Number of threads to spawn for concurrent processing. Replica exchange runs the replicas concurrently, otherwise the threads are only used for the parts of a simulation outside of the (serial) event loop, such as rebuilding the event lists")
       ("out-config-file,o", po::value<std::string>(),
        "Default config output file,(config.%ID.end.xml.bz2)")
       ("out-data-file", po::value<std::string>(),
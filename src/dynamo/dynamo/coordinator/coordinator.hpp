@@ -112,16 +112,18 @@ namespace dynamo {
      */
     boost::program_options::variables_map vm;
 
-    /*! \brief A smart pointer to the Engine being run.
-     */
-    shared_ptr<Engine> _engine;
-
     /*! \brief A thread pool to utilise multiple cores on the
       computational node.
       
       This ThreadPool is used/referenced by all code in a single
-      dynarun process.
+      dynarun process. It is declared before the Engine so that it
+      outlives it, as the Simulations may still have work on the pool
+      (e.g., background snapshot writes) when they are destroyed.
     */
     magnet::thread::ThreadPool _threads;
+
+    /*! \brief A smart pointer to the Engine being run.
+     */
+    shared_ptr<Engine> _engine;
   };
 }
@@ -48,6 +48,12 @@ namespace dynamo {
       ("unwrapped", "Don't apply the boundary conditions of the system when writing out the particle positions.")
       ("snapshot", boost::program_options::value<double>(),
        "Sets the system time inbetween saving snapshots of the system.")
+      ("binary-snapshot", "Write the snapshot configurations in the binary (.dbin) format.")
+      ("validate-level", boost::program_options::value<size_t>()->default_value(2),
+       "How thoroughly the configuration is checked for invalid states (e.g., overlaps) on loading: "
+       "0 skips the checks, 1 checks a sample of the particles, 2 checks every particle.")
+      ("check-interaction-lookup", "Check every Interaction found through the pair lookup table against a linear "
+       "search of the Interactions (slow).")
       ;
   
     opts.add(simopts);
@@ -89,6 +95,10 @@ namespace dynamo {
     
     Sim.status = CONFIG_LOADED;
     Sim.endEventCount = vm["events"].as<size_t>();
+    Sim.validateLevel = vm["validate-level"].as<size_t>();
+    if (Sim.validateLevel > 2)
+      M_throw() << "Unknown --validate-level " << Sim.validateLevel << ", it must be 0, 1 or 2";
+    Sim.checkInteractionLookup = vm.count("check-interaction-lookup");
   
     if (vm["events"].as<size_t>() 
 	> vm["print-events"].as<size_t>())
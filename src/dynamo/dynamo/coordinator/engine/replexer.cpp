@@ -24,6 +24,8 @@
 #include <dynamo/systems/snapshot.hpp>
 #include <magnet/thread/threadpool.hpp>
 #include <magnet/string/searchreplace.hpp>
+#include <algorithm>
+#include <chrono>
 #include <fstream>
 #include <limits>
 #include <signal.h>
@@ -50,6 +52,16 @@ namespace dynamo {
        "  2: \tRandom pair per swap\n"
        "  3: \t5 * Nsim random pairs per swap\n"
        "  4: \tRandom selection of the above methods")
+      ("replex-async",
+       "Exchange each pair of neighbouring temperatures as soon as both "
+       "systems have reached their exchange time, instead of halting every "
+       "system for each exchange. The pairs alternate as in swap mode 1.")
+      ("replex-adaptive",
+       "Tune the exchange interval of each temperature from its measured "
+       "run time, so that every system takes the same wall clock time "
+       "between exchanges. The coldest temperature keeps the replex-interval. "
+       "As the intervals depend on the wall clock time, the results are not "
+       "reproducible, even with the same random seed.")
       ;
   
     opts.add(ropts);
@@ -63,7 +75,11 @@ namespace dynamo {
     replexSwapCalls(0),
     round_trips(0),
     SeqSelect(false),
-    nSims(0)
+    nSims(0),
+    _async(false),
+    _adaptive(false),
+    _busyTime(0),
+    _replicaFailed(false)
   {
     if (vm["events"].as<size_t>() != std::numeric_limits<size_t>::max())
       M_throw() << "You cannot use collisions to control a replica exchange simulation\n"
@@ -82,7 +98,7 @@ namespace dynamo {
 		 vm["config-file"].as<std::vector<std::string> >()[i]);
 
 	if (vm.count("snapshot"))
-	  Simulations[i].systems.push_back(shared_ptr<System>(new SSnapshot(&(Simulations[i]), vm["snapshot"].as<double>(), "SnapshotEvent", "ID%ID.%COUNT", !vm.count("unwrapped"))));
+	  Simulations[i].systems.push_back(shared_ptr<System>(new SSnapshot(&(Simulations[i]), vm["snapshot"].as<double>(), "SnapshotEvent", "ID%ID.%COUNT", !vm.count("unwrapped"), vm.count("binary-snapshot"))));
 
 	Simulations[i].initialise();
 
@@ -127,6 +143,10 @@ namespace dynamo {
 
 	temperatureList.push_back
 	  (replexPair(Simulations[i].ensemble->getEnsembleVals()[2], simData(i,Simulations[i].ensemble->getReducedEnsembleVals()[2])));
+
+	//A continued run counts the time already run towards the end
+	//time
+	temperatureList.back().second.elapsedTime = Simulations[i].systemTime / Simulations[i].units.unitTime();
       }
   
     std::sort(temperatureList.begin(), temperatureList.end());  
@@ -165,6 +185,8 @@ namespace dynamo {
     Engine::preSimInit();
 
     ReplexMode = static_cast<Replex_Mode_Type>(vm["replex-swap-mode"].as<unsigned int>());
+    _async = vm.count("replex-async");
+    _adaptive = vm.count("replex-adaptive");
   
     nSims = vm["config-file"].as<std::vector<std::string> >().size();
   
@@ -185,6 +207,7 @@ namespace dynamo {
 	" file doesnt contain %ID";  
   
     Simulations.reset(new Simulation[nSims]);
+    _segments.resize(nSims);
 
     //We set this straight away
     for (size_t id(0); id < nSims; ++id)
@@ -273,37 +296,47 @@ namespace dynamo {
     //Update the counters indicating the replexSwap count
     ++replexSwapCalls;
 
-    for (size_t i(0); i < nSims; ++i)
-      ++(Simulations[i].replexExchangeNumber);
+    for (size_t slot(0); slot < temperatureList.size(); ++slot)
+      ReplexSlotTicker(slot);
+  }
+
+  void 
+  EReplicaExchangeSimulation::ReplexSlotTicker(size_t slot)
+  {
+    simData& dat = temperatureList[slot].second;
+
+    ++(Simulations[dat.simID].replexExchangeNumber);
 
     //Now update the histogramming
-    for (replexPair& dat : temperatureList)
-      if (SimDirection[dat.second.simID])
-	{
-	  if (SimDirection[dat.second.simID] > 0)
-	    ++dat.second.upSims;
-	  else
-	    ++dat.second.downSims;
-	}
+    if (SimDirection[dat.simID])
+      {
+	if (SimDirection[dat.simID] > 0)
+	  ++dat.upSims;
+	else
+	  ++dat.downSims;
+      }
 
-    if (SimDirection[temperatureList.front().second.simID] == -1)
+    if ((slot == 0) && (SimDirection[dat.simID] == -1))
       {
-	if (roundtrip[temperatureList.front().second.simID])
+	if (roundtrip[dat.simID])
 	  ++round_trips;
 	
-	roundtrip[temperatureList.front().second.simID] = true;
+	roundtrip[dat.simID] = true;
       }
  
-    if (SimDirection[temperatureList.back().second.simID] == 1)
+    if ((slot + 1 == temperatureList.size()) && (SimDirection[dat.simID] == 1))
       {
-	if (roundtrip[temperatureList.back().second.simID])
+	if (roundtrip[dat.simID])
 	  ++round_trips;
 
-	roundtrip[temperatureList.back().second.simID] = true;
+	roundtrip[dat.simID] = true;
       }
 
-    SimDirection[temperatureList.front().second.simID] = 1; //Going up
-    SimDirection[temperatureList.back().second.simID] = -1; //Going down
+    if (slot == 0)
+      SimDirection[dat.simID] = 1; //Going up
+
+    if (slot + 1 == temperatureList.size())
+      SimDirection[dat.simID] = -1; //Going down
   }
 
   void 
@@ -331,33 +364,57 @@ namespace dynamo {
   }
 
   void
-  EReplicaExchangeSimulation::outputData()
+  EReplicaExchangeSimulation::ReplexStatsOutput()
   {
     {
       std::fstream replexof("replex.dat",std::ios::out | std::ios::trunc);
     
-      for (const replexPair& myPair : temperatureList)
-	replexof << myPair.second.realTemperature << " " 
-		 << myPair.second.swaps << " " 
-		 << (static_cast<double>(myPair.second.swaps) 
-		     / static_cast<double>(myPair.second.attempts))  << " "
-		 << myPair.second.upSims << " "
-		 << myPair.second.downSims
-		 << "\n";
+      for (size_t slot(0); slot < temperatureList.size(); ++slot)
+	{
+	  const simData& dat = temperatureList[slot].second;
+	  replexof << dat.realTemperature << " " 
+		   << dat.swaps << " " 
+		   << (static_cast<double>(dat.swaps) 
+		       / static_cast<double>(dat.attempts))  << " "
+		   << dat.upSims << " "
+		   << dat.downSims << " "
+		   << (dat.busyTime ? dat.events / dat.busyTime : 0.0) << " "
+		   << getExchangeInterval(slot)
+		   << "\n";
+	}
     
       replexof.close();      
     }
   
     {      
+      timespec endTime;
+      clock_gettime(CLOCK_MONOTONIC, &endTime);
+	    
+      const double duration = double(endTime.tv_sec) - double(_startTime.tv_sec)
+	+ 1e-9 * (double(endTime.tv_nsec) - double(_startTime.tv_nsec));
+
+      const double cores = std::max(size_t(1), threads.getThreadCount());
+
       std::fstream replexof("replex.stats", std::ios::out | std::ios::trunc);
     
       replexof << "Number_of_replex_cycles " << replexSwapCalls
 	       << "\nTime_spent_replexing " <<  boost::posix_time::to_simple_string(end_Time - start_Time)
 	       << "\nReplex Rate " << static_cast<double>(replexSwapCalls) / static_cast<double>((end_Time - start_Time).total_seconds())
+	       << "\nExchange_mode " << (_async ? "Asynchronous" : "Barrier")
+	       << "\nAdaptive_intervals " << (_adaptive ? "On" : "Off")
+	       << "\nThreads " << threads.getThreadCount()
+	       << "\nBusy_time " << _busyTime
+	       << "\nCore_utilisation " << (duration > 0 ? _busyTime / (duration * cores) : 0.0)
 	       << "\n";	
     
       replexof.close();
     }    
+  }
+
+  void
+  EReplicaExchangeSimulation::outputData()
+  {
+    ReplexStatsOutput();
   
     int i = 0;
   
@@ -366,200 +423,418 @@ namespace dynamo {
       ((magnet::string::search_replace(outputFormat, "%ID", boost::lexical_cast<std::string>(i++))).c_str());
   }
 
-  void EReplicaExchangeSimulation::runSimulation()
+  size_t 
+  EReplicaExchangeSimulation::getSlot(size_t simID) const
   {
-    clock_gettime(CLOCK_MONOTONIC, &_startTime);
-    start_Time = boost::posix_time::second_clock::local_time();
+    for (size_t slot(0); slot < temperatureList.size(); ++slot)
+      if (size_t(temperatureList[slot].second.simID) == simID)
+	return slot;
 
-    while (((Simulations[0].systemTime / Simulations[0].units.unitTime()) < replicaEndTime)
-	   && (Simulations[0].eventCount < vm["events"].as<size_t>()))
-      {
-	if (_SIGTERM)
-	  {
-	    replicaEndTime = 0.0;
-	    for (unsigned int i = 0; i < nSims; i++)
-	      Simulations[i].simShutdown();
-	    _SIGTERM = false;
-	    continue;
-	  }
+    M_throw() << "Could not find the temperature of Simulation " << simID;
+  }
 
-	if (_SIGINT)
-	  {
-	    //Clear the writes to screen
-	    std::cout.flush();
-	    std::cerr << "\n<S>hutdown, <D>ata or <P>eek at data output:";
-	      
-	    char c;
-	    //Clear the input buffer
-	    std::cin.clear();
-	    setvbuf(stdin, NULL, _IONBF, 0);
-	    c=getchar();
-	    setvbuf(stdin, NULL, _IOLBF, 0);
-	    _SIGINT = false;
-
-	    switch (c)
-	      {
-	      case 's':
-	      case 'S':
-		{
-		  replicaEndTime = 0.0;
-		  for (unsigned int i = 0; i < nSims; i++)
-		    Simulations[i].simShutdown();
-		  continue;
-		  break;
-		}
-	      case 'p':
-	      case 'P':
-		{
-		  end_Time = boost::posix_time::second_clock::local_time();
-		  
-		  size_t i = 0;
-		  for (replexPair p1 : temperatureList)
-		    {
-		      Simulations[p1.second.simID].endEventCount = vm["events"].as<size_t>();
-		      Simulations[p1.second.simID].outputData((magnet::string::search_replace(std::string("peek.data.%ID.xml.bz2"), 
-											      "%ID", boost::lexical_cast<std::string>(i++))));
-		    }
-		  
-		  {
-		    std::fstream replexof("replex.dat",std::ios::out | std::ios::trunc);
-		    
-		    for (const replexPair& myPair : temperatureList)
-		      replexof << myPair.second.realTemperature << " " 
-			       << myPair.second.swaps << " " 
-			       << (static_cast<double>(myPair.second.swaps) 
-				   / static_cast<double>(myPair.second.attempts))  << " "
-			       << myPair.second.upSims << " "
-			       << myPair.second.downSims
-			       << "\n";
-		    
-		    replexof.close();      
-		  }
-		  
-		  {      
-		    std::fstream replexof("replex.stats", std::ios::out | std::ios::trunc);
-		    
-		    replexof << "Number_of_replex_cycles " << replexSwapCalls
-			     << "\nTime_spent_replexing " <<  boost::posix_time::to_simple_string(end_Time - start_Time)
-			     << "\nReplex Rate " << static_cast<double>(replexSwapCalls) / static_cast<double>((end_Time - start_Time).total_seconds())
-			     << "\n";	
-		    
-		    replexof.close();
-		  }		  
-		  break;
-		}
-	      case 'd':
-	      case 'D':
-		{
-		  std::cout << "Replica Exchange, ReplexSwap No." << replexSwapCalls 
-			    << ", Round Trips " << round_trips
-			    << "\n        T   ID     NColl   A-Ratio     Swaps    UpSims     DownSims\n";
-
-		  for (const replexPair& dat : temperatureList)
-		    {       
-		      std::cout << std::setw(9)
-				<< Simulations[dat.second.simID].ensemble->getReducedEnsembleVals()[2] 
-				<< " " << std::setw(4)
-				<< dat.second.simID
-				<< " " << std::setw(8)
-				<< Simulations[dat.second.simID].eventCount/1000 << "k" 
-				<< " " << std::setw(9)
-				<< ( static_cast<double>(dat.second.swaps) / dat.second.attempts)
-				<< " " << std::setw(9)
-				<< dat.second.swaps 
-				<< " " << std::setw(9)
-				<< dat.second.upSims
-				<< " "
-				<< (SimDirection[dat.second.simID] > 0 ? "/\\" : "  ")
-				<< " " << std::setw(9)
-				<< dat.second.downSims
-				<< " "
-				<< (SimDirection[dat.second.simID] < 0 ? "\\/" : "  ")
-				<< "\n";
-		    }
-		  break;
-		}
-	      }
-	    {
-	      struct sigaction new_action;
-	      new_action.sa_handler = Coordinator::signal_handler;
-	      sigemptyset(&new_action.sa_mask);
-	      new_action.sa_flags = 0;
-	      sigaction(SIGINT, &new_action, NULL);
-	    }
-	  }
-	  {
-	    //Run the simulations. We also generate all tasks at once
-	    //and submit them all at once to minimise lock contention.
-	    std::vector<std::function<void()> > tasks;
-	    tasks.reserve(nSims);
+  double 
+  EReplicaExchangeSimulation::getTimeFactor(size_t slot) const
+  {
+    return std::sqrt(temperatureList.front().second.realTemperature
+		     / temperatureList[slot].second.realTemperature); 
+  }
 
-	    for (size_t i(0); i < nSims; ++i)
-	      tasks.push_back(std::bind(&Simulation::runSimulation, &static_cast<Simulation&>(Simulations[i]), true));
+  double 
+  EReplicaExchangeSimulation::getExchangeInterval(size_t slot) const
+  {
+    const double tFactor = getTimeFactor(slot);
+    const double interval = vm["replex-interval"].as<double>();
+
+    const double coldWallTime = temperatureList.front().second.wallTimePerUnit;
+    const double wallTime = temperatureList[slot].second.wallTimePerUnit;
+    if (!_adaptive || (coldWallTime <= 0) || (wallTime <= 0))
+      return interval * tFactor;
+
+    //Limit the change from the default interval, as the run times of
+    //short runs are noisy
+    const double factor = std::min(10 * tFactor, std::max(0.1 * tFactor, coldWallTime / wallTime));
+    return interval * factor;
+  }
 
-	    threads.queueTasks(tasks);
-	    threads.wait();//This syncs the systems for the replica exchange
-		  
-	    //Swap calculation
-	    ReplexSwap(ReplexMode);
-		  
-	    ReplexSwapTicker();
-		  
-	    //Reset the stop events
-	    for (size_t i = nSims; i != 0;)
-	      {
-		//Reset the stop event
-		shared_ptr<SystHalt> tmpRef = std::dynamic_pointer_cast<SystHalt>
-		  (Simulations[--i].systems["ReplexHalt"]);
+  void 
+  EReplicaExchangeSimulation::setNextExchange(size_t slot)
+  {
+    Simulation& sim = Simulations[temperatureList[slot].second.simID];
+
+    //Reset the stop event
+    shared_ptr<SystHalt> tmpRef = std::dynamic_pointer_cast<SystHalt>(sim.systems["ReplexHalt"]);
 		
 #ifdef DYNAMO_DEBUG
-		if (!tmpRef)
-		  M_throw() << "Could not find the time halt event error";
+    if (!tmpRef)
+      M_throw() << "Could not find the time halt event error";
 #endif			
-		//Each simulations exchange time is inversly proportional to its temperature
-		double tFactor 
-		  = std::sqrt(temperatureList.begin()->second.realTemperature
-			      / Simulations[i].ensemble->getReducedEnsembleVals()[2]); 
 
-		tmpRef->increasedt(vm["replex-interval"].as<double>() * tFactor);
+    tmpRef->increasedt(getExchangeInterval(slot));
+
+    sim.ptrScheduler->rebuildSystemEvents();
+
+    //Reset the max collisions
+    sim.endEventCount = vm["events"].as<size_t>();
+  }
+
+  void 
+  EReplicaExchangeSimulation::runReplica(size_t simID)
+  {
+    Simulation& sim = Simulations[simID];
+
+    timespec startTime;
+    clock_gettime(CLOCK_MONOTONIC, &startTime);
+    const size_t startEvents = sim.eventCount;
+    const double startSimTime = sim.systemTime;
+
+    try { sim.runSimulation(true); }
+    catch (...)
+      {
+	//Wake the main thread, the exception is rethrown by the
+	//ThreadPool
+	std::lock_guard<std::mutex> lock(_finishedMutex);
+	_replicaFailed = true;
+	_finishedSims.push_back(simID);
+	_finishedCondition.notify_all();
+	throw;
+      }
+
+    timespec endTime;
+    clock_gettime(CLOCK_MONOTONIC, &endTime);
+
+    segmentData& seg = _segments[simID];
+    seg.wallTime = double(endTime.tv_sec) - double(startTime.tv_sec)
+      + 1e-9 * (double(endTime.tv_nsec) - double(startTime.tv_nsec));
+    seg.events = sim.eventCount - startEvents;
+    seg.simTime = (sim.systemTime - startSimTime) / sim.units.unitTime();
 
-		Simulations[i].ptrScheduler->rebuildSystemEvents();
+    std::lock_guard<std::mutex> lock(_finishedMutex);
+    _finishedSims.push_back(simID);
+    _finishedCondition.notify_all();
+  }
 
-		//Reset the max collisions
-		Simulations[i].endEventCount = vm["events"].as<size_t>();
-	      }
+  void 
+  EReplicaExchangeSimulation::queueReplica(size_t slot)
+  {
+    _slotState[slot] = Running;
+    threads.queueTask(std::bind(&EReplicaExchangeSimulation::runReplica, this, size_t(temperatureList[slot].second.simID)));
+  }
 
-	    timespec endTime;
-	    clock_gettime(CLOCK_MONOTONIC, &endTime);
+  void 
+  EReplicaExchangeSimulation::recordSegment(size_t slot)
+  {
+    simData& dat = temperatureList[slot].second;
+    const segmentData& seg = _segments[dat.simID];
+
+    dat.events += seg.events;
+    dat.busyTime += seg.wallTime;
+    dat.elapsedTime += seg.simTime;
+    _busyTime += seg.wallTime;
+
+    if ((seg.simTime > 0) && (seg.wallTime > 0))
+      {
+	const double sample = seg.wallTime / seg.simTime;
+	dat.wallTimePerUnit = (dat.wallTimePerUnit > 0) ? 0.5 * (dat.wallTimePerUnit + sample) : sample;
+      }
+  }
+
+  bool
+  EReplicaExchangeSimulation::handleSignals()
+  {
+    if (_SIGTERM)
+      {
+	replicaEndTime = 0.0;
+	for (unsigned int i = 0; i < nSims; i++)
+	  Simulations[i].simShutdown();
+	_SIGTERM = false;
+	return true;
+      }
+
+    if (!_SIGINT) return false;
+
+    //Clear the writes to screen
+    std::cout.flush();
+    std::cerr << "\n<S>hutdown, <D>ata or <P>eek at data output:";
+	      
+    char c;
+    //Clear the input buffer
+    std::cin.clear();
+    setvbuf(stdin, NULL, _IONBF, 0);
+    c=getchar();
+    setvbuf(stdin, NULL, _IOLBF, 0);
+    _SIGINT = false;
+
+    bool shutdown = false;
+    switch (c)
+      {
+      case 's':
+      case 'S':
+	{
+	  replicaEndTime = 0.0;
+	  for (unsigned int i = 0; i < nSims; i++)
+	    Simulations[i].simShutdown();
+	  shutdown = true;
+	  break;
+	}
+      case 'p':
+      case 'P':
+	{
+	  end_Time = boost::posix_time::second_clock::local_time();
+		  
+	  size_t i = 0;
+	  for (replexPair p1 : temperatureList)
+	    {
+	      Simulations[p1.second.simID].endEventCount = vm["events"].as<size_t>();
+	      Simulations[p1.second.simID].outputData((magnet::string::search_replace(std::string("peek.data.%ID.xml.bz2"), 
+										      "%ID", boost::lexical_cast<std::string>(i++))));
+	    }
+		  
+	  ReplexStatsOutput();
+	  break;
+	}
+      case 'd':
+      case 'D':
+	{
+	  std::cout << "Replica Exchange, ReplexSwap No." << replexSwapCalls 
+		    << ", Round Trips " << round_trips
+		    << "\n        T   ID     NColl   A-Ratio     Swaps    UpSims     DownSims\n";
+
+	  for (const replexPair& dat : temperatureList)
+	    {       
+	      std::cout << std::setw(9)
+			<< Simulations[dat.second.simID].ensemble->getReducedEnsembleVals()[2] 
+			<< " " << std::setw(4)
+			<< dat.second.simID
+			<< " " << std::setw(8)
+			<< Simulations[dat.second.simID].eventCount/1000 << "k" 
+			<< " " << std::setw(9)
+			<< ( static_cast<double>(dat.second.swaps) / dat.second.attempts)
+			<< " " << std::setw(9)
+			<< dat.second.swaps 
+			<< " " << std::setw(9)
+			<< dat.second.upSims
+			<< " "
+			<< (SimDirection[dat.second.simID] > 0 ? "/\\" : "  ")
+			<< " " << std::setw(9)
+			<< dat.second.downSims
+			<< " "
+			<< (SimDirection[dat.second.simID] < 0 ? "\\/" : "  ")
+			<< "\n";
+	    }
+	  break;
+	}
+      }
+
+    {
+      struct sigaction new_action;
+      new_action.sa_handler = Coordinator::signal_handler;
+      sigemptyset(&new_action.sa_mask);
+      new_action.sa_flags = 0;
+      sigaction(SIGINT, &new_action, NULL);
+    }
+
+    return shutdown;
+  }
+
+  void 
+  EReplicaExchangeSimulation::printProgress(double fractionComplete)
+  {
+    timespec endTime;
+    clock_gettime(CLOCK_MONOTONIC, &endTime);
 	    
-	    double duration = double(endTime.tv_sec) - double(_startTime.tv_sec)
-	      + 1e-9 * (double(endTime.tv_nsec) - double(_startTime.tv_nsec));
+    double duration = double(endTime.tv_sec) - double(_startTime.tv_sec)
+      + 1e-9 * (double(endTime.tv_nsec) - double(_startTime.tv_nsec));
 	    
-	    double fractionComplete = (Simulations[0].systemTime / Simulations[0].units.unitTime()) / replicaEndTime;
-	    double seconds_remaining_double = duration * (1/ fractionComplete - 1);
-	    size_t seconds_remaining = seconds_remaining_double;
+    double seconds_remaining_double = duration * (1/ fractionComplete - 1);
+    size_t seconds_remaining = seconds_remaining_double;
 	    
-	    if (seconds_remaining_double < std::numeric_limits<size_t>::max())
-	      {
-		size_t ETA_hours = seconds_remaining / 3600;
-		size_t ETA_mins = (seconds_remaining / 60) % 60;
-		size_t ETA_secs = seconds_remaining % 60;
+    if (seconds_remaining_double < std::numeric_limits<size_t>::max())
+      {
+	size_t ETA_hours = seconds_remaining / 3600;
+	size_t ETA_mins = (seconds_remaining / 60) % 60;
+	size_t ETA_secs = seconds_remaining % 60;
 		
-		std::cout << "\rReplica Exchange No." << replexSwapCalls << ", ETA ";
-		if (ETA_hours)
-		  std::cout << ETA_hours << "hr ";
+	std::cout << "\rReplica Exchange No." << replexSwapCalls << ", ETA ";
+	if (ETA_hours)
+	  std::cout << ETA_hours << "hr ";
 		
-		if (ETA_mins)
-		  std::cout << ETA_mins << "min ";
+	if (ETA_mins)
+	  std::cout << ETA_mins << "min ";
 		
-		std::cout << ETA_secs << "s        ";
-		std::cout.flush();
-	      }
-	  }
+	std::cout << ETA_secs << "s        ";
+	std::cout.flush();
       }
+  }
+
+  void EReplicaExchangeSimulation::runSimulation()
+  {
+    clock_gettime(CLOCK_MONOTONIC, &_startTime);
+    start_Time = boost::posix_time::second_clock::local_time();
+
+    if (_async)
+      runAsynchronous();
+    else
+      runBarrier();
+
     end_Time = boost::posix_time::second_clock::local_time();
   }
 
+  void EReplicaExchangeSimulation::runBarrier()
+  {
+    while (((Simulations[0].systemTime / Simulations[0].units.unitTime()) < replicaEndTime)
+	   && (Simulations[0].eventCount < vm["events"].as<size_t>()))
+      {
+	if (handleSignals())
+	  continue;
+
+	//Run the simulations. We also generate all tasks at once
+	//and submit them all at once to minimise lock contention.
+	std::vector<std::function<void()> > tasks;
+	tasks.reserve(nSims);
+
+	for (size_t i(0); i < nSims; ++i)
+	  tasks.push_back(std::bind(&EReplicaExchangeSimulation::runReplica, this, i));
+
+	threads.queueTasks(tasks);
+	threads.wait();//This syncs the systems for the replica exchange
+	_finishedSims.clear();
+
+	for (size_t slot(0); slot < nSims; ++slot)
+	  recordSegment(slot);
+		  
+	//Swap calculation
+	ReplexSwap(ReplexMode);
+		  
+	ReplexSwapTicker();
+		  
+	//Reset the stop events
+	for (size_t slot(0); slot < nSims; ++slot)
+	  setNextExchange(slot);
+
+	printProgress((Simulations[0].systemTime / Simulations[0].units.unitTime()) / replicaEndTime);
+      }
+  }
+
+  bool 
+  EReplicaExchangeSimulation::advanceSlot(size_t slot)
+  {
+    if (_slotState[slot] != Waiting)
+      return false;
+
+    simData& dat = temperatureList[slot].second;
+
+    //Each temperature runs for the end time scaled by its time
+    //factor, whichever Simulations occupied it
+    if (dat.elapsedTime >= replicaEndTime * getTimeFactor(slot))
+      {
+	_slotState[slot] = Finished;
+	return true;
+      }
+
+    //Pairs alternate between (0,1),(2,3)... and (1,2),(3,4)...
+    const bool up = ((slot + dat.phase) % 2) == 0;
+    const bool hasPartner = up ? (slot + 1 < nSims) : (slot > 0);
+    const size_t partner = up ? slot + 1 : slot - 1;
+	
+    if (!hasPartner || (_slotState[partner] == Finished))
+      {
+	//No exchange for this phase
+	if (slot == 0) ++replexSwapCalls;
+	ReplexSlotTicker(slot);
+	++dat.phase;
+	setNextExchange(slot);
+	queueReplica(slot);
+	return true;
+      }
+
+    //The partner is still running, or waiting for its other
+    //neighbour, to reach this phase
+    if ((_slotState[partner] != Waiting) || (temperatureList[partner].second.phase != dat.phase))
+      return false;
+
+    if (ReplexMode != NoSwapping)
+      AttemptSwap(std::min(slot, partner), std::max(slot, partner));
+
+    for (const size_t id : {slot, partner})
+      {
+	if (id == 0) ++replexSwapCalls;
+	ReplexSlotTicker(id);
+	++temperatureList[id].second.phase;
+	setNextExchange(id);
+	queueReplica(id);
+      }
+
+    return true;
+  }
+
+  void EReplicaExchangeSimulation::runAsynchronous()
+  {
+    _slotState.assign(nSims, Running);
+    for (size_t slot(0); slot < nSims; ++slot)
+      queueReplica(slot);
+
+    bool paused = false;
+    while (std::count(_slotState.begin(), _slotState.end(), Running))
+      {
+	//Without worker threads the tasks are run here
+	if (!threads.getThreadCount())
+	  threads.wait();
+
+	std::vector<size_t> finished;
+	bool failed;
+	{
+	  std::unique_lock<std::mutex> lock(_finishedMutex);
+	  //Wake periodically to check for signals
+	  if (_finishedSims.empty())
+	    _finishedCondition.wait_for(lock, std::chrono::milliseconds(100));
+	  finished.swap(_finishedSims);
+	  failed = _replicaFailed;
+	}
+
+	for (const size_t simID : finished)
+	  {
+	    const size_t slot = getSlot(simID);
+	    recordSegment(slot);
+	    _slotState[slot] = Waiting;
+	  }
+	
+	//Stop starting new runs, the exception is rethrown below
+	if (failed) continue;
+
+	//Signals are handled once all of the simulations are halted
+	if (_SIGINT || _SIGTERM)
+	  paused = true;
+
+	if (paused)
+	  {
+	    if (std::count(_slotState.begin(), _slotState.end(), Running))
+	      continue;
+	    handleSignals();
+	    paused = false;
+	  }
+
+	bool changed = true;
+	while (changed)
+	  {
+	    changed = false;
+	    for (size_t slot(0); slot < nSims; ++slot)
+	      changed |= advanceSlot(slot);
+	  }
+
+	if (!finished.empty())
+	  {
+	    double fractionComplete = 1;
+	    for (size_t slot(0); slot < nSims; ++slot)
+	      fractionComplete = std::min(fractionComplete, temperatureList[slot].second.elapsedTime / (replicaEndTime * getTimeFactor(slot)));
+	    printProgress(fractionComplete);
+	  }
+      }
+
+    //Rethrow any exception from the tasks
+    threads.wait();
+  }
+
   void 
   EReplicaExchangeSimulation::outputConfigs()
   {
@@ -22,6 +22,8 @@
 
 #include <dynamo/coordinator/engine/engine.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
+#include <condition_variable>
+#include <mutex>
 #include <memory>
 #include <ctime>
 
@@ -35,7 +37,12 @@ namespace dynamo {
     velocities.
    
     This class uses the ThreadPool to parallelise the running of the
-    simulations.
+    simulations. By default every simulation is halted before an
+    exchange is attempted, so each exchange phase runs at the pace of
+    the slowest simulation. In the asynchronous mode
+    (--replex-async) each pair of neighbouring temperatures exchanges
+    as soon as both simulations have halted, and the other
+    simulations carry on running.
    */
   class EReplicaExchangeSimulation: public Engine
   {
@@ -106,7 +113,8 @@ namespace dynamo {
        */
       explicit simData(int ID, double rT):
 	simID(ID), swaps(0), attempts(0), upSims(0), downSims(0),
-	realTemperature(rT)
+	realTemperature(rT), phase(0), events(0), busyTime(0),
+	wallTimePerUnit(0), elapsedTime(0)
       {}
 
       /*! \brief compares simData by their contained simulation ID's
@@ -131,6 +139,45 @@ namespace dynamo {
       size_t downSims;
       /*! \brief The temperature of this simulation point */
       double realTemperature;
+      /*! \brief The number of exchange phases completed at this
+        temperature in the asynchronous mode. */
+      size_t phase;
+      /*! \brief The number of events run at this temperature. */
+      size_t events;
+      /*! \brief The wall clock time (in seconds) spent running
+        simulations at this temperature. */
+      double busyTime;
+      /*! \brief A running average of the wall clock time (in
+        seconds) taken to run a unit of simulation time at this
+        temperature. */
+      double wallTimePerUnit;
+      /*! \brief The simulation time (in reduced units) run at this
+        temperature.
+
+	The Simulations move between temperatures when they are
+	swapped, so this is summed over the runs at this temperature
+	rather than taken from the Simulation occupying it.
+      */
+      double elapsedTime;
+    };
+
+    //! \brief The state of a temperature in the asynchronous mode.
+    typedef enum {
+      Running = 0, /*!< The simulation is running to its next exchange.*/
+      Waiting = 1, /*!< The simulation is halted, waiting for an exchange.*/
+      Finished = 2 /*!< The simulation has reached its end time.*/
+    } Replica_State_Type;
+
+    /*! \brief The wall clock time, events and simulation time taken
+      by the last run of a Simulation.
+     */
+    struct segmentData
+    {
+      segmentData(): wallTime(0), events(0), simTime(0) {}
+
+      double wallTime;
+      size_t events;
+      double simTime;
     };
 
     typedef std::pair<double, simData> replexPair;
@@ -193,6 +240,47 @@ namespace dynamo {
 
     timespec _startTime;
 
+    /*! \brief If the simulations exchange asynchronously.
+     */
+    bool _async;
+
+    /*! \brief If the exchange intervals are tuned from the measured
+      run times of the simulations.
+
+      As the intervals depend on the wall clock time, runs in this
+      mode are not reproducible, even with the same random seed.
+     */
+    bool _adaptive;
+
+    /*! \brief The total wall clock time (in seconds) spent running
+      the simulations, summed over all threads.
+     */
+    double _busyTime;
+
+    /*! \brief The state of each temperature in the asynchronous mode.
+     */
+    std::vector<Replica_State_Type> _slotState;
+
+    /*! \brief The measurements of the last run of each Simulation,
+      indexed by the Simulation ID.
+     */
+    std::vector<segmentData> _segments;
+
+    /*! \brief Simulation IDs which have completed a run but have
+      not yet been collected by the main thread.
+     */
+    std::vector<size_t> _finishedSims;
+
+    /*! \brief Set if a Simulation threw an exception while running.
+     */
+    bool _replicaFailed;
+
+    /*! \brief Guards _finishedSims and _replicaFailed. */
+    std::mutex _finishedMutex;
+
+    /*! \brief Notified each time a Simulation completes a run. */
+    std::condition_variable _finishedCondition;
+
     /*! \brief Initialises this class ready for the replica exchange.
      */
     virtual void preSimInit();
@@ -229,6 +317,90 @@ namespace dynamo {
      */
     void ReplexSwapTicker();
 
+    /*! \brief Update the replica exchange data collected for a
+      single temperature, after it has completed an exchange phase.
+     */
+    void ReplexSlotTicker(size_t slot);
+
+    /*! \brief Output the replica exchange statistics to replex.dat
+      and replex.stats.
+     */
+    void ReplexStatsOutput();
+
+    /*! \brief Run all of the Simulations to their next exchange,
+      waiting for every Simulation before attempting the exchanges.
+     */
+    void runBarrier();
+
+    /*! \brief Run the Simulations, exchanging each pair of
+      neighbouring temperatures as soon as both have halted.
+
+      The pairs alternate between the two sets of neighbours (as in
+      the AlternatingSequence mode). Each temperature counts its own
+      exchange phases, and only exchanges with the neighbour at the
+      same phase, so the sequence of exchange attempts does not
+      depend on the timing of the threads.
+     */
+    void runAsynchronous();
+
+    /*! \brief Try to start the next run of a Waiting temperature in
+      the asynchronous mode.
+
+      \return True if the state of any temperature changed.
+     */
+    bool advanceSlot(size_t slot);
+
+    /*! \brief The task which runs a single Simulation to its next
+      exchange, measuring the time taken.
+     */
+    void runReplica(size_t simID);
+
+    /*! \brief Queue the task to run the Simulation at a temperature.
+     */
+    void queueReplica(size_t slot);
+
+    /*! \brief Accumulate the measurements of the last run at a
+      temperature.
+     */
+    void recordSegment(size_t slot);
+
+    /*! \brief The temperature index currently holding a Simulation.
+     */
+    size_t getSlot(size_t simID) const;
+
+    /*! \brief The factor (T_cold/T_i)^{1/2} which scales the
+      exchange interval and end time of a temperature.
+     */
+    double getTimeFactor(size_t slot) const;
+
+    /*! \brief The simulation time to run a temperature for before
+      its next exchange.
+
+      This is the replex-interval scaled by getTimeFactor(). If the
+      intervals are adaptive and run times have been measured, it is
+      instead scaled so that every temperature takes the same wall
+      clock time as the coldest temperature between exchanges, so
+      the exchanges (and the trajectories) are no longer reproducible.
+     */
+    double getExchangeInterval(size_t slot) const;
+
+    /*! \brief Move the halt event of a temperature on to its next
+      exchange.
+     */
+    void setNextExchange(size_t slot);
+
+    /*! \brief Handle any pending SIGINT or SIGTERM.
+
+      This must only be called while no Simulation is running.
+
+      \return True if the simulations have been shut down.
+     */
+    bool handleSignals();
+
+    /*! \brief Print the estimated time remaining.
+     */
+    void printProgress(double fractionComplete);
+
     /*! \brief Attempt a replica exchange move between two configurations.
      
       \param id1 First Simulation to attempt to exchange.
@@ -96,10 +96,13 @@ namespace dynamo {
 	(vm["config-file"].as<std::vector<std::string> >().size() != 1))
       M_throw() << "You must only provide one input file in single mode";
 
+    //This engine runs the Simulation from the main thread, so the
+    //Simulation is free to make use of the thread pool
+    simulation.threads = &threads;
     setupSim(simulation, vm["config-file"].as<std::vector<std::string> >()[0]);
 
     if (vm.count("snapshot"))
-      simulation.systems.push_back(shared_ptr<System>(new SSnapshot(&simulation, vm["snapshot"].as<double>(), "SnapshotEvent", "%COUNT", !vm.count("unwrapped"))));
+      simulation.systems.push_back(shared_ptr<System>(new SSnapshot(&simulation, vm["snapshot"].as<double>(), "SnapshotEvent", "%COUNT", !vm.count("unwrapped"), vm.count("binary-snapshot"))));
 
     simulation.initialise();
 
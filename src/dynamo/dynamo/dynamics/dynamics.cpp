@@ -23,7 +23,10 @@
 #include <dynamo/BC/LEBC.hpp>
 #include <magnet/xmlwriter.hpp>
 #include <magnet/xmlreader.hpp>
+#include <magnet/thread/threadpool.hpp>
 #include <cstring>
+#include <functional>
+#include <sstream>
 
 namespace dynamo {
   magnet::xml::XmlStream& operator<<(magnet::xml::XmlStream& XML, const Dynamics& g)
@@ -105,26 +108,102 @@ namespace dynamo {
   Dynamics::getPBCSentinelTime(const Particle&, const double&) const
   { M_throw() << "Not implemented for this Dynamics."; }
 
+  namespace {
+    //! \brief Reads a Vector from the current tag, as operator<<(Vector, Node) does.
+    void loadVector(const magnet::xml::PullParser& parser, Vector& vec)
+    {
+      for (size_t iDim = 0; iDim < NDIM; iDim++) 
+	{
+	  char name[2] = "x";
+	  name[0] = 'x' + iDim; //Write the name
+	  if (parser.getAttribute(name) == NULL)
+	    name[0] = '0' + iDim;
+	  vec[iDim] = parser.getAttributeAs<double>(name);
+	}
+    }
+  }
+
   void 
-  Dynamics::loadParticleXMLData(const magnet::xml::Node& XML)
+  Dynamics::loadParticleXMLData(const magnet::xml::Node& XML, magnet::xml::PullParser& parser)
   {
     dout << "Loading Particle Data" << std::endl;
 
+    const magnet::xml::Node particleNode = XML.getNode("ParticleData");
+    const bool orientation = particleNode.hasAttribute("OrientationData");
     bool outofsequence = false;  
-  
-    for (magnet::xml::Node node = XML.getNode("ParticleData").fastGetNode("Pt"); 
-	 node.valid(); ++node)
+
+    //Reserve the storage if the writer recorded the particle count
+    if (particleNode.hasAttribute("N"))
       {
-	if (!node.hasAttribute("ID")
-	    || node.getAttribute("ID").as<size_t>() != Sim->particles.size())
-	  outofsequence = true;
-      
-	Particle part(node, Sim->particles.size());
-	part.getVelocity() *= Sim->units.unitVelocity();
-	part.getPosition() *= Sim->units.unitLength();
-	Sim->particles.push_back(part);
+	Sim->particles.reserve(particleNode.getAttribute("N").as<size_t>());
+	if (orientation)
+	  orientationData.reserve(particleNode.getAttribute("N").as<size_t>());
       }
 
+    if (!parser.isEmptyTag())
+      while (parser.nextTag() && !(parser.isEndTag() && (parser.name() == "ParticleData")))
+	{
+	  if ((parser.name() != "Pt") || parser.isEndTag())
+	    M_throw() << "XML error at line " << parser.line() << ": Expected a <Pt> tag in the ParticleData but found <"
+		      << (parser.isEndTag() ? "/" : "") << parser.name() << ">";
+
+	  const size_t ID = Sim->particles.size();
+	  const std::string* IDattr = parser.getAttribute("ID");
+	  size_t fileID;
+	  if ((IDattr == NULL) || !magnet::xml::parseValue(IDattr->c_str(), fileID) || (fileID != ID))
+	    outofsequence = true;
+
+	  const bool isStatic = parser.getAttribute("Static") != NULL;
+	  Sim->_properties.loadParticleXMLData(parser);
+
+	  bool hasPos(false), hasVel(false), hasU(false), hasO(false);
+	  Vector pos, vel;
+	  rotData rdata;
+	  if (!parser.isEmptyTag())
+	    while (parser.nextTag() && !parser.isEndTag())
+	      {
+		if (parser.name() == "P")
+		  { hasPos = true; loadVector(parser, pos); }
+		else if (parser.name() == "V")
+		  { hasVel = true; loadVector(parser, vel); }
+		else if (parser.name() == "O")
+		  { hasO = true; loadVector(parser, rdata.angularVelocity); }
+		else if (parser.name() == "U")
+		  { 
+		    hasU = true;
+		    loadVector(parser, rdata.orientation.imaginary());
+		    rdata.orientation.real() = parser.getAttributeAs<double>("w");
+		  }
+
+		if (!parser.isEmptyTag())
+		  M_throw() << "XML error at line " << parser.line() << ": Unexpected content in the <"
+			    << parser.name() << "> tag of particle " << ID;
+	      }
+
+	  if (!hasPos || !hasVel)
+	    M_throw() << "XML error at line " << parser.line() << ": Particle " << ID << " is missing its "
+		      << (hasPos ? "V" : "P") << " tag";
+
+	  Particle part(pos, vel, ID);
+	  if (isStatic) part.clearState(Particle::DYNAMIC);
+	  part.getVelocity() *= Sim->units.unitVelocity();
+	  part.getPosition() *= Sim->units.unitLength();
+	  Sim->particles.push_back(part);
+
+	  if (orientation)
+	    {
+	      if (!hasU || !hasO)
+		M_throw() << "XML error at line " << parser.line() << ": Particle " << ID << " is missing its "
+			  << (hasU ? "O" : "U") << " tag";
+
+	      //Makes the vector a unit vector
+	      rdata.orientation.normalise();
+	      if (rdata.orientation.nrm() == 0)
+		M_throw() << "Particle " << ID << " has an invalid zero orientation quaternion";
+	      orientationData.push_back(rdata);
+	    }
+	}
+
     if (outofsequence)
       dout << "Particle ID's out of sequence!\n"
 	   << "This can result in incorrect capture map loads etc.\n"
@@ -133,25 +212,9 @@ namespace dynamo {
     Sim->N = Sim->particles.size();
 
     dout << "Particle count " << Sim->N << std::endl;
-
-    if (XML.getNode("ParticleData").hasAttribute("OrientationData"))
-      {
-	orientationData.resize(Sim->N);
-	size_t i(0);
-	for (magnet::xml::Node node = XML.getNode("ParticleData").fastGetNode("Pt"); node.valid(); ++node, ++i)
-	  {
-	    orientationData[i].orientation << node.getNode("U");
-	    orientationData[i].angularVelocity << node.getNode("O");
-      
-	    //Makes the vector a unit vector
-	    orientationData[i].orientation.normalise();
-	    if (orientationData[i].orientation.nrm() == 0)
-	      M_throw() << "Particle " << i << " has an invalid zero orientation quaternion";
-	  }
-      }
   }
 
-  void 
+  void
   Dynamics::outputParticleXMLData(magnet::xml::XmlStream& XML, bool applyBC) const
   {
     XML << magnet::xml::tag("ParticleData");
@@ -159,7 +222,43 @@ namespace dynamo {
     if (hasOrientationData())
       XML << magnet::xml::attr("OrientationData") << "Y";
 
-    for (size_t i = 0; i < Sim->N; ++i)
+    const size_t nBlocks = (Sim->threads && Sim->N) ? Sim->threads->getThreadCount() * 4 : 0;
+    if (nBlocks)
+      {
+	//Close the ParticleData start tag, so the blocks of particles
+	//can be formatted into separate streams and written in order
+	XML << magnet::xml::chardata();
+
+	std::vector<std::ostringstream> blocks(nBlocks);
+	std::vector<std::function<void()> > tasks;
+	tasks.reserve(nBlocks);
+	for (size_t i(0); i < nBlocks; ++i)
+	  tasks.push_back(std::bind(&Dynamics::formatParticleXMLBlock, this, std::ref(XML), std::ref(blocks[i]),
+				    (i * Sim->N) / nBlocks, ((i + 1) * Sim->N) / nBlocks, applyBC));
+	Sim->threads->queueTasks(tasks);
+	Sim->threads->wait();
+
+	for (const std::ostringstream& block : blocks)
+	  XML.getUnderlyingStream() << block.str();
+      }
+    else
+      outputParticleXMLBlock(XML, 0, Sim->N, applyBC);
+  
+    XML << magnet::xml::endtag("ParticleData");
+  }
+
+  void
+  Dynamics::formatParticleXMLBlock(magnet::xml::XmlStream& parent, std::ostringstream& os, size_t begin, size_t end, bool applyBC) const
+  {
+    os.copyfmt(parent.getUnderlyingStream());
+    magnet::xml::XmlStream XML(os, parent);
+    outputParticleXMLBlock(XML, begin, end, applyBC);
+  }
+
+  void
+  Dynamics::outputParticleXMLBlock(magnet::xml::XmlStream& XML, size_t begin, size_t end, bool applyBC) const
+  {
+    for (size_t i = begin; i < end; ++i)
       {
 	Particle tmp(Sim->particles[i]);
 	if (applyBC) 
@@ -182,8 +281,114 @@ namespace dynamo {
 
 	XML << magnet::xml::endtag("Pt");
       }
-  
-    XML << magnet::xml::endtag("ParticleData");
+  }
+
+  namespace {
+    void readBinary(std::istream& is, void* data, const size_t bytes)
+    {
+      if (!is.read(static_cast<char*>(data), bytes))
+	M_throw() << "Unexpected end of the binary particle data";
+    }
+
+    //! The padding after the N dynamic flags, to realign to doubles.
+    size_t flagPadding(const size_t N)
+    { return (sizeof(double) - N % sizeof(double)) % sizeof(double); }
+  }
+
+  void
+  Dynamics::loadParticleBinaryData(const magnet::xml::Node& XML, std::istream& is)
+  {
+    dout << "Loading Binary Particle Data" << std::endl;
+
+    const magnet::xml::Node particleNode = XML.getNode("ParticleData");
+    const size_t N = particleNode.getAttribute("N").as<size_t>();
+
+    std::vector<double> pos(NDIM * N), vel(NDIM * N);
+    std::vector<char> dynamic(N);
+    readBinary(is, pos.data(), pos.size() * sizeof(double));
+    readBinary(is, vel.data(), vel.size() * sizeof(double));
+    readBinary(is, dynamic.data(), dynamic.size());
+    char padding[sizeof(double)];
+    readBinary(is, padding, flagPadding(N));
+
+    Sim->particles.reserve(N);
+    for (size_t i(0); i < N; ++i)
+      {
+	Particle part(Vector(pos[NDIM * i], pos[NDIM * i + 1], pos[NDIM * i + 2]),
+		      Vector(vel[NDIM * i], vel[NDIM * i + 1], vel[NDIM * i + 2]), i);
+	if (!dynamic[i]) part.clearState(Particle::DYNAMIC);
+	part.getVelocity() *= Sim->units.unitVelocity();
+	part.getPosition() *= Sim->units.unitLength();
+	Sim->particles.push_back(part);
+      }
+
+    Sim->N = Sim->particles.size();
+
+    dout << "Particle count " << Sim->N << std::endl;
+
+    if (particleNode.hasAttribute("OrientationData"))
+      {
+	std::vector<double> angvel(NDIM * N), orientation(4 * N);
+	readBinary(is, angvel.data(), angvel.size() * sizeof(double));
+	readBinary(is, orientation.data(), orientation.size() * sizeof(double));
+
+	orientationData.resize(N);
+	for (size_t i(0); i < N; ++i)
+	  {
+	    orientationData[i].angularVelocity = Vector(angvel[NDIM * i], angvel[NDIM * i + 1], angvel[NDIM * i + 2]);
+	    //The binary data is an exact copy of the state, so the
+	    //orientation is not renormalised
+	    orientationData[i].orientation = Quaternion(orientation[4 * i], orientation[4 * i + 1], orientation[4 * i + 2], orientation[4 * i + 3]);
+	    if (orientationData[i].orientation.nrm() == 0)
+	      M_throw() << "Particle " << i << " has an invalid zero orientation quaternion";
+	  }
+      }
+  }
+
+  void 
+  Dynamics::outputParticleBinaryData(std::ostream& os, bool applyBC) const
+  {
+    std::vector<double> pos(NDIM * Sim->N), vel(NDIM * Sim->N);
+    std::vector<char> dynamic(Sim->N);
+    for (size_t i = 0; i < Sim->N; ++i)
+      {
+	Particle tmp(Sim->particles[i]);
+	if (applyBC) 
+	  Sim->BCs->applyBC(tmp.getPosition(), tmp.getVelocity());
+      
+	tmp.getVelocity() *= (1.0 / Sim->units.unitVelocity());
+	tmp.getPosition() *= (1.0 / Sim->units.unitLength());
+
+	for (size_t iDim(0); iDim < NDIM; ++iDim)
+	  {
+	    pos[NDIM * i + iDim] = tmp.getPosition()[iDim];
+	    vel[NDIM * i + iDim] = tmp.getVelocity()[iDim];
+	  }
+	dynamic[i] = tmp.testState(Particle::DYNAMIC);
+      }
+
+    os.write(reinterpret_cast<const char*>(pos.data()), pos.size() * sizeof(double));
+    os.write(reinterpret_cast<const char*>(vel.data()), vel.size() * sizeof(double));
+    os.write(dynamic.data(), dynamic.size());
+    const char padding[sizeof(double)] = {};
+    os.write(padding, flagPadding(Sim->N));
+
+    if (hasOrientationData())
+      {
+	std::vector<double> angvel(NDIM * Sim->N), orientation(4 * Sim->N);
+	for (size_t i = 0; i < Sim->N; ++i)
+	  {
+	    for (size_t iDim(0); iDim < NDIM; ++iDim)
+	      {
+		angvel[NDIM * i + iDim] = orientationData[i].angularVelocity[iDim];
+		orientation[4 * i + 1 + iDim] = orientationData[i].orientation.imaginary()[iDim];
+	      }
+	    orientation[4 * i] = orientationData[i].orientation.real();
+	  }
+
+	os.write(reinterpret_cast<const char*>(angvel.data()), angvel.size() * sizeof(double));
+	os.write(reinterpret_cast<const char*>(orientation.data()), orientation.size() * sizeof(double));
+      }
   }
 
   double 
@@ -210,15 +415,32 @@ namespace dynamo {
     return 0.5 * energy;
   }
 
-  double 
+  double
   Dynamics::getSystemKineticEnergy() const
   {
-    double sumEnergy(0);
+    //This is the sum of getParticleKineticEnergy() over all
+    //particles, but the boundary condition and species of each
+    //particle are only looked up once.
+    const BCLeesEdwards* LEBC = dynamic_cast<const BCLeesEdwards*>(Sim->BCs.get());
 
-    for (const Particle& part : Sim->particles)
-      sumEnergy += getParticleKineticEnergy(part);
+    double sumEnergy(0);
+    for (const shared_ptr<Species>& sp : Sim->species)
+      for (const size_t ID : *(sp->getRange()))
+	{
+	  const Particle& part = Sim->particles[ID];
+	  const double mass = sp->getMass(ID);
+	  if (!std::isinf(mass))
+	    sumEnergy += mass * (LEBC ? LEBC->getPeculiarVelocity(part).nrm2() : part.getVelocity().nrm2());
+
+	  if (hasOrientationData())
+	    {
+	      const double I = sp->getScalarMomentOfInertia(ID);
+	      if (!std::isinf(I))
+		sumEnergy += I * orientationData[ID].angularVelocity.nrm2();
+	    }
+	}
 
-    return sumEnergy;
+    return 0.5 * sumEnergy;
   }
 
   void
@@ -226,33 +448,35 @@ namespace dynamo {
   {
     double scalefactor(sqrt(scale));
 
-    if (std::dynamic_pointer_cast<BCLeesEdwards>(Sim->BCs))
-      {
-	const BCLeesEdwards& bc = static_cast<const BCLeesEdwards&>(*Sim->BCs);
-	for (Particle& part : Sim->particles)
-	  {
-	    const double mass = Sim->species[part]->getMass(part.getID());
-	    if (!std::isinf(mass))
-	      part.getVelocity() = Vector(bc.getPeculiarVelocity(part) * scalefactor + bc.getStreamVelocity(part));
-	  }
-      }
-    else
-      for (Particle& part : Sim->particles)
-	{
-	  const double mass = Sim->species[part]->getMass(part.getID());
-	  if (!std::isinf(mass))
-	    part.getVelocity() *= scalefactor;
-	}
+    const BCLeesEdwards* LEBC = dynamic_cast<const BCLeesEdwards*>(Sim->BCs.get());
 
-    if (hasOrientationData())
-      for (Particle& part : Sim->particles)
+    for (const shared_ptr<Species>& sp : Sim->species)
+      for (const size_t ID : *(sp->getRange()))
 	{
-	  const double I = Sim->species[part]->getScalarMomentOfInertia(part.getID());
-	  if (!std::isinf(I))
-	    orientationData[part.getID()].angularVelocity *= scalefactor;
+	  Particle& part = Sim->particles[ID];
+	  if (!std::isinf(sp->getMass(ID)))
+	    {
+	      if (LEBC)
+		part.getVelocity() = Vector(LEBC->getPeculiarVelocity(part) * scalefactor + LEBC->getStreamVelocity(part));
+	      else
+		part.getVelocity() *= scalefactor;
+	    }
+
+	  if (hasOrientationData() && !std::isinf(sp->getScalarMomentOfInertia(ID)))
+	    orientationData[ID].angularVelocity *= scalefactor;
 	}
   }
 
+  void
+  Dynamics::streamAllParticles() const
+  {
+    for (Particle& part : Sim->particles)
+      {
+	streamParticle(part, part.getPecTime() + partPecTime);
+	part.getPecTime() = 0;
+      }
+  }
+
   PairEventData 
   Dynamics::parallelCubeColl(const IntEvent& event, 
 				const double& e, 
@@ -21,6 +21,7 @@
 #include <dynamo/particle.hpp>
 #include <dynamo/simulation.hpp>
 #include <magnet/math/quaternion.hpp>
+#include <sstream>
 
 namespace xml { class XmlStream; }
 namespace dynamo {
@@ -81,13 +82,16 @@ namespace dynamo {
      */
     virtual void swapSystem(Dynamics& oDynamics) {}
 
-    /*! \brief Parses the XML data to see if it can load XML particle
-      data or if it needs to decode the binary data. Then loads the
-      particle data.
+    /*! \brief Loads the XML particle data.
+
+      The Pt tags are not part of the xml::Document, they are read
+      directly from the file by the parser, which must have just
+      read the ParticleData start tag.
      
-      \param XML The root xml::Node of the xml::Document which has the ParticleData tag within.
+      \param XML The root xml::Node of the xml::Document which has the (empty) ParticleData tag within.
+      \param parser The parser of the file, positioned after the ParticleData start tag.
      */
-    virtual void loadParticleXMLData(const magnet::xml::Node& XML);
+    virtual void loadParticleXMLData(const magnet::xml::Node& XML, magnet::xml::PullParser& parser);
   
     /*! \brief Writes the XML particle data, either the base64 header or
       the entire XML form.
@@ -96,6 +100,33 @@ namespace dynamo {
      */
     void outputParticleXMLData(magnet::xml::XmlStream& XML, bool applyBC) const;
 
+    /*! \brief Writes the XML of the particles in [begin, end).
+
+      The blocks of particles are formatted in parallel by
+      outputParticleXMLData, if the Simulation has a ThreadPool.
+     */
+    void outputParticleXMLBlock(magnet::xml::XmlStream& XML, size_t begin, size_t end, bool applyBC) const;
+
+    /*! \brief Loads the particle data from the arrays of the binary
+      configuration format.
+
+      \param XML The root xml::Node of the xml::Document which has the
+      (empty) ParticleData tag within.
+      \param is The stream positioned at the start of the particle arrays.
+     */
+    void loadParticleBinaryData(const magnet::xml::Node& XML, std::istream& is);
+
+    /*! \brief Writes the particle data as the arrays of the binary
+      configuration format.
+
+      The positions, then velocities, then the dynamic flag of every
+      particle are written as contiguous arrays, followed by the
+      angular velocities and orientations if present. The dynamic
+      flags are padded to a multiple of sizeof(double), so the arrays
+      which follow stay aligned.
+     */
+    void outputParticleBinaryData(std::ostream& os, bool applyBC) const;
+
     /*! \brief Returns the degrees of freedom per particle.
      */
     inline size_t getParticleDOF() const { return NDIM + 2 * hasOrientationData(); }
@@ -182,6 +213,19 @@ namespace dynamo {
      */
     virtual double SphereSphereOutRoot(const IDRange& p1, const IDRange& p2, double d) const = 0;  
 
+    /*! \brief A cheap test for pairs of particles which are further
+        than d apart and will never come within d of each other.
+
+	This is used to skip the event predictions of pairs which are
+	outside the range of their interaction, so it must only return
+	true if no event would be predicted for the pair. The default
+	implementation never skips a pair.
+
+	\param d The maximum interaction distance of the pair.
+     */
+    virtual bool pairNeverApproaches(const Particle& p1, const Particle& p2, double d) const
+    { return false; }
+
     /*! \brief Determines if two spheres are overlapping
      
       \param d The interaction distance.
@@ -593,11 +637,7 @@ namespace dynamo {
     {
       //May as well take this opportunity to reset the streaming
       //Note: the Replexing coordinator RELIES on this behaviour!
-      for (Particle& part : Sim->particles)
-	{
-	  streamParticle(part, part.getPecTime() + partPecTime);
-	  part.getPecTime() = 0;
-	}
+      streamAllParticles();
 
       partPecTime = 0;
       streamCount = 0;
@@ -726,6 +766,9 @@ namespace dynamo {
   protected:
     friend class GCellsShearing;
 
+    //! \brief A task which formats a block of particles into a separate stream.
+    void formatParticleXMLBlock(magnet::xml::XmlStream& parent, std::ostringstream& os, size_t begin, size_t end, bool applyBC) const;
+
     /*! \brief A dangerous function to predictivly move a particle
       forward.
     
@@ -754,6 +797,15 @@ namespace dynamo {
     /*! \brief Moves the particles data along in time. */
     virtual void streamParticle(Particle& part, const double& dt) const = 0;
 
+    /*! \brief Free streams every particle by its delay and zeros its
+      peculiar time.
+
+      This is the bulk form of streamParticle() used by
+      updateAllParticles(). Dynamics with a simple streaming law may
+      override it with a loop free of virtual calls.
+     */
+    virtual void streamAllParticles() const;
+
     mutable std::vector<rotData> orientationData;
   };
 }
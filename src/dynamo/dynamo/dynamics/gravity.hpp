@@ -33,8 +33,11 @@ namespace dynamo {
     virtual double SphereSphereInRoot(const Particle& p1, const Particle& p2, double d) const;
     virtual double SphereSphereInRoot(const IDRange& p1, const IDRange& p2, double d) const;
     virtual double SphereSphereOutRoot(const Particle& p1, const Particle& p2, double d) const;
+    //! \brief The particles do not travel in straight lines, so no pairs are skipped.
+    virtual bool pairNeverApproaches(const Particle&, const Particle&, double) const { return false; }
     virtual double SphereSphereOutRoot(const IDRange& p1, const IDRange& p2, double d) const;
     virtual void streamParticle(Particle&, const double&) const;
+    virtual void streamAllParticles() const { Dynamics::streamAllParticles(); }
     virtual double getSquareCellCollision2(const Particle&, const Vector &, const Vector &) const;
     virtual int getSquareCellCollision3(const Particle&, const Vector &, const Vector &) const;
     virtual std::pair<bool,double> getPointPlateCollision(const Particle& np1, const Vector& nrw0, const Vector& nhat, const double& Delta, const double& Omega, const double& Sigma, const double& t, bool) const;
@@ -27,6 +27,8 @@
 #include <magnet/xmlwriter.hpp>
 #include <magnet/xmlreader.hpp>
 #include <boost/math/special_functions/fpclassify.hpp>
+#include <algorithm>
+#include <iterator>
 
 namespace dynamo {
   DynNewtonianMCCMap::DynNewtonianMCCMap(dynamo::Simulation* tmp, const magnet::xml::Node& XML):
@@ -86,6 +88,12 @@ namespace dynamo {
       M_throw() << "Multi-canonical simulations require an NVT ensemble";
     
     _interaction = std::dynamic_pointer_cast<ICapture>(Sim->interactions[_interaction_name]);
+
+    if (!_interaction)
+      M_throw() << "Could not cast \"" << _interaction_name << "\" to an ICapture type for the multi-canonical contact map dynamics";
+
+    //W() walks the ordered map at every well event
+    _interaction->keepOrderedView();
   }
 
 
@@ -123,14 +131,11 @@ namespace dynamo {
     double MCDeltaKE = deltaKE;
 
     //If there are entries for the current and possible future energy, then take them into account
-    detail::CaptureMap contact_map = *_interaction;
+    const std::pair<double, double> bias = W(_interaction->getCaptureMap(), detail::PairKey(particle1, particle2), newstate);
     
-    //Add the current bias potential
-    MCDeltaKE += W(contact_map) * Sim->ensemble->getEnsembleVals()[2];
-
-    //subtract the possible bias potential in the new state
-    contact_map[detail::CaptureMap::key_type(particle1, particle2)] = newstate;
-    MCDeltaKE -= W(contact_map) * Sim->ensemble->getEnsembleVals()[2];
+    //Add the current bias potential, and subtract the possible bias
+    //potential in the new state
+    MCDeltaKE += (bias.first - bias.second) * Sim->ensemble->getEnsembleVals()[2];
 
     //Test if the deformed energy change allows a capture event to occur
     double sqrtArg = retVal.rvdot * retVal.rvdot + 2.0 * R2 * MCDeltaKE / mu;
@@ -177,6 +182,37 @@ namespace dynamo {
     std::swap(_W, ol._W);
   }
 
+  size_t
+  DynNewtonianMCCMap::distance(const detail::CaptureMapKey& tether, const detail::CaptureMap& map)
+  {
+    auto il = tether.begin();
+    auto ir = map.begin();
+	
+    size_t distance = 0;
+    while (il != tether.end() && ir != map.end())
+      {
+	if (il->first < ir->first)
+	  {
+	    ++il;
+	    ++distance;
+	  }
+	else if (ir->first < il->first)
+	  {
+	    ++ir;
+	    ++distance;
+	  }
+	else
+	  {
+	    ++il;
+	    ++ir;
+	  }
+      }
+
+    distance += std::distance(il, tether.end());
+    distance += std::distance(ir, map.end());
+    return distance;
+  }
+
   double 
   DynNewtonianMCCMap::W(const detail::CaptureMap& map) const
   {
@@ -185,51 +221,62 @@ namespace dynamo {
     size_t applicable_tethers = 0;
     double accumilated_W = 0;
 
-    for (auto tethermap : _W)
+    for (const auto& tethermap : _W)
+      if (distance(tethermap.first, map) <= tethermap.second._distance)
+	{
+	  ++applicable_tethers;
+	  accumilated_W += tethermap.second._wval;
+	}
+
+    return accumilated_W / (applicable_tethers + (applicable_tethers==0));
+  }
+
+  namespace {
+    bool keyLess(const detail::CaptureMap::value_type& entry, const detail::PairKey& key)
+    { return entry.first < key; }
+  }
+
+  std::pair<double, double>
+  DynNewtonianMCCMap::W(const detail::CaptureMap& map, const detail::PairKey& key, size_t newstate) const
+  {
+    //The distance only counts the pairs present, so it only changes
+    //if the pair is added to or removed from the map
+    const bool wasCaptured = map[key];
+    const bool isCaptured = newstate;
+
+    size_t applicable_tethers[2] = {0, 0};
+    double accumilated_W[2] = {0, 0};
+
+    for (const auto& tethermap : _W)
       {
-	auto il = tethermap.first.begin();
-	auto ir = map.begin();
-	
-	size_t distance = 0;
-	while (il != tethermap.first.end() && ir != map.end())
+	const size_t oldDistance = distance(tethermap.first, map);
+	size_t newDistance = oldDistance;
+	if (wasCaptured != isCaptured)
 	  {
-	    if (il->first < ir->first)
-	      {
-		++il;
-		++distance;
-	      }
-	    else if (ir->first < il->first)
-	      {
-		++ir;
-		++distance;
-	      }
+	    auto it = std::lower_bound(tethermap.first.begin(), tethermap.first.end(), key, keyLess);
+	    const bool inTether = (it != tethermap.first.end()) && (it->first == key);
+	    //Adding a pair in the tether, or removing one which is not,
+	    //brings the map closer to the tether
+	    if (inTether == isCaptured)
+	      --newDistance;
 	    else
-	      {
-		++il;
-		++ir;
-	      }
-	  }
-
-	while (il != tethermap.first.end())
-	  {
-	    ++il;
-	    ++distance;
+	      ++newDistance;
 	  }
 
-	while (ir != map.end())
+	if (oldDistance <= tethermap.second._distance)
 	  {
-	    ++ir;
-	    ++distance;
+	    ++applicable_tethers[0];
+	    accumilated_W[0] += tethermap.second._wval;
 	  }
 
-	if (distance <= tethermap.second._distance)
+	if (newDistance <= tethermap.second._distance)
 	  {
-	    ++applicable_tethers;
-	    accumilated_W += tethermap.second._wval;
+	    ++applicable_tethers[1];
+	    accumilated_W[1] += tethermap.second._wval;
 	  }
       }
 
-    return accumilated_W / (applicable_tethers + (applicable_tethers==0));
+    return std::make_pair(accumilated_W[0] / (applicable_tethers[0] + (applicable_tethers[0]==0)),
+			  accumilated_W[1] / (applicable_tethers[1] + (applicable_tethers[1]==0)));
   }
-
 }
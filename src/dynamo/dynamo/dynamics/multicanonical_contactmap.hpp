@@ -50,7 +50,16 @@ namespace dynamo {
 
     double W(const detail::CaptureMap& map) const;
 
+    /*! \brief Returns the bias potential of a map and of the same
+        map with the state of one pair changed (first and second
+        respectively), without copying the map.
+     */
+    std::pair<double, double> W(const detail::CaptureMap& map, const detail::PairKey& key, size_t newstate) const;
+
   protected:
+    //! \brief The number of pairs in only one of the tether and the map.
+    static size_t distance(const detail::CaptureMapKey& tether, const detail::CaptureMap& map);
+
     virtual void outputXML(magnet::xml::XmlStream& ) const;
   };
 }
@@ -79,6 +79,27 @@ namespace dynamo {
     return magnet::intersection::ray_sphere(r12, v12, d);
   }
   
+  bool
+  DynNewtonian::pairNeverApproaches(const Particle& p1, const Particle& p2, double d) const
+  {
+    Vector r12 = p1.getPosition() - p2.getPosition();
+    Vector v12 = p1.getVelocity() - p2.getVelocity();
+    Sim->BCs->applyBC(r12, v12);
+    //The margin ensures pairs which are only just outside their
+    //interaction range (e.g., due to rounding) are still predicted.
+    const double d2 = d * d * (1 + 1e-6);
+    const double r2 = r12.nrm2();
+    if (r2 <= d2) return false;
+
+    //The particles travel in straight lines, so a receding pair never
+    //approaches
+    const double rvdot = (r12 | v12);
+    if (rvdot >= 0) return true;
+
+    //An approaching pair must pass within d of each other
+    return r2 - rvdot * rvdot / v12.nrm2() > d2;
+  }
+
   double
   DynNewtonian::SphereSphereOutRoot(const Particle& p1, const Particle& p2, double d) const
   {
@@ -148,6 +169,27 @@ namespace dynamo {
       }
   }
 
+  void
+  DynNewtonian::streamAllParticles() const
+  {
+    if (hasOrientationData())
+      return Dynamics::streamAllParticles();
+
+    //A straight line update of every particle, with no virtual calls
+    //in the loop.
+    const double delay = partPecTime;
+    for (Particle& part : Sim->particles)
+      {
+	const double dt = part.getPecTime() + delay;
+	Vector& pos = part.getPosition();
+	const Vector& vel = part.getVelocity();
+	pos[0] += vel[0] * dt;
+	pos[1] += vel[1] * dt;
+	pos[2] += vel[2] * dt;
+	part.getPecTime() = 0;
+      }
+  }
+
   double 
   DynNewtonian::getPlaneEvent(const Particle& part, const Vector& wallLoc, const Vector& wallNorm, double diameter) const
   {
@@ -523,6 +565,7 @@ namespace dynamo {
     Vector  dP = rij * ((1.0 + e) * mu * rvdot / rij.nrm2());
 
     NEventData retVal;
+    retVal.L1partChanges.reserve(range1.size() + range2.size());
     for (const size_t& ID : range1)
       {
 	ParticleEventData tmpval(Sim->particles[ID],
@@ -620,6 +663,7 @@ namespace dynamo {
       }
   
     NEventData retVal;
+    retVal.L1partChanges.reserve(range1.size() + range2.size());
     for (const size_t& ID : range1)
       {
 	ParticleEventData tmpval
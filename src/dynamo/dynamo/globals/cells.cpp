@@ -23,7 +23,7 @@
 #include <dynamo/ranges/IDRangeAll.hpp>
 #include <dynamo/schedulers/scheduler.hpp>
 #include <dynamo/BC/LEBC.hpp>
-#include <dynamo/ranges/IDRangeList.hpp>
+#include <dynamo/systems/cellsAutoTune.hpp>
 #include <magnet/xmlwriter.hpp>
 #include <magnet/xmlreader.hpp>
 #include <cstdio>
@@ -32,6 +32,12 @@
 
 namespace {
   const bool verbose = false;
+
+  //The trial values of each setting when auto-tuning the cells
+  const size_t tuneOverlinks[] = {1, 2, 3};
+  const double tuneOversizes[] = {1.0, 1.2, 1.5, 2.0};
+  const double tuneOverlaps[] = {0.9, 0.5, 0.1};
+  const size_t tuneValueCounts[] = {3, 4, 3};
 }
 
 namespace dynamo {
@@ -40,7 +46,10 @@ namespace dynamo {
     cellDimension(1,1,1),
     _oversizeCells(1.0),
     NCells(0),
-    overlink(overlink)
+    overlink(overlink),
+    _autoTuneEvents(0),
+    _trialCellEvents(0),
+    _trialNeighbours(0)
   {
     globName = name;
     dout << "Cells Loaded" << std::endl;
@@ -51,7 +60,10 @@ namespace dynamo {
     cellDimension(1,1,1),
     _oversizeCells(1.0),
     NCells(0),
-    overlink(1)
+    overlink(1),
+    _autoTuneEvents(0),
+    _trialCellEvents(0),
+    _trialNeighbours(0)
   {
     operator<<(XML);
 
@@ -73,6 +85,15 @@ namespace dynamo {
     
     if (_oversizeCells < 1.0)
       M_throw() << "You must specify an Oversize greater than 1.0, otherwise your cells are too small!";
+
+    if (XML.hasAttribute("Overlap"))
+      lambda = XML.getAttribute("Overlap").as<double>();
+
+    if ((lambda < 0) || (lambda >= 1))
+      M_throw() << "The Overlap of the cells must be in the range [0,1)";
+
+    if (XML.hasAttribute("AutoTune"))
+      _autoTuneEvents = XML.getAttribute("AutoTune").as<size_t>();
     
     globName = XML.getAttribute("Name");
     
@@ -196,7 +217,9 @@ namespace dynamo {
 	  {
 	    newNBCell[dim1] %= cellCount[dim1];
 	    
-	    for (const size_t& next : list[newNBCell.getMortonNum()])
+	    const std::vector<size_t>& cell = list[newNBCell.getMortonNum()];
+	    _trialNeighbours += cell.size();
+	    for (const size_t& next : cell)
 	      _sigNewNeighbour(part, next);
 	  
 	    ++newNBCell[dim1];
@@ -230,6 +253,9 @@ namespace dynamo {
 	     << "," << endCellv[2].getRealValue() << ">"
 	     << std::endl;
       }
+
+    if (_autoTuneEvents)
+      ++_trialCellEvents;
   }
 
   void 
@@ -242,6 +268,31 @@ namespace dynamo {
     dout << "Neighbourlist contains " << partCellData.size() 
 	 << " particle entries"
 	 << std::endl;
+
+    if (_autoTuneEvents)
+      {
+	//The first trial is of the loaded settings
+	_tuneParameter = 0;
+	_tuneValue = 0;
+	_bestOverlink = overlink;
+	_bestOversize = _oversizeCells;
+	_bestLambda = lambda;
+	_bestCost = HUGE_VAL;
+	_tuneWarmedUp = false;
+	startTrial();
+
+	dout << "Auto-tuning the cells, timing each trial for " << _autoTuneEvents << " events" << std::endl;
+
+	//The trials are advanced by a System event, so they depend on
+	//the global event count and not on the cell events
+	const std::string sysName = "CellsAutoTune" + globName;
+	bool found = false;
+	for (const shared_ptr<System>& sys : Sim->systems)
+	  found |= (sys->getName() == sysName);
+
+	if (!found)
+	  Sim->systems.push_back(shared_ptr<System>(new SysCellsAutoTune(Sim, ID, _autoTuneEvents, sysName)));
+      }
   }
 
   void
@@ -251,15 +302,154 @@ namespace dynamo {
       
     dout << "Reinitialising on collision " << Sim->eventCount << std::endl;
 
+    regrid();
+
+    if (isUsedInScheduler)
+      Sim->ptrScheduler->initialise();
+  }
+
+  void
+  GCells::regrid()
+  {
     //Create the cells
     addCells((_maxInteractionRange 
 	      * (1.0 + 10 * std::numeric_limits<double>::epsilon()))
 	     * _oversizeCells / overlink);
 
     _sigReInitialise();
+  }
+
+  void
+  GCells::startTrial()
+  {
+    _trialStartEvent = Sim->eventCount;
+    clock_gettime(CLOCK_MONOTONIC, &_trialStartTime);
+    _trialCellEvents = 0;
+    _trialNeighbours = 0;
+  }
+
+  bool
+  GCells::isDegenerateGrid(size_t trialOverlink, double trialOversize) const
+  {
+    const double maxdiam = (_maxInteractionRange * (1.0 + 10 * std::numeric_limits<double>::epsilon()))
+      * trialOversize / trialOverlink;
+
+    for (size_t iDim = 0; iDim < NDIM; iDim++)
+      if (getCellCount(iDim, maxdiam) <= 2 * trialOverlink + 1)
+	return true;
+
+    return false;
+  }
+
+  size_t
+  GCells::getCellCount(size_t iDim, double maxdiam) const
+  {
+    return int(Sim->primaryCellSize[iDim] 
+	       / (maxdiam * (1.0 + 10 * std::numeric_limits<double>::epsilon())));
+  }
+
+  bool
+  GCells::autoTune()
+  {
+    if (!_autoTuneEvents)
+      return false;
+
+    //Replica exchange swaps the event counts of the systems
+    if (Sim->eventCount < _trialStartEvent)
+      {
+	startTrial();
+	return true;
+      }
+
+    const size_t events = Sim->eventCount - _trialStartEvent;
+    if (events < _autoTuneEvents)
+      return true;
 
+    //The first events after loading the configuration are not
+    //representative, so they are not used as a trial
+    if (!_tuneWarmedUp)
+      {
+	_tuneWarmedUp = true;
+	startTrial();
+	return true;
+      }
+
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    const double cost = (double(now.tv_sec) - double(_trialStartTime.tv_sec)
+			 + 1e-9 * (double(now.tv_nsec) - double(_trialStartTime.tv_nsec))) / events;
+
+    dout << "Cell trial OverLink=" << overlink << " Oversize=" << _oversizeCells << " Overlap=" << lambda
+	 << "\n Wall time per event " << cost
+	 << "\n Cell events per event " << double(_trialCellEvents) / events
+	 << "\n Neighbours tested per cell event " << double(_trialNeighbours) / std::max(_trialCellEvents, size_t(1))
+	 << std::endl;
+
+    const bool trialIsBest = cost < _bestCost;
+    if (trialIsBest)
+      {
+	_bestCost = cost;
+	_bestOverlink = overlink;
+	_bestOversize = _oversizeCells;
+	_bestLambda = lambda;
+      }
+
+    //Vary one setting of the fastest settings at a time, skipping
+    //the values which have already been timed
+    for (;;)
+      {
+	if (_tuneParameter == 3)
+	  {
+	    dout << "Auto-tuning complete, using OverLink=" << _bestOverlink << " Oversize=" << _bestOversize
+		 << " Overlap=" << _bestLambda << std::endl;
+	    _autoTuneEvents = 0;
+	    break;
+	  }
+
+	overlink = (_tuneParameter == 0) ? tuneOverlinks[_tuneValue] : _bestOverlink;
+	_oversizeCells = (_tuneParameter == 1) ? tuneOversizes[_tuneValue] : _bestOversize;
+	lambda = (_tuneParameter == 2) ? tuneOverlaps[_tuneValue] : _bestLambda;
+
+	if (++_tuneValue == tuneValueCounts[_tuneParameter])
+	  {
+	    _tuneValue = 0;
+	    ++_tuneParameter;
+	  }
+
+	if ((overlink == _bestOverlink) && (_oversizeCells == _bestOversize) && (lambda == _bestLambda))
+	  continue;
+
+	//If one neighbourhood of cells spans the system, every particle
+	//is a neighbour of every other in that dimension
+	if (isDegenerateGrid(overlink, _oversizeCells))
+	  {
+	    dout << "Skipping the degenerate cell trial OverLink=" << overlink << " Oversize=" << _oversizeCells << std::endl;
+	    continue;
+	  }
+
+	break;
+      }
+
+    if (!_autoTuneEvents)
+      {
+	overlink = _bestOverlink;
+	_oversizeCells = _bestOversize;
+	lambda = _bestLambda;
+
+	//The cells already use these settings
+	if (trialIsBest)
+	  return false;
+      }
+
+    //The events of the particles must be rebuilt for the new cells,
+    //but the configuration has already been checked.
+    regrid();
     if (isUsedInScheduler)
-      Sim->ptrScheduler->initialise();
+      Sim->ptrScheduler->rebuildList();
+
+    //The rebuild is not included in the timing of the trial
+    startTrial();
+    return _autoTuneEvents != 0;
   }
 
   void
@@ -271,8 +461,16 @@ namespace dynamo {
 	<< magnet::xml::attr("NeighbourhoodRange") 
 	<< _maxInteractionRange / Sim->units.unitLength();
     
-    if (overlink > 1)   XML << magnet::xml::attr("OverLink") << overlink;
-    if (_oversizeCells != 1.0) XML << magnet::xml::attr("Oversize") << _oversizeCells;
+    //If the cells are still being tuned, the fastest settings so
+    //far are written out
+    const size_t outOverlink = _autoTuneEvents ? _bestOverlink : overlink;
+    const double outOversize = _autoTuneEvents ? _bestOversize : _oversizeCells;
+    const double outLambda = _autoTuneEvents ? _bestLambda : lambda;
+
+    if (outOverlink > 1)   XML << magnet::xml::attr("OverLink") << outOverlink;
+    if (outOversize != 1.0) XML << magnet::xml::attr("Oversize") << outOversize;
+    if (outLambda != 0.9) XML << magnet::xml::attr("Overlap") << outLambda;
+    if (_autoTuneEvents) XML << magnet::xml::attr("AutoTune") << _autoTuneEvents;
     
     XML << range
 	<< magnet::xml::endtag("Global");
@@ -287,8 +485,7 @@ namespace dynamo {
 
     for (size_t iDim = 0; iDim < NDIM; iDim++)
       {
-	cellCount[iDim] = int(Sim->primaryCellSize[iDim] 
-			      / (maxdiam * (1.0 + 10 * std::numeric_limits<double>::epsilon())));
+	cellCount[iDim] = getCellCount(iDim, maxdiam);
       
 	if (cellCount[iDim] < 2 * overlink + 1)
 	  cellCount[iDim] = 2 * overlink + 1;
@@ -399,8 +596,8 @@ namespace dynamo {
     return retval;
   }
 
-  IDRangeList
-  GCells::getParticleNeighbours(const magnet::math::MortonNumber<3>& particle_cell_coords) const
+  void
+  GCells::getParticleNeighbours(const magnet::math::MortonNumber<3>& particle_cell_coords, std::vector<size_t>& retlist) const
   {
     if (verbose)
       {
@@ -414,10 +611,6 @@ namespace dynamo {
       zero_coords[iDim] = (particle_cell_coords[iDim].getRealValue() + cellCount[iDim] - overlink)
 	% cellCount[iDim];
     
-    IDRangeList retval;
-    //This initial reserve greatly speeds up the later inserts
-    retval.getContainer().reserve(32);
-
     magnet::math::MortonNumber<3> coords(zero_coords);
     for (size_t x(0); x < 2 * overlink + 1; ++x)
       {
@@ -430,24 +623,22 @@ namespace dynamo {
 		coords[2] = (zero_coords[2].getRealValue() + z) % cellCount[2];
 
 		const std::vector<size_t>&  nlist = list[coords.getMortonNum()];
-		retval.getContainer().insert(retval.getContainer().end(), nlist.begin(), nlist.end());
+		retlist.insert(retlist.end(), nlist.begin(), nlist.end());
 	      }
 	  }
       }
-
-    return retval;
   }
   
-  IDRangeList
-  GCells::getParticleNeighbours(const Particle& part) const
+  void
+  GCells::getParticleNeighbours(const Particle& part, std::vector<size_t>& retlist) const
   {
-    return getParticleNeighbours(partCellData[part.getID()]);
+    getParticleNeighbours(partCellData[part.getID()], retlist);
   }
 
-  IDRangeList
-  GCells::getParticleNeighbours(const Vector& vec) const
+  void
+  GCells::getParticleNeighbours(const Vector& vec, std::vector<size_t>& retlist) const
   {
-    return getParticleNeighbours(getCellID(vec));
+    getParticleNeighbours(getCellID(vec), retlist);
   }
 
   double 
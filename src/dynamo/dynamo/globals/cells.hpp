@@ -19,6 +19,7 @@
 #include <dynamo/globals/neighbourList.hpp>
 #include <dynamo/particle.hpp>
 #include <magnet/math/morton_number.hpp>
+#include <ctime>
 #include <unordered_map>
 #include <vector>
 
@@ -44,6 +45,19 @@ namespace dynamo {
     efficient however, the vector is much more cache friendly and can
     boost performance by 50% in cases where the cell has multiple
     particles inside of it.
+
+    The best size and overlap of the cells depends on the density
+    and dynamics of the system. If the AutoTune attribute is set,
+    after a warm-up of that many events, the simulation is timed for
+    that many events with each of a set of
+    trial values of the OverLink, Oversize and Overlap settings (one
+    setting is varied at a time, starting from the loaded settings),
+    and the cells are then rebuilt with the fastest combination. As
+    the trials are timed, the tuned settings (and so the trajectory)
+    are not reproducible between runs. The trials are advanced by a
+    SysCellsAutoTune System event, which GCells adds to the
+    Simulation. Trial grids where one neighbourhood of cells spans
+    the system are skipped.
    */
   class GCells: public GNeighbourList
   {
@@ -61,8 +75,8 @@ namespace dynamo {
 
     virtual void reinitialise();
 
-    virtual IDRangeList getParticleNeighbours(const Particle&) const;
-    virtual IDRangeList getParticleNeighbours(const Vector&) const;
+    virtual void getParticleNeighbours(const Particle&, std::vector<size_t>&) const;
+    virtual void getParticleNeighbours(const Vector&, std::vector<size_t>&) const;
     
     virtual void operator<<(const magnet::xml::Node&);
 
@@ -71,8 +85,17 @@ namespace dynamo {
 
     virtual double getMaxSupportedInteractionLength() const;
 
+    /*! \brief Called by SysCellsAutoTune while auto-tuning. Once
+        the current trial has run for enough events, the cells are
+        rebuilt with the next trial settings (or the fastest settings,
+        once all the trials are complete).
+
+      \return If the cells are still being tuned.
+     */
+    bool autoTune();
+
   protected:
-    IDRangeList getParticleNeighbours(const magnet::math::MortonNumber<3>&) const;
+    void getParticleNeighbours(const magnet::math::MortonNumber<3>&, std::vector<size_t>&) const;
 
     size_t cellCount[3];
     magnet::math::DilatedInteger<3> dilatedCellMax[3];
@@ -84,6 +107,27 @@ namespace dynamo {
     size_t NCells;
     size_t overlink;
 
+    /*! \brief The number of events each trial setting is timed for
+        while auto-tuning the cells, or zero if they are not tuned.
+     */
+    size_t _autoTuneEvents;
+    //! \brief The setting being tuned (OverLink, Oversize, then Overlap).
+    size_t _tuneParameter;
+    //! \brief The index of the trial value of the setting being tuned.
+    size_t _tuneValue;
+    //! \brief The settings of the fastest trial so far.
+    size_t _bestOverlink;
+    double _bestOversize;
+    double _bestLambda;
+    //! \brief The wall time per event of the fastest trial so far.
+    double _bestCost;
+    //! \brief If the untimed warm-up events have been run.
+    bool _tuneWarmedUp;
+    size_t _trialStartEvent;
+    timespec _trialStartTime;
+    mutable size_t _trialCellEvents;
+    mutable size_t _trialNeighbours;
+
     //! \brief The list of particles in each cell.
     mutable std::vector<std::vector<size_t> > list;
 
@@ -102,6 +146,20 @@ namespace dynamo {
 
     void addCells(double);
 
+    //! \brief Rebuilds the cells with the current settings.
+    void regrid();
+
+    //! \brief Starts timing a trial from the current event.
+    void startTrial();
+
+    /*! \brief Tests if a grid with the passed settings would be one
+        neighbourhood of cells wide (or less) in any dimension.
+     */
+    bool isDegenerateGrid(size_t, double) const;
+
+    //! \brief The number of cells of width maxdiam which fit in a dimension.
+    size_t getCellCount(size_t iDim, double maxdiam) const;
+
     inline Vector calcPosition(const magnet::math::MortonNumber<3>& coords,
 			       const Particle& part) const;
 
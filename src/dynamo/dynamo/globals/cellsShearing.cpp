@@ -23,6 +23,8 @@
 #include <dynamo/schedulers/scheduler.hpp>
 #include <dynamo/BC/LEBC.hpp>
 #include <magnet/xmlwriter.hpp>
+#include <algorithm>
+#include <cmath>
 
 namespace dynamo {
   GCellsShearing::GCellsShearing(dynamo::Simulation* nSim, 
@@ -50,11 +52,53 @@ namespace dynamo {
       derr << "You should not use the shearing neighbour list"
 	   << " in a system without Lees Edwards BC's" << std::endl;
 
-    if (overlink != 1) M_throw() << "Cannot shear with overlinking yet";
+    if (_autoTuneEvents) M_throw() << "Cannot auto-tune the shearing cells yet";
 
     reinitialise();
   }
 
+  void
+  GCellsShearing::reinitialise()
+  {
+    //Every neighbourhood across the y boundaries is built for the
+    //current boundary displacement
+    _LEWindowTime.assign(Sim->N, Sim->systemTime);
+    GCells::reinitialise();
+  }
+
+  double
+  GCellsShearing::getShearVelocity() const
+  {
+    std::shared_ptr<BCLeesEdwards> bc = std::dynamic_pointer_cast<BCLeesEdwards>(Sim->BCs);
+    if (!bc) return 0;
+    return bc->getShearRate() * Sim->primaryCellSize[1];
+  }
+
+  double
+  GCellsShearing::getLEStep() const
+  {
+    const double velocity = getShearVelocity();
+    if ((velocity == 0) || !useLEWindows()) return 0;
+    return (velocity > 0) ? cellLatticeWidth[0] : -cellLatticeWidth[0];
+  }
+
+  double
+  GCellsShearing::getLEDisplacement(const Particle& part) const
+  {
+    std::shared_ptr<BCLeesEdwards> bc = std::dynamic_pointer_cast<BCLeesEdwards>(Sim->BCs);
+    if (!bc) return 0;
+    return bc->getBoundaryDisplacement() 
+      + getShearVelocity() * (_LEWindowTime[part.getID()] - Sim->systemTime);
+  }
+
+  double
+  GCellsShearing::getLEShiftTime(const Particle& part) const
+  {
+    const double velocity = getShearVelocity();
+    if ((velocity == 0) || !useLEWindows()) return HUGE_VAL;
+    return _LEWindowTime[part.getID()] + cellLatticeWidth[0] / std::abs(velocity) - Sim->systemTime;
+  }
+
   GlobalEvent 
   GCellsShearing::getEvent(const Particle& part) const
   {
@@ -63,15 +107,28 @@ namespace dynamo {
       M_throw() << "Particle is not up to date";
 #endif
 
+    const magnet::math::MortonNumber<3> cellCoords(partCellData[part.getID()]);
+
     //We do not inherit GCells get Event as the calcPosition thing done
     //for infinite systems is breaking it for shearing for some reason.
-    return GlobalEvent(part,
-		       Sim->dynamics->
-		       getSquareCellCollision2
-		       (part, calcPosition(partCellData[part.getID()]), 
-			cellDimension)
-		       - Sim->dynamics->getParticleDelay(part),
-		       CELL, *this);
+    double dt = Sim->dynamics->getSquareCellCollision2(part, calcPosition(cellCoords), cellDimension)
+      - Sim->dynamics->getParticleDelay(part);
+
+    //Particles near the y boundaries also have an event when their
+    //neighbourhood across the boundary must be rebuilt
+    if (inLEBoundary(cellCoords))
+      dt = std::min(dt, getLEShiftTime(part));
+
+    return GlobalEvent(part, dt, CELL, *this);
+  }
+
+  void
+  GCellsShearing::signalLENeighbours(const Particle& part) const
+  {
+    _neighbourBuffer.clear();
+    getAdditionalLEParticleNeighbourhood(part, _neighbourBuffer);
+    for (const size_t& id2 : _neighbourBuffer)
+      _sigNewNeighbour(part, id2);
   }
 
   void 
@@ -83,6 +140,20 @@ namespace dynamo {
     magnet::math::MortonNumber<3> oldCellCoords(oldCell);
     Vector oldCellPosition(calcPosition(oldCellCoords));
 
+    if (inLEBoundary(oldCellCoords)
+	&& (getLEShiftTime(part) < Sim->dynamics->getSquareCellCollision2(part, oldCellPosition, cellDimension)))
+      {
+	//The boundary has slid a cell width since the neighbourhood
+	//across it was built, move the neighbourhood on a cell.
+	_LEWindowTime[part.getID()] += cellLatticeWidth[0] / std::abs(getShearVelocity());
+
+	Sim->ptrScheduler->popNextEvent();
+	signalLENeighbours(part);
+	Sim->ptrScheduler->pushEvent(part, getEvent(part));
+	Sim->ptrScheduler->sort(part);
+	return;
+      }
+
     //Determine the cell transition direction, its saved
     int cellDirectionInt(Sim->dynamics->
 			 getSquareCellCollision3(part, oldCellPosition, cellDimension));
@@ -130,54 +201,27 @@ namespace dynamo {
 	//Check the entire neighbourhood, could check just the new
 	//neighbours and the extra LE neighbourhood strip but its a lot
 	//of code
-	if (isUsedInScheduler)
-	  {
-	    for (const size_t& id2 : getParticleNeighbours(part))
-	      {
-		Sim->ptrScheduler->addInteractionEvent(part, id2);
-
-		_sigNewNeighbour(part, id2);
-	      }
-	  }
-      }
-    else if ((cellDirection == 1) &&
-	     (oldCellCoords[1] == ((cellDirectionInt < 0) ? 1 : (cellCount[1] - 2))))
-      {
-	//We're entering the boundary of the y direction
-	//Calculate the end cell, no boundary wrap check required
-	if (cellDirectionInt > 0)
-	  endCell[cellDirection] = (endCell[cellDirection].getRealValue() + 1) % cellCount[cellDirection];
-	else
-	  endCell[cellDirection] = (endCell[cellDirection].getRealValue() 
-				    + cellCount[cellDirection] - 1) % cellCount[cellDirection];
-
-	removeFromCell(part.getID());
-	addToCell(part.getID(), endCell.getMortonNum());
-      
-	//Get rid of the virtual event that is next, update is delayed till
-	//after all events are added
-	Sim->ptrScheduler->popNextEvent();
-      
-	//Check the extra LE neighbourhood strip
-	if (isUsedInScheduler)
-	  {
-	    for (const size_t& id2 : getAdditionalLEParticleNeighbourhood(part))
-	      {
-		Sim->ptrScheduler->addInteractionEvent(part, id2);
-		_sigNewNeighbour(part, id2);
-	      }
-	  }
+	_LEWindowTime[part.getID()] = Sim->systemTime;
+	_neighbourBuffer.clear();
+	getParticleNeighbours(part, _neighbourBuffer);
+	for (const size_t& id2 : _neighbourBuffer)
+	  _sigNewNeighbour(part, id2);
       }
     else
       {
-	//Here we follow the same procedure (except one more if statement) as the original cell list for new neighbours
+	//Here we follow the same procedure as the original cell list
+	//for new neighbours, except where the new neighbours are
+	//across a y boundary.
 	//The coordinates of the new center cell in the neighbourhood of the
 	//particle
 	magnet::math::MortonNumber<3> newNBCell(oldCell);
+	//The row of the new neighbours when moving in the y direction
+	long newRow;
 	if (cellDirectionInt > 0)
 	  {
 	    endCell[cellDirection] = (endCell[cellDirection].getRealValue() + 1) % cellCount[cellDirection];
 	    newNBCell[cellDirection] = (endCell[cellDirection].getRealValue() + overlink) % cellCount[cellDirection];
+	    newRow = long(endCell[1].getRealValue()) + overlink;
 	  }
 	else
 	  {
@@ -188,6 +232,7 @@ namespace dynamo {
 				      + cellCount[cellDirection] - 1) % cellCount[cellDirection];
 	    newNBCell[cellDirection] = (endCell[cellDirection].getRealValue() 
 					+ cellCount[cellDirection] - overlink) % cellCount[cellDirection];
+	    newRow = long(endCell[1].getRealValue()) - long(overlink);
 	  }
     
 	removeFromCell(part.getID());
@@ -197,49 +242,62 @@ namespace dynamo {
 	//pushed after all other events are added
 	Sim->ptrScheduler->popNextEvent();
 
+	//A particle entering the cells next to the y boundaries has its
+	//neighbourhood across the boundary built for the current
+	//boundary displacement
+	if (!inLEBoundary(oldCellCoords))
+	  _LEWindowTime[part.getID()] = Sim->systemTime;
 
-	if ((cellDirection == 2) &&
-	    ((oldCellCoords[1] == 0) || (oldCellCoords[1] == cellCount[1] -1)))
+	if ((cellDirection == 1) && ((newRow < 0) || (newRow >= long(cellCount[1]))))
 	  {
-	    //We're at the boundary moving in the z direction, we must
-	    //add the new LE strips as neighbours	
-	    //We just check the entire Extra LE neighbourhood
-	    for (const size_t& id2 : getAdditionalLEParticleNeighbourhood(part))
+	    //The new neighbours are a row across the y boundary
+	    _neighbourBuffer.clear();
+	    getLERowNeighbourhood(endCell, newRow, getLEDisplacement(part), getLEStep(), _neighbourBuffer);
+	    for (const size_t& id2 : _neighbourBuffer)
 	      _sigNewNeighbour(part, id2);
 	  }
-
-	//Particle has just arrived into a new cell warn the scheduler about
-	//its new neighbours so it can add them to the heap
-	//Holds the displacement in each dimension, the unit is cells!
-
-	//These are the two dimensions to walk in
-	size_t dim1 = (cellDirection + 1) % 3,
-	  dim2 = (cellDirection + 2) % 3;
-
-	newNBCell[dim1] += cellCount[dim1] - overlink;
-	newNBCell[dim2] += cellCount[dim2] - overlink;
+	else
+	  {
+	    //The neighbourhood across the y boundaries moves with the
+	    //particle in the z direction, and in the x direction unless
+	    //it is made of whole rows
+	    if (((cellDirection == 2) || ((cellDirection == 0) && useLEWindows())) 
+		&& inLEBoundary(endCell))
+	      signalLENeighbours(part);
+
+	    //Particle has just arrived into a new cell warn the scheduler about
+	    //its new neighbours so it can add them to the heap
+	    //Holds the displacement in each dimension, the unit is cells!
+
+	    //These are the two dimensions to walk in
+	    size_t dim1 = (cellDirection + 1) % 3,
+	      dim2 = (cellDirection + 2) % 3;
+
+	    newNBCell[dim1] += cellCount[dim1] - overlink;
+	    newNBCell[dim2] += cellCount[dim2] - overlink;
   
-	size_t walkLength = 2 * overlink + 1;
+	    size_t walkLength = 2 * overlink + 1;
 
-	const magnet::math::DilatedInteger<3> saved_coord(newNBCell[dim1]);
+	    const magnet::math::DilatedInteger<3> saved_coord(newNBCell[dim1]);
 
-	//We now have the lowest cell coord, or corner of the cells to update
-	for (size_t iDim(0); iDim < walkLength; ++iDim)
-	  {
-	    newNBCell[dim2] %= cellCount[dim2];
-
-	    for (size_t jDim(0); jDim < walkLength; ++jDim)
+	    //We now have the lowest cell coord, or corner of the cells to update
+	    for (size_t iDim(0); iDim < walkLength; ++iDim)
 	      {
-		newNBCell[dim1] %= cellCount[dim1];
+		newNBCell[dim2] %= cellCount[dim2];
+
+		for (size_t jDim(0); jDim < walkLength; ++jDim)
+		  {
+		    newNBCell[dim1] %= cellCount[dim1];
   
-		for (const size_t& next : list[newNBCell.getMortonNum()])
-		  _sigNewNeighbour(part, next);
+		    for (const size_t& next : list[newNBCell.getMortonNum()])
+		      _sigNewNeighbour(part, next);
 	  
-		++newNBCell[dim1];
-	      }
+		    ++newNBCell[dim1];
+		  }
 
-	    newNBCell[dim1] = saved_coord; 
-	    ++newNBCell[dim2];
+		newNBCell[dim1] = saved_coord; 
+		++newNBCell[dim2];
+	      }
 	  }
       }
     
@@ -270,68 +328,123 @@ namespace dynamo {
 #endif
   }
 
-  IDRangeList
-  GCellsShearing::getParticleNeighbours(const Particle& part) const
+  void
+  GCellsShearing::getParticleNeighbours(const Particle& part, std::vector<size_t>& retlist) const
   {
-    return getParticleNeighbours(magnet::math::MortonNumber<3>(partCellData[part.getID()]));
+    getParticleNeighbours(magnet::math::MortonNumber<3>(partCellData[part.getID()]), 
+			  getLEDisplacement(part), getLEStep(), retlist);
   }
 
-  IDRangeList
-  GCellsShearing::getParticleNeighbours(const Vector& vec) const
+  void
+  GCellsShearing::getParticleNeighbours(const Vector& vec, std::vector<size_t>& retlist) const
   {
-    return getParticleNeighbours(magnet::math::MortonNumber<3>(getCellID(vec)));
+    std::shared_ptr<BCLeesEdwards> bc = std::dynamic_pointer_cast<BCLeesEdwards>(Sim->BCs);
+    getParticleNeighbours(getCellID(vec), bc ? bc->getBoundaryDisplacement() : 0, 0, retlist);
   }
 
-  IDRangeList
-  GCellsShearing::getParticleNeighbours(const magnet::math::MortonNumber<3>& cellCoords) const
+  void
+  GCellsShearing::getParticleNeighbours(const magnet::math::MortonNumber<3>& cellCoords, double dxd, double ddxd,
+					std::vector<size_t>& retlist) const
   {
-    IDRangeList retval(GCells::getParticleNeighbours(cellCoords));
-
-    if ((cellCoords[1] == 0) || (cellCoords[1] == dilatedCellMax[1]))
+    magnet::math::MortonNumber<3> coords(cellCoords);
+    for (long y(-long(overlink)); y <= long(overlink); ++y)
       {
-	const std::vector<size_t>& extra(getAdditionalLEParticleNeighbourhood(cellCoords));
-	retval.getContainer().insert(retval.getContainer().end(), extra.begin(), extra.end());
+	const long row = long(cellCoords[1].getRealValue()) + y;
+	if ((row < 0) || (row >= long(cellCount[1])))
+	  {
+	    getLERowNeighbourhood(cellCoords, row, dxd, ddxd, retlist);
+	    continue;
+	  }
+
+	coords[1] = row;
+	for (size_t x(0); x < 2 * overlink + 1; ++x)
+	  {
+	    coords[0] = (cellCoords[0].getRealValue() + cellCount[0] - overlink + x) % cellCount[0];
+	    for (size_t z(0); z < 2 * overlink + 1; ++z)
+	      {
+		coords[2] = (cellCoords[2].getRealValue() + cellCount[2] - overlink + z) % cellCount[2];
+		const std::vector<size_t>& nlist = list[coords.getMortonNum()];
+		retlist.insert(retlist.end(), nlist.begin(), nlist.end());
+	      }
+	  }
       }
-    return retval;
   }
   
-  std::vector<size_t>
-  GCellsShearing::getAdditionalLEParticleNeighbourhood(const Particle& part) const
+  void
+  GCellsShearing::getAdditionalLEParticleNeighbourhood(const Particle& part, std::vector<size_t>& retlist) const
   {
-    return getAdditionalLEParticleNeighbourhood(magnet::math::MortonNumber<3>(partCellData[part.getID()]));
+    getAdditionalLEParticleNeighbourhood(magnet::math::MortonNumber<3>(partCellData[part.getID()]), 
+					 getLEDisplacement(part), getLEStep(), retlist);
   }
 
-  std::vector<size_t>
-  GCellsShearing::getAdditionalLEParticleNeighbourhood(magnet::math::MortonNumber<3> cellCoords) const
+  void
+  GCellsShearing::getAdditionalLEParticleNeighbourhood(const magnet::math::MortonNumber<3>& cellCoords, double dxd, double ddxd,
+						       std::vector<size_t>& retlist) const
   {  
+    for (long y(-long(overlink)); y <= long(overlink); ++y)
+      {
+	const long row = long(cellCoords[1].getRealValue()) + y;
+	if ((row < 0) || (row >= long(cellCount[1])))
+	  getLERowNeighbourhood(cellCoords, row, dxd, ddxd, retlist);
+      }
+  }
+
+  void
+  GCellsShearing::getLERowNeighbourhood(const magnet::math::MortonNumber<3>& cellCoords, long row, double dxd, double ddxd,
+					std::vector<size_t>& retlist) const
+  {
 #ifdef DYNAMO_DEBUG
-    if ((cellCoords[1] != 0) && (cellCoords[1] != dilatedCellMax[1]))
-      M_throw() << "Shouldn't call this function unless the particle is at a border in the y dimension";
+    if ((row >= 0) && (row < long(cellCount[1])))
+      M_throw() << "Shouldn't call this function unless the row is across a y boundary";
 #endif 
 
-    //Move to the bottom of x
-    cellCoords[0] = 0;
-    //Get the correct y-side (its the opposite to the particles current side)
-    cellCoords[1] = (cellCoords[1] > 0) ? 0 : dilatedCellMax[1];  
-    ////Move te overlink across
-    cellCoords[2] = (cellCoords[2].getRealValue() + cellCount[2] - overlink) % cellCount[2];
+    //The image above the primary image is displaced by +dxd in x,
+    //and the image below by -dxd. A particle can be anywhere within
+    //the (overlapping) dimensions of its cell, so the cells within
+    //reach are those whose x separation, in units of the lattice
+    //width, is within (cellDimension + interaction range) of the
+    //displaced image, for any displacement in the range covered.
+    const double reach = getLEReach();
+    const double lo = std::min(dxd, dxd + ddxd) / cellLatticeWidth[0];
+    const double hi = std::max(dxd, dxd + ddxd) / cellLatticeWidth[0];
+
+    long first, last;
+    if (row >= long(cellCount[1]))
+      {
+	first = long(std::floor(-reach - hi)) + 1;
+	last = long(std::ceil(reach - lo)) - 1;
+      }
+    else
+      {
+	first = long(std::floor(-reach + lo)) + 1;
+	last = long(std::ceil(reach + hi)) - 1;
+      }
 
-    std::vector<size_t> retval;
-    retval.reserve(32);
-    for (size_t i(0); i < 2 * overlink + 1; ++i)
+    const long nx = cellCount[0];
+    first += cellCoords[0].getRealValue();
+    last += cellCoords[0].getRealValue();
+
+    //If the window spans the system, just visit the whole row once
+    if (!useLEWindows() || (last - first + 1 >= nx))
       {
-	cellCoords[2] %= cellCount[2];
+	first = 0;
+	last = nx - 1;
+      }
 
-	for (size_t j(0); j < cellCount[0]; ++j)
-	  {
-	    const std::vector<size_t>& nbs(list[cellCoords.getMortonNum()]);
-	    retval.insert(retval.end(), nbs.begin(), nbs.end());
+    magnet::math::MortonNumber<3> coords(cellCoords);
+    coords[1] = (row + long(cellCount[1])) % long(cellCount[1]);
 
-	    ++cellCoords[0];
+    const long nz = cellCount[2];
+    for (long z(long(cellCoords[2].getRealValue()) - long(overlink)); 
+	 z <= long(cellCoords[2].getRealValue() + overlink); ++z)
+      {
+	coords[2] = ((z % nz) + nz) % nz;
+	for (long x(first); x <= last; ++x)
+	  {
+	    coords[0] = ((x % nx) + nx) % nx;
+	    const std::vector<size_t>& nlist = list[coords.getMortonNum()];
+	    retlist.insert(retlist.end(), nlist.begin(), nlist.end());
 	  }
-	++cellCoords[2];
-	cellCoords[0] = 0;
       }
-    return retval;
   }
 }
@@ -18,8 +18,24 @@
 #pragma once
 #include <dynamo/globals/cells.hpp>
 #include <dynamo/ranges/IDRange.hpp>
+#include <cmath>
 
 namespace dynamo {
+  /*! \brief A cell neighbour list for systems with Lees-Edwards
+    boundary conditions.
+
+    The images of the system above and below the primary image slide
+    in the x direction, so the cells which neighbour a cell across
+    the y boundary change as the system is sheared. For each particle
+    within overlink cells of a y boundary, the neighbour list stores
+    when its neighbourhood across the boundary was built, and only
+    includes the cells across the boundary which may come within
+    range before the boundary slides another cell width. An extra
+    virtual event is scheduled for these particles when the boundary
+    has slid this far, which adds the next cells to their
+    neighbourhood. In narrow systems, whole rows of cells are used
+    instead.
+   */
   class GCellsShearing: public GCells
   {
   public:
@@ -30,17 +46,95 @@ namespace dynamo {
     virtual ~GCellsShearing() {}
 
     virtual void initialise(size_t);
+
+    virtual void reinitialise();
   
     virtual GlobalEvent getEvent(const Particle &) const;
 
     virtual void runEvent(Particle&, const double) const;
 
-    virtual IDRangeList getParticleNeighbours(const Particle&) const;
-    virtual IDRangeList getParticleNeighbours(const Vector&) const;
+    virtual void getParticleNeighbours(const Particle&, std::vector<size_t>&) const;
+    virtual void getParticleNeighbours(const Vector&, std::vector<size_t>&) const;
 
   protected:
-    IDRangeList getParticleNeighbours(const magnet::math::MortonNumber<3>&) const;
-    std::vector<size_t> getAdditionalLEParticleNeighbourhood(const Particle&) const;
-    std::vector<size_t> getAdditionalLEParticleNeighbourhood(magnet::math::MortonNumber<3>) const;
+    /*! \brief Appends the particles in the neighbourhood of a cell,
+        where the cells across the y boundaries are those which
+        neighbour it while the boundary displacement is in the range
+        [dxd, dxd+ddxd] (or [dxd+ddxd, dxd] if ddxd is negative).
+     */
+    void getParticleNeighbours(const magnet::math::MortonNumber<3>&, double dxd, double ddxd,
+			       std::vector<size_t>&) const;
+
+    //! \brief Appends the particles across the y boundaries which neighbour the particle.
+    void getAdditionalLEParticleNeighbourhood(const Particle&, std::vector<size_t>&) const;
+
+    /*! \brief Appends the particles across the y boundaries which
+        neighbour a cell.
+
+	\sa getParticleNeighbours(const magnet::math::MortonNumber<3>&, double, double, std::vector<size_t>&)
+     */
+    void getAdditionalLEParticleNeighbourhood(const magnet::math::MortonNumber<3>&, double dxd, double ddxd,
+					      std::vector<size_t>&) const;
+
+    /*! \brief Appends the particles in the cells of a single row
+        across the y boundaries (row < 0 or row >= cellCount[1]) which
+        neighbour a cell.
+     */
+    void getLERowNeighbourhood(const magnet::math::MortonNumber<3>&, long row, double dxd, double ddxd,
+			       std::vector<size_t>&) const;
+
+    //! \brief Test if a cell has neighbouring cells across the y boundaries.
+    inline bool inLEBoundary(const magnet::math::MortonNumber<3>& coords) const
+    { 
+      return (coords[1].getRealValue() < overlink) 
+	|| (coords[1].getRealValue() + overlink >= cellCount[1]);
+    }
+
+    /*! \brief How far, in cell widths, the image of a cell across a
+        y boundary can be offset in x from the cell and still have
+        neighbouring particles.
+     */
+    inline double getLEReach() const
+    { return (cellDimension[0] + _maxInteractionRange) / cellLatticeWidth[0]; }
+
+    /*! \brief Test if the neighbourhoods across the y boundaries are
+        narrower than the system.
+
+	If the neighbourhood of a cell across the boundary would span
+	nearly the whole row, the whole row is used instead and the
+	neighbourhoods are never rebuilt as the boundary slides.
+     */
+    inline bool useLEWindows() const
+    { return std::ceil(2 * getLEReach()) + 2 < cellCount[0]; }
+
+    //! \brief The velocity of the image above the primary image, in the x direction.
+    double getShearVelocity() const;
+
+    /*! \brief How far the boundary slides before the neighbourhood of
+        a particle across the y boundaries is rebuilt.
+
+	This is one cell width in the direction of the shear (or zero
+	if the system is not sheared, or the neighbourhoods are whole
+	rows).
+     */
+    double getLEStep() const;
+
+    //! \brief The boundary displacement the neighbourhood of a particle was built for.
+    double getLEDisplacement(const Particle&) const;
+
+    //! \brief The time until the neighbourhood of a particle across the y boundaries is rebuilt.
+    double getLEShiftTime(const Particle&) const;
+
+    //! \brief Appends the particles in the neighbourhood across the y boundaries to the scheduler.
+    void signalLENeighbours(const Particle&) const;
+
+    //! \brief A reusable list for the neighbours visited in runEvent.
+    mutable std::vector<size_t> _neighbourBuffer;
+
+    /*! \brief The system time at which the boundary was at the
+        displacement the neighbourhood of each particle across the y
+        boundaries was built for.
+     */
+    mutable std::vector<double> _LEWindowTime;
   };
 }
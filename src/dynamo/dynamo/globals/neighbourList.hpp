@@ -18,7 +18,6 @@
 #pragma once
 #include <dynamo/globals/global.hpp>
 #include <dynamo/simulation.hpp>
-#include <dynamo/ranges/IDRangeList.hpp>
 #include <boost/function.hpp>
 #include <magnet/function/delegate.hpp>
 #include <magnet/math/vector.hpp>
@@ -47,8 +46,21 @@ namespace dynamo {
       lambda(0.9)
     {}
 
-    virtual IDRangeList getParticleNeighbours(const Particle&) const = 0;
-    virtual IDRangeList getParticleNeighbours(const Vector&) const = 0;
+    /*! \brief Appends the IDs of the particles in the neighbourhood
+      of a Particle to the passed list.
+      
+      The list is not cleared before the IDs are appended. As the
+      caller owns the list, it can be reused between calls and no
+      heap allocations are made once it has grown large enough.
+     */
+    virtual void getParticleNeighbours(const Particle&, std::vector<size_t>&) const = 0;
+
+    /*! \brief Appends the IDs of the particles in the neighbourhood
+      of a point to the passed list.
+      
+      \sa getParticleNeighbours(const Particle&, std::vector<size_t>&)
+     */
+    virtual void getParticleNeighbours(const Vector&, std::vector<size_t>&) const = 0;
 
     /*! \brief This returns the maximum interaction length this
       neighbourlist supports.
@@ -70,6 +82,38 @@ namespace dynamo {
     
     void markAsUsedInScheduler() { isUsedInScheduler = true; }
 
+    /*! \brief Searches the Globals of a Simulation for a neighbour
+      list which contains every particle and supports interactions
+      of at least the passed length.
+
+      A neighbour list only holds the particles in its range. If the
+      range leaves out some particles, a search through the list
+      will miss the pairs involving them, so such lists are not
+      returned.
+
+      \return The neighbour list, or NULL if there is none.
+     */
+    static const GNeighbourList* findCompleteList(const dynamo::Simulation* sim, const double length)
+    {
+      for (const shared_ptr<Global>& glob : sim->globals)
+	{
+	  const GNeighbourList* ptr = dynamic_cast<const GNeighbourList*>(glob.get());
+	  if (!ptr || !ptr->range || (ptr->getMaxSupportedInteractionLength() < length))
+	    continue;
+
+	  bool complete = true;
+	  for (const Particle& part : sim->particles)
+	    if (!ptr->range->isInRange(part))
+	      {
+		complete = false;
+		break;
+	      }
+
+	  if (complete) return ptr;
+	}
+      return NULL;
+    }
+
     void setCellOverlap(bool overlap) 
     {
       if (overlap)
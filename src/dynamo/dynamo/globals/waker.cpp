@@ -133,8 +133,9 @@ namespace dynamo {
     _neighbors = 0;
 
     //Add the interaction events
-    std::unique_ptr<IDRange> ids(Sim->ptrScheduler->getParticleNeighbours(part));
-    for (const size_t& id1 : *ids)
+    std::vector<size_t> ids;
+    Sim->ptrScheduler->getParticleNeighbours(part, ids);
+    for (const size_t& id1 : ids)
       nblistCallback(part, id1);
   
     ParticleEventData EDat(part, *Sim->species[part], iEvent.getType());
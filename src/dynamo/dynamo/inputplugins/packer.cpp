@@ -41,14 +41,45 @@
 #include <dynamo/systems/sleep.hpp>
 #include <magnet/math/matrix.hpp>
 #include <magnet/exception.hpp>
+#include <magnet/thread/threadpool.hpp>
 #include <boost/tokenizer.hpp>
 #include <cmath>
+#include <functional>
 #include <memory>
 
 namespace dynamo {
   typedef FELBoundedPQ<PELMinMax<3> > DefaultSorter;
 
   namespace {
+    /*! \brief A counter based random number generator.
+
+      The output is the SplitMix64 hash of a key and a counter, so any
+      number of independent streams can be generated in parallel
+      without sharing any state.
+     */
+    class CounterRNG
+    {
+    public:
+      typedef uint64_t result_type;
+
+      CounterRNG(uint64_t key): _key(key), _counter(0) {}
+
+      static constexpr result_type min() { return 0; }
+      static constexpr result_type max() { return UINT64_MAX; }
+
+      result_type operator()()
+      {
+	uint64_t z = _key + 0x9E3779B97F4A7C15ULL * ++_counter;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+      }
+
+    private:
+      uint64_t _key;
+      uint64_t _counter;
+    };
+
     struct speciesData 
     { 
       double diameter; 
@@ -63,7 +94,8 @@ namespace dynamo {
 
   IPPacker::IPPacker(po::variables_map& vm2, dynamo::Simulation* tmp):
     SimBase(tmp, "SysPacker"),
-    vm(vm2)
+    vm(vm2),
+    _velocitySeed(0)
   {}
 
   bool mySortPredictate(const Vector& v1, const Vector& v2)
@@ -117,6 +149,10 @@ namespace dynamo {
   void
   IPPacker::initialise()
   {
+    //Seed the velocity streams first, so they only depend on the
+    //random seed
+    _velocitySeed = (uint64_t(Sim->ranGenerator()) << 32) | uint64_t(Sim->ranGenerator());
+
     //Set the default dynamics
     Sim->dynamics = shared_ptr<Dynamics>(new DynNewtonian(Sim));
     //Set the default Boundary Conditions
@@ -203,7 +239,8 @@ namespace dynamo {
 	  unsigned long nParticles = 0;
 	  Sim->particles.reserve(latticeSites.size());
 	  for (const Vector & position : latticeSites)
-	    Sim->particles.push_back(Particle(position, getRandVelVec() * Sim->units.unitVelocity(), nParticles++));
+	    Sim->particles.push_back(Particle(position, Vector(0, 0, 0), nParticles++));
+	  setRandVelocities();
 
 	  if (vm.count("i2"))
 	    Sim->systems.push_back(shared_ptr<System>(new SysRescale(Sim, vm["i2"].as<size_t>(), "RescalerEvent")));
@@ -373,8 +410,9 @@ namespace dynamo {
 
 	  Sim->particles.reserve(latticeSites.size());
 	  for (const Vector & position : latticeSites)
-	    Sim->particles.push_back(Particle(position, getRandVelVec() * Sim->units.unitVelocity(),
+	    Sim->particles.push_back(Particle(position, Vector(0, 0, 0),
 						 nParticles++));
+	  setRandVelocities();
 	  break;
 	}
       case 2:
@@ -494,7 +532,8 @@ namespace dynamo {
 	  Sim->particles.reserve(latticeSites.size());
 	  for (const Vector & position : latticeSites)
 	    Sim->particles.push_back
-	    (Particle(position, getRandVelVec() * Sim->units.unitVelocity(), nParticles++));
+	    (Particle(position, Vector(0, 0, 0), nParticles++));
+	  setRandVelocities();
 	  break;
 	}
       case 3:
@@ -574,8 +613,9 @@ namespace dynamo {
 	  for (const Vector & position : latticeSites)
 	    Sim->particles.push_back
 	    (Particle(position / diamScale, 
-		      getRandVelVec() * Sim->units.unitVelocity(),
+		      Vector(0, 0, 0),
 		      nParticles++));
+	  setRandVelocities();
 	  break;
 	}
       case 4:
@@ -627,7 +667,8 @@ namespace dynamo {
 	  Sim->particles.reserve(latticeSites.size());
 	  for (const Vector & position : latticeSites)
 	    Sim->particles.push_back
-	    (Particle(position, getRandVelVec() * Sim->units.unitVelocity(), nParticles++));
+	    (Particle(position, Vector(0, 0, 0), nParticles++));
+	  setRandVelocities();
 
 	  //Insert a linear profile, zero momentum then add a vel gradient
 	  Sim->setCOMVelocity();
@@ -722,8 +763,9 @@ namespace dynamo {
 
 	  Sim->particles.reserve(latticeSites.size());
 	  for (const Vector & position : latticeSites)
-	    Sim->particles.push_back(Particle(position, getRandVelVec() * Sim->units.unitVelocity(),
+	    Sim->particles.push_back(Particle(position, Vector(0, 0, 0),
 						 nParticles++));
+	  setRandVelocities();
 	  break;
 	}
       case 6:
@@ -769,7 +811,8 @@ namespace dynamo {
 	  unsigned long nParticles = 0;
 	  Sim->particles.reserve(latticeSites.size());
 	  for (const Vector & position : latticeSites)
-	    Sim->particles.push_back(Particle(position, getRandVelVec() * Sim->units.unitVelocity(), nParticles++));
+	    Sim->particles.push_back(Particle(position, Vector(0, 0, 0), nParticles++));
+	  setRandVelocities();
 	  break;
 	}
       case 7:
@@ -853,8 +896,9 @@ namespace dynamo {
 
 	  Sim->particles.reserve(latticeSites.size());
 	  for (const Vector & position : latticeSites)
-	    Sim->particles.push_back(Particle(position, getRandVelVec() * Sim->units.unitVelocity(),
+	    Sim->particles.push_back(Particle(position, Vector(0, 0, 0),
 						 nParticles++));
+	  setRandVelocities();
 	  break;
 	}
       case 8:
@@ -920,7 +964,8 @@ namespace dynamo {
 	  unsigned long nParticles = 0;
 	  Sim->particles.reserve(latticeSites.size());
 	  for (const Vector & position : latticeSites)
-	    Sim->particles.push_back(Particle(position, getRandVelVec() * Sim->units.unitVelocity(), nParticles++));
+	    Sim->particles.push_back(Particle(position, Vector(0, 0, 0), nParticles++));
+	  setRandVelocities();
 	  break;
 	}
       case 9:
@@ -964,7 +1009,8 @@ namespace dynamo {
 	  unsigned long nParticles = 0;
 	  Sim->particles.reserve(latticeSites.size());
 	  for (const Vector & position : latticeSites)
-	    Sim->particles.push_back(Particle(position, getRandVelVec() * Sim->units.unitVelocity(), nParticles++));
+	    Sim->particles.push_back(Particle(position, Vector(0, 0, 0), nParticles++));
+	  setRandVelocities();
 	  Sim->dynamics->initOrientations();
 	  break;
 	}
@@ -1031,8 +1077,9 @@ namespace dynamo {
 	  Sim->particles.reserve(latticeSites.size());
 	  for (const Vector & position : latticeSites)
 	    Sim->particles.push_back
-	    (Particle(position, getRandVelVec() * Sim->units.unitVelocity(),
+	    (Particle(position, Vector(0, 0, 0),
 		      nParticles++));
+	  setRandVelocities();
 	  break;
 	}
       case 11:
@@ -1206,7 +1253,8 @@ namespace dynamo {
 	  unsigned long nParticles = 0;
 	  Sim->particles.reserve(latticeSites.size());
 	  for (const Vector & position : latticeSites)
-	    Sim->particles.push_back(Particle(position, getRandVelVec() * Sim->units.unitVelocity(), nParticles++));
+	    Sim->particles.push_back(Particle(position, Vector(0, 0, 0), nParticles++));
+	  setRandVelocities();
 	  break;
 	}
       case 13:
@@ -1234,7 +1282,8 @@ namespace dynamo {
 	  unsigned long nParticles = 0;
 	  Sim->particles.reserve(latticeSites.size());
 	  for (const Vector & position : latticeSites)
-	    Sim->particles.push_back(Particle(position, getRandVelVec() * Sim->units.unitVelocity(), nParticles++));
+	    Sim->particles.push_back(Particle(position, Vector(0, 0, 0), nParticles++));
+	  setRandVelocities();
 
 	  Sim->dynamics->initOrientations();
 	  break;
@@ -1323,7 +1372,8 @@ namespace dynamo {
 	  unsigned long nParticles = 0;
 	  Sim->particles.reserve(latticeSites.size());
 	  for (const Vector & position : latticeSites)
-	    Sim->particles.push_back(Particle(position, getRandVelVec() * Sim->units.unitVelocity(), nParticles++));
+	    Sim->particles.push_back(Particle(position, Vector(0, 0, 0), nParticles++));
+	  setRandVelocities();
 	  break;
 	}
       case 15:
@@ -1539,8 +1589,9 @@ namespace dynamo {
 	  unsigned long nParticles = 0;
 	  Sim->particles.reserve(latticeSites.size());
 	  for (const Vector & position : latticeSites)
-	    Sim->particles.push_back(Particle(position, getRandVelVec() * Sim->units.unitVelocity(),
+	    Sim->particles.push_back(Particle(position, Vector(0, 0, 0),
 						 nParticles++));
+	  setRandVelocities();
 	  break;
 	}
       case 17:
@@ -1684,7 +1735,8 @@ namespace dynamo {
 	  std::sort(latticeSites.begin(), latticeSites.end(), mySortPredictate);
 
 	  for (size_t i(0); i < maxPart; ++i)
-	    Sim->particles.push_back(Particle(latticeSites[i], getRandVelVec() * Sim->units.unitVelocity(), nParticles++));
+	    Sim->particles.push_back(Particle(latticeSites[i], Vector(0, 0, 0), nParticles++));
+	  setRandVelocities();
 
 	  bool strongPlate = false;
 	  if (vm.count("b1"))
@@ -1742,7 +1794,8 @@ namespace dynamo {
 	  unsigned long nParticles = 0;
 	  Sim->particles.reserve(latticeSites.size());
 	  for (const Vector & position : latticeSites)
-	    Sim->particles.push_back(Particle(position, getRandVelVec() * Sim->units.unitVelocity(), nParticles++));
+	    Sim->particles.push_back(Particle(position, Vector(0, 0, 0), nParticles++));
+	  setRandVelocities();
 	  break;
 	}
       case 21:
@@ -1802,8 +1855,9 @@ namespace dynamo {
 	  unsigned long nParticles = 0;
 	  Sim->particles.reserve(latticeSites.size());
 	  for (const Vector & position : latticeSites)
-	    Sim->particles.push_back(Particle(0.999 * position, getRandVelVec() * Sim->units.unitVelocity(),
+	    Sim->particles.push_back(Particle(0.999 * position, Vector(0, 0, 0),
 						 nParticles++));
+	  setRandVelocities();
 	  break;
 	}
       case 23:
@@ -1911,9 +1965,10 @@ namespace dynamo {
 
 	  for (const Vector & position : dynamicSites)
 	    {
-	      Vector vel = getRandVelVec() * Sim->units.unitVelocity();
+	      Vector vel = getRandVelVec(nParticles) * Sim->units.unitVelocity();
 	      if (vel[1] > 0) vel[1] = -vel[1];//So particles don't fly out of the hopper
-	      Sim->particles.push_back(Particle(position, vel, nParticles++));
+	      Sim->particles.push_back(Particle(position, vel, nParticles));
+	      ++nParticles;
 	    }
 	  break;
 	}
@@ -2468,7 +2523,8 @@ namespace dynamo {
 	  Sim->particles.reserve(latticeSites.size());
 	  for (const Vector & position : latticeSites)
 	    Sim->particles.push_back
-	    (Particle(position, getRandVelVec() * Sim->units.unitVelocity(), nParticles++));
+	    (Particle(position, Vector(0, 0, 0), nParticles++));
+	  setRandVelocities();
 	  break;
 	}
       case 25:
@@ -2678,9 +2734,10 @@ namespace dynamo {
 
 	  for (const Vector & position : dynamicSites)
 	    {
-	      Vector vel = 0.001 * getRandVelVec() * Sim->units.unitVelocity();
+	      Vector vel = 0.001 * getRandVelVec(nParticles) * Sim->units.unitVelocity();
 	      if (vel[1] > 0) vel[1] = -vel[1];//So particles don't fly out of the hopper
-	      Sim->particles.push_back(Particle(position, vel, nParticles++));
+	      Sim->particles.push_back(Particle(position, vel, nParticles));
+	      ++nParticles;
 	    }
 	  break;
 	}
@@ -2803,7 +2860,8 @@ namespace dynamo {
 	  Sim->particles.reserve(latticeSites.size());
 	  for (const Vector & position : latticeSites)
 	    Sim->particles.push_back
-	    (Particle(position, getRandVelVec() * Sim->units.unitVelocity(), nParticles++));
+	    (Particle(position, Vector(0, 0, 0), nParticles++));
+	  setRandVelocities();
 
 	  //Insert a linear profile, zero momentum then add a vel gradient
 	  Sim->setCOMVelocity();
@@ -2862,7 +2920,8 @@ namespace dynamo {
 	  size_t nParticles = 0;
 	  Sim->particles.reserve(latticeSites.size());
 	  for (const Vector& position : latticeSites)
-	    Sim->particles.push_back(Particle(position, getRandVelVec() * Sim->units.unitVelocity(), nParticles++));
+	    Sim->particles.push_back(Particle(position, Vector(0, 0, 0), nParticles++));
+	  setRandVelocities();
 
 	  Sim->dynamics->initOrientations();
 	  break;
@@ -2973,9 +3032,10 @@ namespace dynamo {
 
 	  for (const Vector & position : dynamicSites)
 	    {
-	      Vector vel = getRandVelVec() * Sim->units.unitVelocity();
+	      Vector vel = getRandVelVec(nParticles) * Sim->units.unitVelocity();
 	      if (vel[1] > 0) vel[1] = -vel[1];//So particles don't fly out of the hopper
-	      Sim->particles.push_back(Particle(position, vel, nParticles++));
+	      Sim->particles.push_back(Particle(position, vel, nParticles));
+	      ++nParticles;
 	    }
 
 	  if (et != 1.0)
@@ -3078,15 +3138,48 @@ namespace dynamo {
   }
 
   Vector
-  IPPacker::getRandVelVec()
+  IPPacker::getRandVelVec(size_t ID) const
   {
+    //Each particle's stream is keyed by its ID. The seed is hashed
+    //first so nearby seeds do not give overlapping streams.
+    CounterRNG seedHash(_velocitySeed);
+    CounterRNG RNG(seedHash() ^ (0xD1B54A32D192ED03ULL * (uint64_t(ID) + 1)));
+
     //See http://mathworld.wolfram.com/SpherePointPicking.html
     std::normal_distribution<> normal_dist(0.0, (1.0 / sqrt(double(NDIM))));
 
     Vector  tmpVec;
     for (size_t iDim = 0; iDim < NDIM; iDim++)
-      tmpVec[iDim] = normal_dist(Sim->ranGenerator);
+      tmpVec[iDim] = normal_dist(RNG);
 
     return tmpVec;
   }
+
+  void
+  IPPacker::setRandVelocityBlock(size_t begin, size_t end)
+  {
+    for (size_t ID(begin); ID < end; ++ID)
+      Sim->particles[ID].getVelocity() = getRandVelVec(ID) * Sim->units.unitVelocity();
+  }
+
+  void 
+  IPPacker::setRandVelocities()
+  {
+    const size_t N = Sim->particles.size();
+    const size_t threadCount = Sim->threads ? Sim->threads->getThreadCount() : 0;
+    if (!threadCount)
+      {
+	setRandVelocityBlock(0, N);
+	return;
+      }
+
+    //A few blocks per thread, to balance the load
+    const size_t blocks = 4 * threadCount;
+    std::vector<std::function<void()> > tasks;
+    for (size_t block(0); block < blocks; ++block)
+      tasks.push_back(std::bind(&IPPacker::setRandVelocityBlock, this,
+				(N * block) / blocks, (N * (block + 1)) / blocks));
+    Sim->threads->queueTasks(tasks);
+    Sim->threads->wait();
+  }
 }
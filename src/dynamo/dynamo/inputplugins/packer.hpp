@@ -20,6 +20,7 @@
 #include <magnet/math/vector.hpp>
 #include <boost/program_options.hpp>
 #include <array>
+#include <cstdint>
 
 using namespace std;
 using namespace boost;
@@ -40,10 +41,26 @@ namespace dynamo {
   protected:
     std::array<long, 3> getCells();
     Vector  getNormalisedCellDimensions();
-    Vector  getRandVelVec();
+    /*! \brief Returns a random velocity for a particle.
+
+      Each particle has its own stream of random numbers, derived from
+      its ID and a seed drawn from the Simulation's RNG, so the
+      velocities do not depend on the order they are generated in.
+     */
+    Vector  getRandVelVec(size_t ID) const;
+
+    /*! \brief Gives every particle a random velocity from
+        getRandVelVec(), using the Simulation's ThreadPool.
+     */
+    void setRandVelocities();
+
+    void setRandVelocityBlock(size_t begin, size_t end);
     UCell* standardPackingHelper(UCell*, bool forceRectangular = false);
 
     po::variables_map& vm;
+
+    //! \brief The seed of the velocity streams of the particles.
+    uint64_t _velocitySeed;
   };
 }
 
@@ -19,6 +19,8 @@
 #include <dynamo/particle.hpp>
 #include <dynamo/schedulers/scheduler.hpp>
 #include <dynamo/simulation.hpp>
+#include <dynamo/globals/neighbourList.hpp>
+#include <magnet/thread/threadpool.hpp>
 #include <magnet/xmlwriter.hpp>
 #include <magnet/xmlreader.hpp>
 
@@ -27,25 +29,66 @@ namespace dynamo {
   ICapture::initCaptureMap()
   {
     //If not loaded or invalidated
-    if (noXmlLoad)
-      {      
-	clear();
-
-	for (std::vector<Particle>::const_iterator iPtr1 = Sim->particles.begin();
-	     iPtr1 != Sim->particles.end(); iPtr1++)
-	  for (std::vector<Particle>::const_iterator iPtr2 = iPtr1+1;
-	       iPtr2 != Sim->particles.end(); iPtr2++)
-	    //Check this interaction is the correct interaction for the pair
-	    if (Sim->getInteraction(*iPtr1, *iPtr2).get() == static_cast<const Interaction*>(this))
-	      testAddToCaptureMap(*iPtr1, iPtr2->getID());
+    if (!noXmlLoad) return;
+
+    clearCaptureMap();
+
+    //Search for a neighbour list which can provide the candidate
+    //pairs, otherwise all pairs are tested.
+    const GNeighbourList* nblist = GNeighbourList::findCompleteList(Sim, maxIntDist());
+
+    //Each task tests a contiguous block of particles and stores the
+    //captured pairs separately, these are then merged serially.
+    const size_t nTasks = (Sim->threads && Sim->threads->getThreadCount() && parallelCaptureTest()) ? Sim->threads->getThreadCount() : 1;
+    std::vector<CaptureList> captures(nTasks);
+    
+    if (nTasks == 1)
+      findCaptures(0, Sim->N, nblist, captures[0]);
+    else
+      {
+	std::vector<std::function<void()> > tasks;
+	tasks.reserve(nTasks);
+	for (size_t i(0); i < nTasks; ++i)
+	  tasks.push_back(std::bind(&ICapture::findCaptures, this, (i * Sim->N) / nTasks, ((i + 1) * Sim->N) / nTasks, nblist, std::ref(captures[i])));
+	Sim->threads->queueTasks(tasks);
+	Sim->threads->wait();
       }
+
+    for (const CaptureList& list : captures)
+      for (const CaptureList::value_type& entry : list)
+	setCaptureState(entry.first, entry.second);
   }
 
   void 
-  ICapture::testAddToCaptureMap(const Particle& p1, const size_t& p2)
+  ICapture::findCaptures(const size_t begin, const size_t end, const GNeighbourList* nblist, CaptureList& captures) const
   {
-    size_t capval = captureTest(p1, Sim->particles[p2]);
-    if (capval) Map::operator[](Map::key_type(p1.getID(), p2)) = capval;
+    std::vector<size_t> neighbours;
+    for (size_t ID1(begin); ID1 < end; ++ID1)
+      {
+	const Particle& p1 = Sim->particles[ID1];
+
+	neighbours.clear();
+	if (nblist)
+	  nblist->getParticleNeighbours(p1, neighbours);
+	else
+	  for (size_t ID2(ID1 + 1); ID2 < Sim->N; ++ID2)
+	    neighbours.push_back(ID2);
+
+	//The cells may list a particle more than once in small
+	//systems, but setting a state twice is harmless
+	for (const size_t ID2 : neighbours)
+	  if (ID2 > ID1)
+	    {
+	      const Particle& p2 = Sim->particles[ID2];
+	      //Check this interaction is the correct interaction for the pair
+	      if (Sim->getInteraction(p1, p2).get() != static_cast<const Interaction*>(this))
+		continue;
+	      
+	      const size_t capval = captureTest(p1, p2);
+	      if (capval)
+		captures.push_back(CaptureList::value_type(Key(ID1, ID2), capval));
+	    }
+      }
   }
 
   void 
@@ -53,12 +96,30 @@ namespace dynamo {
   {
     if (XML.hasNode("CaptureMap"))
       {
-	noXmlLoad = false;
-	clear();
+	noXmlLoad = true;
+	clearCaptureMap();
 
-	for (magnet::xml::Node node = XML.getNode("CaptureMap").fastGetNode("Pair"); node.valid(); ++node)
-	  Map::operator[](Map::key_type(node.getAttribute("ID1").as<size_t>(), node.getAttribute("ID2").as<size_t>()))
-	    = node.getAttribute("val").as<size_t>();
+	const magnet::xml::Node mapXML = XML.getNode("CaptureMap");
+	if (mapXML.hasAttribute("Store"))
+	  {
+	    const std::string store = mapXML.getAttribute("Store");
+	    if (store == "Hash")
+	      setHashedStore(true);
+	    else if (store == "Map")
+	      setHashedStore(false);
+	    else
+	      M_throw() << "Unknown CaptureMap Store type \"" << store << "\" for the \"" << intName << "\" Interaction";
+	  }
+
+	//The Store may be set on an empty CaptureMap to select the
+	//container, so the map is only treated as loaded if it holds
+	//pairs. An empty map is rebuilt, which gives the same result.
+	for (magnet::xml::Node node = mapXML.fastGetNode("Pair"); node.valid(); ++node)
+	  {
+	    noXmlLoad = false;
+	    setCaptureState(Key(node.getAttribute("ID1").as<size_t>(), node.getAttribute("ID2").as<size_t>()),
+			    node.getAttribute("val").as<size_t>());
+	  }
       }
   }
 
@@ -67,7 +128,21 @@ namespace dynamo {
   {
     XML << magnet::xml::tag("CaptureMap");
 
-    for (const Map::value_type& IDs : *this)
+    if (_captures.isHashed())
+      XML << magnet::xml::attr("Store") << "Hash";
+
+    //The pairs are always written in order. The output is rare, so
+    //if there is no ordered view of the hashed store a temporary one
+    //is built.
+    detail::CaptureMap tmpMap;
+    const detail::CaptureMap* ordered = &tmpMap;
+    if (_captures.hasOrderedView())
+      ordered = &getCaptureMap();
+    else
+      for (const detail::CaptureHashMap::value_type& IDs : getCaptures())
+	tmpMap[IDs.first] = IDs.second;
+
+    for (const detail::CaptureMap::value_type& IDs : *ordered)
       XML << magnet::xml::tag("Pair")
 	  << magnet::xml::attr("ID1") << IDs.first.first
 	  << magnet::xml::attr("ID2") << IDs.first.second
@@ -81,7 +156,7 @@ namespace dynamo {
   ICapture::validateState(bool textoutput, size_t max_reports) const
   {
     size_t retval(0);
-    for (const Map::value_type& IDs : *this)
+    for (const detail::CaptureHashMap::value_type& IDs : getCaptures())
       {
 	const Particle& p1(Sim->particles[IDs.first.first]);
 	const Particle& p2(Sim->particles[IDs.first.second]);
@@ -21,8 +21,12 @@
 #include <dynamo/interactions/interaction.hpp>
 #include <magnet/exception.hpp>
 #include <map>
+#include <vector>
+#include <iterator>
 
 namespace dynamo {
+  class GNeighbourList;
+
   namespace detail {
     namespace {
       ::std::size_t
@@ -118,6 +122,289 @@ namespace dynamo {
       }
     };
 
+    /*!\brief An open-addressing hash table with the same "store
+       only if non-zero" semantics as CaptureMap.
+
+       The entries are held in a single flat array using linear
+       probing, so a lookup of a pair is (usually) a single cache
+       line access, rather than the walk through the nodes of the
+       tree of a CaptureMap. As zero states are never stored, a zero
+       value marks an empty slot. Deletions use backward shifting, so
+       no tombstones are left in the table.
+
+       The iteration order is arbitrary, use CaptureMap if an ordered
+       container is required.
+    */
+    class CaptureHashMap
+    {
+    public:
+      typedef std::pair<PairKey, size_t> value_type;
+      typedef std::vector<value_type> Container;
+
+      struct const_iterator
+      {
+	typedef std::forward_iterator_tag iterator_category;
+	typedef CaptureHashMap::value_type value_type;
+	typedef std::ptrdiff_t difference_type;
+	typedef const value_type* pointer;
+	typedef const value_type& reference;
+
+	const_iterator() {}
+
+	const_iterator(Container::const_iterator it, Container::const_iterator end):
+	  _it(it), _end(end)
+	{ skip(); }
+
+	const_iterator& operator++() { ++_it; skip(); return *this; }
+	reference operator*() const { return *_it; }
+	pointer operator->() const { return &(*_it); }
+	bool operator==(const const_iterator& o) const { return _it == o._it; }
+	bool operator!=(const const_iterator& o) const { return _it != o._it; }
+
+      private:
+	void skip() { while ((_it != _end) && (_it->second == 0)) ++_it; }
+
+	Container::const_iterator _it;
+	Container::const_iterator _end;
+      };
+
+      CaptureHashMap(): _size(0) {}
+
+      //! \brief Returns the stored state, or 0 if the pair is missing.
+      size_t operator[](const PairKey& key) const {
+	if (_data.empty()) return 0;
+	for (size_t i = slot(key); _data[i].second; i = (i + 1) & mask())
+	  if (_data[i].first == key)
+	    return _data[i].second;
+	return 0;
+      }
+
+      //! \brief Sets the state of a pair, removing it if val is 0.
+      void set(const PairKey& key, const size_t val) {
+	if (val == 0) { erase(key); return; }
+
+	if (2 * (_size + 1) > _data.size())
+	  rehash(std::max(_data.size() * 2, size_t(16)));
+
+	size_t i = slot(key);
+	for (; _data[i].second; i = (i + 1) & mask())
+	  if (_data[i].first == key)
+	    {
+	      _data[i].second = val;
+	      return;
+	    }
+
+	_data[i] = value_type(key, val);
+	++_size;
+      }
+
+      void erase(const PairKey& key) {
+	if (_data.empty()) return;
+
+	size_t i = slot(key);
+	for (; _data[i].second; i = (i + 1) & mask())
+	  if (_data[i].first == key)
+	    break;
+
+	if (!_data[i].second) return;
+	--_size;
+
+	//Shift back any following entries which can fill the hole
+	for (size_t j = (i + 1) & mask(); _data[j].second; j = (j + 1) & mask())
+	  {
+	    const size_t home = slot(_data[j].first);
+	    //Move the entry if its home slot is not in (i, j]
+	    if (((j - home) & mask()) >= ((j - i) & mask()))
+	      {
+		_data[i] = _data[j];
+		i = j;
+	      }
+	  }
+	_data[i].second = 0;
+      }
+
+      void clear() { _data.clear(); _size = 0; }
+
+      size_t size() const { return _size; }
+
+      const_iterator begin() const { return const_iterator(_data.begin(), _data.end()); }
+      const_iterator end() const { return const_iterator(_data.end(), _data.end()); }
+
+    private:
+      size_t mask() const { return _data.size() - 1; }
+
+      size_t slot(const PairKey& key) const {
+	//The IDs are mixed with a multiplicative hash, as the
+	//particle IDs are often sequential
+	size_t hash = hash_combine(key.first, key.second) * size_t(0x9E3779B97F4A7C15ull);
+	return (hash ^ (hash >> 29)) & mask();
+      }
+
+      void rehash(const size_t newsize) {
+	Container old(newsize, value_type(PairKey(), 0));
+	std::swap(old, _data);
+	_size = 0;
+	for (const value_type& entry : old)
+	  if (entry.second)
+	    set(entry.first, entry.second);
+      }
+
+      Container _data;
+      size_t _size;
+    };
+
+    /*! \brief A forward iterator over the pairs of either a
+        CaptureMap or a CaptureHashMap, in the order of the container.
+
+      The entries are returned by value, as the two containers store
+      different value types.
+     */
+    class CaptureIterator
+    {
+    public:
+      typedef std::forward_iterator_tag iterator_category;
+      typedef CaptureHashMap::value_type value_type;
+      typedef std::ptrdiff_t difference_type;
+      typedef const value_type* pointer;
+      typedef value_type reference;
+
+      CaptureIterator(CaptureMap::const_iterator it): _mapIt(it), _hashed(false) {}
+      CaptureIterator(CaptureHashMap::const_iterator it): _hashIt(it), _hashed(true) {}
+
+      CaptureIterator& operator++() {
+	if (_hashed) ++_hashIt; else ++_mapIt;
+	return *this; 
+      }
+
+      value_type operator*() const {
+	return _hashed ? *_hashIt : value_type(_mapIt->first, _mapIt->second); 
+      }
+
+      bool operator==(const CaptureIterator& o) const {
+	return _hashed ? (_hashIt == o._hashIt) : (_mapIt == o._mapIt); 
+      }
+
+      bool operator!=(const CaptureIterator& o) const { return !(*this == o); }
+
+    private:
+      CaptureMap::const_iterator _mapIt;
+      CaptureHashMap::const_iterator _hashIt;
+      bool _hashed;
+    };
+
+    //! \brief A range of CaptureIterator's, for use in range based for loops.
+    struct CaptureRange
+    {
+      CaptureRange(CaptureIterator begin, CaptureIterator end): _begin(begin), _end(end) {}
+      CaptureIterator begin() const { return _begin; }
+      CaptureIterator end() const { return _end; }
+      CaptureIterator _begin, _end;
+    };
+
+    /*! \brief The storage of the captured pairs of an ICapture
+        Interaction.
+
+      The pairs are either held in an ordered CaptureMap, or in a
+      CaptureHashMap which is faster to search when there are very
+      many captured pairs. An ordered view of the hashed store (as
+      needed to build a CaptureMapKey) is only kept if requested
+      through keepOrderedView(), it is then updated along with the
+      hashed store so it never has to be rebuilt.
+     */
+    class CaptureStore
+    {
+    public:
+      CaptureStore(): _hashed(false), _keepOrderedView(false) {}
+
+      //! \brief Returns the stored state of a pair, or 0 if it is missing.
+      size_t operator[](const PairKey& key) const {
+	return _hashed ? _hashMap[key] : _map[key];
+      }
+
+      //! \brief Sets the state of a pair, 0 removes the pair.
+      void set(const PairKey& key, const size_t val) {
+	if (_hashed)
+	  {
+	    _hashMap.set(key, val);
+	    if (_keepOrderedView)
+	      _orderedView[key] = val;
+	  }
+	else
+	  _map[key] = val;
+      }
+
+      void clear() {
+	_map.clear();
+	_hashMap.clear();
+	_orderedView.clear();
+      }
+
+      //! \brief The number of stored pairs.
+      size_t size() const { return _hashed ? _hashMap.size() : _map.size(); }
+
+      bool isHashed() const { return _hashed; }
+
+      //! \brief Moves the stored pairs to the selected container.
+      void setHashed(bool hashed) {
+	if (hashed == _hashed) return;
+
+	if (hashed)
+	  {
+	    for (const CaptureMap::value_type& IDs : _map)
+	      _hashMap.set(IDs.first, IDs.second);
+	    if (_keepOrderedView)
+	      std::swap(_map, _orderedView);
+	    _map.clear();
+	  }
+	else
+	  {
+	    _map.insert(_hashMap.begin(), _hashMap.end());
+	    _hashMap.clear();
+	    _orderedView.clear();
+	  }
+
+	_hashed = hashed;
+      }
+
+      /*! \brief Requests that getOrdered() is available in either
+	  store.
+       */
+      void keepOrderedView() {
+	if (_keepOrderedView) return;
+	_keepOrderedView = true;
+	if (_hashed)
+	  _orderedView.insert(_hashMap.begin(), _hashMap.end());
+      }
+
+      bool hasOrderedView() const { return !_hashed || _keepOrderedView; }
+
+      /*! \brief Returns the pairs as an ordered CaptureMap.
+	
+	This is only available for the hashed store if
+	keepOrderedView() has been called.
+       */
+      const CaptureMap& getOrdered() const {
+	if (!_hashed) return _map;
+	if (!_keepOrderedView)
+	  M_throw() << "The ordered view of a hashed CaptureStore was requested, but keepOrderedView() was not called";
+	return _orderedView;
+      }
+
+      //! \brief Iterates over the pairs in the order of the store.
+      CaptureRange getPairs() const {
+	if (_hashed)
+	  return CaptureRange(CaptureIterator(_hashMap.begin()), CaptureIterator(_hashMap.end()));
+	return CaptureRange(CaptureIterator(_map.begin()), CaptureIterator(_map.end()));
+      }
+
+    private:
+      bool _hashed;
+      bool _keepOrderedView;
+      CaptureMap _map;
+      CaptureHashMap _hashMap;
+      CaptureMap _orderedView;
+    };
+
     struct CaptureMapKey: public std::vector<CaptureMap::value_type>
     {
       typedef std::vector<CaptureMap::value_type> Container;
@@ -150,32 +437,93 @@ namespace dynamo {
     \ref ISquareWell), or it might be used to track if the particles
     are within each others bounding sphere (e.g., \ref ILines).
   */
-  class ICapture: public Interaction, public detail::CaptureMap
+  class ICapture: public Interaction
   {
-    typedef detail::CaptureMap Map;
+    typedef detail::PairKey Key;
 
   public:
     ICapture(dynamo::Simulation* sim, IDPairRange* range): Interaction(sim, range), noXmlLoad(true) {}
 
     //! \brief A test if two particles are captured
     size_t isCaptured(const Particle& p1, const Particle& p2) const {
-      return Map::operator[](Map::key_type(p1, p2));
+      return isCaptured(Key(p1, p2));
     }
 
     //! \brief A test if two particles are captured
     size_t isCaptured(const size_t p1, const size_t p2) const {
-      return Map::operator[](Map::key_type(p1, p2));
+      return isCaptured(Key(p1, p2));
     }
 
+    //! \brief Returns the stored state of a pair, or 0 if not captured.
+    size_t isCaptured(const Key& key) const {
+      return _captures[key];
+    }
+
+    //! \brief The number of captured pairs.
+    size_t getCapturedCount() const {
+      return _captures.size();
+    }
+
+    /*! \brief Returns the captured pairs as an ordered CaptureMap.
+
+      If the hashed store is in use, keepOrderedView() must have been
+      called first (e.g., in the initialise() of the caller).
+     */
+    const detail::CaptureMap& getCaptureMap() const { return _captures.getOrdered(); }
+
+    /*! \brief Requests that getCaptureMap() is available even if the
+        hashed store is in use.
+
+      The ordered view is then updated along with the hashed store,
+      which costs a tree insertion or deletion on every change of
+      state.
+     */
+    void keepOrderedView() { _captures.keepOrderedView(); }
+
+    /*! \brief Iterates over the captured pairs, in no particular
+        order.
+
+      Unlike getCaptureMap(), this never requires an ordered copy of
+      the hashed store.
+     */
+    detail::CaptureRange getCaptures() const { return _captures.getPairs(); }
+
+    /*! \brief Selects the container used to store the captured pairs.
+      
+      The default detail::CaptureMap is an ordered tree. The
+      detail::CaptureHashMap is a flat hash table which is faster to
+      search when there are very many captured pairs (e.g., large
+      square-well polymer melts). It is selected in the XML using
+      the attribute \code <CaptureMap Store="Hash"/> \endcode
+      If the CaptureMap holds no Pair's, the map is built from the
+      particle positions when the Simulation is initialised.
+     */
+    void setHashedStore(bool hashed) { _captures.setHashed(hashed); }
+
     /*! \brief This function tells an uninitialised capture map to
         forget the data loaded from the xml file.
      */
     void forgetXMLCaptureMap() { noXmlLoad = true; }
 
+    /*! \brief Builds the capture map from the particle positions,
+        unless one was loaded from the xml file.
+
+      This is called by Simulation::initialise() after the Global's
+      are initialised, so that the candidate pairs can be taken from
+      a neighbour list, and the tests are split across
+      Simulation::threads if available.
+     */
     void initCaptureMap();
 
     virtual size_t captureTest(const Particle&, const Particle&) const = 0;
 
+    /*! \brief If captureTest() may be called on several threads at
+        once.
+
+      initCaptureMap() tests the pairs serially if this is false.
+     */
+    virtual bool parallelCaptureTest() const { return true; }
+
   protected:  
     bool noXmlLoad;
 
@@ -185,25 +533,46 @@ namespace dynamo {
 
     virtual size_t validateState(bool textoutput = true, size_t max_reports = std::numeric_limits<size_t>::max()) const;
 
-    virtual void testAddToCaptureMap(const Particle& p1, const size_t& p2);
+    typedef std::vector<std::pair<Key, size_t> > CaptureList;
+
+    /*! \brief Appends the captured pairs (ID1 < ID2) of the particles
+      with ID's in [begin, end) to the passed list.
+
+      If a neighbour list is passed, only its neighbours are tested,
+      otherwise all particle pairs are tested. This is thread safe
+      so it may be run in parallel across blocks of particles.
+     */
+    void findCaptures(const size_t begin, const size_t end, const GNeighbourList* nblist, CaptureList& captures) const;
+
+    //! \brief Set the state of a pair of particles, 0 removes the pair.
+    void setCaptureState(const Key& key, const size_t val) {
+      _captures.set(key, val);
+    }
+
+    void clearCaptureMap() {
+      _captures.clear();
+    }
 
     //! \brief Add a pair of particles to the capture map.
     void add(const Particle& p1, const Particle& p2) {
 #ifdef DYNAMO_DEBUG
-      if (Map::find(Map::key_type(p1.getID(), p2.getID())) != Map::end())
+      if (isCaptured(p1, p2))
 	M_throw() << "Adding a particle while its already added!";
 #endif
-      Map::operator[](Map::key_type(p1.getID(), p2.getID())) = 1;
+      setCaptureState(Key(p1.getID(), p2.getID()), 1);
     }
   
     //! \brief Remove a pair of particles to the capture map.
     void remove(const Particle& p1, const Particle& p2)
     {
 #ifdef DYNAMO_DEBUG
-      if (Map::find(Map::key_type(p1.getID(), p2.getID())) == Map::end())
+      if (!isCaptured(p1, p2))
 	M_throw() << "Deleting a particle while its already gone!";
 #endif
-      Map::operator[](Map::key_type(p1.getID(), p2.getID())) = 0;
+      setCaptureState(Key(p1.getID(), p2.getID()), 0);
     } 
+
+  private:
+    detail::CaptureStore _captures;
   };
 }
@@ -43,7 +43,6 @@ namespace dynamo {
   IDumbbells::initialise(size_t nID)
   {
     ID = nID; 
-    ICapture::initCaptureMap();
   }
 
   std::array<double, 4> IDumbbells::getGlyphSize(size_t ID) const
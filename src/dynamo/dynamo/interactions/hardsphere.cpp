@@ -26,15 +26,20 @@
 #include <dynamo/schedulers/scheduler.hpp>
 #include <dynamo/NparticleEventData.hpp>
 #include <dynamo/dynamics/compression.hpp>
+#include <dynamo/BC/PBC.hpp>
+#include <dynamo/BC/None.hpp>
+#include <magnet/intersection/ray_sphere.hpp>
 #include <dynamo/outputplugins/outputplugin.hpp>
 #include <magnet/xmlwriter.hpp>
 #include <magnet/xmlreader.hpp>
 #include <cmath>
 #include <iomanip>
+#include <typeinfo>
 
 namespace dynamo {
   IHardSphere::IHardSphere(const magnet::xml::Node& XML, dynamo::Simulation* tmp):
-    Interaction(tmp, NULL)
+    Interaction(tmp, NULL),
+    _kernel(NULL)
   { operator<<(XML); }
 
   void 
@@ -45,6 +50,54 @@ namespace dynamo {
     _post_event_overlap = 0;
     _accum_overlap_magnitude = 0;
     _overlapped_tests = 0;
+    selectKernel();
+  }
+
+  void
+  IHardSphere::selectKernel()
+  {
+    _kernel = NULL;
+    _kernelDynamics = Sim->dynamics.get();
+    _kernelBCs = Sim->BCs.get();
+
+    if (!dynamic_cast<const NumericProperty*>(_diameter.get())
+	|| (typeid(*Sim->dynamics) != typeid(DynNewtonian)))
+      return;
+
+    if (typeid(*Sim->BCs) == typeid(BCPeriodic))
+      _kernel = &IHardSphere::getMonodisperseEvent<true>;
+    else if (typeid(*Sim->BCs) == typeid(BCNone))
+      _kernel = &IHardSphere::getMonodisperseEvent<false>;
+
+    if (_kernel)
+      dout << "Using the monodisperse kernel for the \"" << intName << "\" Interaction" << std::endl;
+  }
+
+  template<bool Periodic>
+  IntEvent
+  IHardSphere::getMonodisperseEvent(const Particle& p1, const Particle& p2) const
+  {
+    //A qualified call, as the property may be rescaled after
+    //initialisation. (d + d) * 0.5 == d, so this matches the generic
+    //path exactly.
+    const double d = static_cast<const NumericProperty&>(*_diameter).NumericProperty::getProperty(0);
+
+    //As in DynNewtonian::SphereSphereInRoot. Neither BC modifies the
+    //relative velocity, so r12 is also the separation used by
+    //DynNewtonian::sphereOverlap.
+    Vector r12 = p1.getPosition() - p2.getPosition();
+    const Vector v12 = p1.getVelocity() - p2.getVelocity();
+    if (Periodic)
+      static_cast<const BCPeriodic&>(*Sim->BCs).minimumImage(r12);
+
+    const double dt = magnet::intersection::ray_sphere(r12, v12, d);
+
+    if (std::max(d - std::sqrt(r12 | r12), 0.0)) ++_overlapped_tests;
+
+    if (dt != HUGE_VAL)
+      return IntEvent(p1, p2, dt, CORE, *this);
+  
+    return IntEvent(p1, p2, HUGE_VAL, NONE, *this);
   }
 
   void 
@@ -71,7 +124,7 @@ namespace dynamo {
 	<< magnet::xml::attr("AvgPostEventOverlapMagnitude") << _accum_overlap_magnitude / (_post_event_overlap *  Sim->units.unitLength())
 	<< magnet::xml::attr("Events") << _complete_events
 	<< magnet::xml::attr("OverlapFreq") << double(_post_event_overlap) / double(_complete_events)
-	<< magnet::xml::attr("OverlappedTests") << _overlapped_tests
+	<< magnet::xml::attr("OverlappedTests") << _overlapped_tests.load()
 	<< magnet::xml::endtag("Interaction");
   }
 
@@ -106,6 +159,19 @@ namespace dynamo {
       M_throw() << "You shouldn't pass p1==p2 events to the interactions!";
 #endif 
 
+    if (_kernel && (Sim->dynamics.get() == _kernelDynamics) && (Sim->BCs.get() == _kernelBCs))
+      {
+	const IntEvent event = (this->*_kernel)(p1, p2);
+#ifdef DYNAMO_DEBUG
+	//The kernel is only run once, so the overlap counter is not
+	//incremented twice. SphereSphereInRoot does not count overlaps.
+	const double d = _diameter->getProperty(p1.getID());
+	if (event.getdt() != Sim->dynamics->SphereSphereInRoot(p1, p2, d))
+	  M_throw() << "The monodisperse kernel event time does not match the generic path: ID1=" << p1.getID() << ", ID2=" << p2.getID();
+#endif
+	return event;
+      }
+
     double d = (_diameter->getProperty(p1.getID())
 		 + _diameter->getProperty(p2.getID())) * 0.5;
 
@@ -20,6 +20,7 @@
 #include <dynamo/interactions/interaction.hpp>
 #include <dynamo/simulation.hpp>
 #include <dynamo/interactions/glyphrepresentation.hpp>
+#include <atomic>
 
 namespace dynamo {
   class IHardSphere: public GlyphRepresentation, public Interaction
@@ -28,13 +29,15 @@ namespace dynamo {
     template<class T1>
     IHardSphere(dynamo::Simulation* tmp, T1 d, IDPairRange* nR, std::string name):
       Interaction(tmp, nR),
-      _diameter(Sim->_properties.getProperty(d, Property::Units::Length()))
+      _diameter(Sim->_properties.getProperty(d, Property::Units::Length())),
+      _kernel(NULL)
     { intName = name; }
 
     template<class T1>
     IHardSphere(dynamo::Simulation* tmp, T1 d, double e, IDPairRange* nR, std::string name):
       Interaction(tmp, nR),
-      _diameter(Sim->_properties.getProperty(d, Property::Units::Length()))
+      _diameter(Sim->_properties.getProperty(d, Property::Units::Length())),
+      _kernel(NULL)
     { 
       intName = name; 
       if (e!=1) _e = Sim->_properties.getProperty(e, Property::Units::Dimensionless());
@@ -44,7 +47,8 @@ namespace dynamo {
     IHardSphere(dynamo::Simulation* tmp, T1 d, T2 e, IDPairRange* nR, std::string name):
       Interaction(tmp, nR),
       _diameter(Sim->_properties.getProperty(d, Property::Units::Length())),
-      _e(Sim->_properties.getProperty(e, Property::Units::Dimensionless()))
+      _e(Sim->_properties.getProperty(e, Property::Units::Dimensionless())),
+      _kernel(NULL)
     { intName = name; }
 
     template<class T1, class T2, class T3>
@@ -52,7 +56,8 @@ namespace dynamo {
       Interaction(tmp, nR),
       _diameter(Sim->_properties.getProperty(d, Property::Units::Length())),
       _e(Sim->_properties.getProperty(e, Property::Units::Dimensionless())),
-      _et(Sim->_properties.getProperty(et, Property::Units::Dimensionless()))
+      _et(Sim->_properties.getProperty(et, Property::Units::Dimensionless())),
+      _kernel(NULL)
     { intName = name; }
 
     IHardSphere(const magnet::xml::Node&, dynamo::Simulation*);
@@ -87,6 +92,41 @@ namespace dynamo {
     mutable size_t _complete_events;
     mutable size_t _post_event_overlap;
     mutable double _accum_overlap_magnitude;
-    mutable size_t _overlapped_tests;
+    //! \brief Counted in getEvent, which may run in parallel (see Scheduler::rebuildList).
+    mutable std::atomic<size_t> _overlapped_tests;
+
+    /*! \brief Selects a specialised getEvent() kernel for the
+      common case of monodisperse spheres with Newtonian dynamics.
+
+      The kernel is only used if the diameter is a NumericProperty,
+      the Dynamics is exactly a DynNewtonian and the
+      BoundaryCondition is exactly a BCPeriodic or BCNone. Any other
+      combination uses the generic, virtual dispatch path.
+     */
+    void selectKernel();
+
+    /*! \brief The getEvent() kernel for monodisperse spheres with
+      Newtonian dynamics.
+
+      This performs the same floating point operations as the generic
+      path, so the event times are identical, but the Dynamics, BC
+      and diameter lookups are resolved at compile time.
+
+      \tparam Periodic If the BC is a BCPeriodic (otherwise BCNone).
+     */
+    template<bool Periodic>
+    IntEvent getMonodisperseEvent(const Particle&, const Particle&) const;
+
+    //! \brief The selected getEvent() kernel, or NULL for the generic path.
+    IntEvent (IHardSphere::*_kernel)(const Particle&, const Particle&) const;
+    /*! \brief The Dynamics and BoundaryCondition the kernel was
+      selected for.
+
+      The Dynamics and BC may be replaced after initialisation (e.g.,
+      during compression), the kernel is only used while both are
+      unchanged.
+     */
+    const Dynamics* _kernelDynamics;
+    const BoundaryCondition* _kernelBCs;
   };
 }
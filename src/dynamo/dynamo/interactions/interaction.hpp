@@ -73,6 +73,15 @@ namespace dynamo {
      */
     virtual void runEvent(Particle&, Particle&, const IntEvent&) = 0;
 
+    /*! \brief Prepare for getEvent() and validateState(p1, p2,
+        false) to be called on several threads at once.
+
+	This is called serially before each parallel pass of the
+	Scheduler. Interactions which calculate data lazily as it is
+	needed must calculate all the data these calls may use here.
+    */
+    virtual void prepareParallelTests() {}
+
     /*! \brief Return the maximum distance at which two particles may interact using this Interaction.
     
       This value is used in GNeighbourList's to make sure a certain
@@ -42,7 +42,6 @@ namespace dynamo {
   ILines::initialise(size_t nID)
   {
     ID = nID; 
-    ICapture::initCaptureMap();
   }
 
   std::array<double, 4> ILines::getGlyphSize(size_t ID) const
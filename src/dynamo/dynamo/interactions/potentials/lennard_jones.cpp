@@ -77,6 +77,7 @@ namespace dynamo {
     _sigma(sigma), _epsilon(epsilon), _cutoff(cutoff), _kT(kT), _attractiveSteps(attractivesteps), _U_mode(umode), _R_mode(rmode)
   {
     _r_cache.push_back(_cutoff);
+    _steps = calculateSteps();
   }
   
   void 
@@ -116,10 +117,12 @@ namespace dynamo {
     else if (!rmode_string.compare("DeltaV")) _R_mode = DELTAV;
     else
       M_throw() << "Unknown LennardJones RMode (" << rmode_string << ") at " << XML.getPath();
+
+    _steps = calculateSteps();
   }
 
   std::size_t 
-  PotentialLennardJones::steps() const {
+  PotentialLennardJones::calculateSteps() const {
     switch (_R_mode) {
     case DELTAR:
       {
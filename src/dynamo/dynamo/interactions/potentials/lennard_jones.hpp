@@ -50,7 +50,7 @@ namespace dynamo {
       operator<<(XML);
     }
       
-    virtual std::size_t steps() const;
+    virtual std::size_t steps() const { return _steps; }
 
     virtual void operator<<(const magnet::xml::Node&);
   
@@ -78,6 +78,9 @@ namespace dynamo {
 
     double B2func(double) const;
 
+    //! \brief Calculates the number of steps from the parameters.
+    std::size_t calculateSteps() const;
+
     double _sigma;
     double _epsilon;
     double _cutoff;
@@ -93,5 +96,8 @@ namespace dynamo {
     UMode _U_mode;
     //! \brief The active step position algorithm.
     RMode _R_mode;
+
+    //! \brief The number of steps, which is constant once loaded.
+    std::size_t _steps;
   };
 }
@@ -18,6 +18,9 @@
 #pragma once
 #include <vector>
 #include <cmath>
+#include <algorithm>
+#include <functional>
+#include <limits>
 #include <dynamo/base.hpp>
 
 namespace magnet { namespace xml { class Node; class XmlStream; } }
@@ -41,7 +44,8 @@ namespace dynamo {
 
     This class also implements a cache, to allow fast lookup of previously
     accessed steps, as some calculated potentials are expensive to
-    compute.
+    compute. The steps are stored in flat arrays which are sorted by
+    step ID, so the step of a separation is found by a binary search.
    */
   class Potential {
   public:    
@@ -54,7 +58,7 @@ namespace dynamo {
 	new steps and adds them to the cache until the requested step
 	ID is located.
      */
-    virtual value_type operator[](const std::size_t step_id) const {
+    value_type operator[](const std::size_t step_id) const {
 #ifdef DYNAMO_DEBUG
       if (step_id >= steps()) M_throw() << "Out of range access";
 #endif 
@@ -85,6 +89,31 @@ namespace dynamo {
       return std::min(_r_cache.size(), _u_cache.size());
     }
 
+    /*! \brief Calculate and cache every step of the potential, so
+        later lookups never have to calculate new steps.
+
+	Potentials with an unbounded number of steps (e.g., a
+	Lennard-Jones potential stepped in energy) are still
+	calculated as they are accessed.
+    */
+    void cacheAllSteps() const {
+      const size_t nsteps = steps();
+      if ((nsteps != std::numeric_limits<size_t>::max()) && (cached_steps() < nsteps))
+	calculateToStep(nsteps - 1);
+    }
+
+    /*! \brief Calculate and cache every step up to and including
+        step_id (or the last step), so later lookups of these steps
+        never have to calculate new steps.
+     */
+    void cacheToStep(size_t step_id) const {
+      const size_t nsteps = steps();
+      if (!nsteps) return;
+      step_id = std::min(step_id, nsteps - 1);
+      if (step_id >= cached_steps())
+	calculateToStep(step_id);
+    }
+
     static shared_ptr<Potential> getClass(const magnet::xml::Node&);
 
     /*! \brief Loads the Potential from an XML node in a
@@ -101,12 +130,24 @@ namespace dynamo {
         corresponds to.
     */
     size_t calculateStepID(const double r) const {
-      size_t retval(0);
-      if (direction())
-	for (; (retval < steps()) && (r > operator[](retval).first); ++retval) {}
-      else
-	for (; (retval < steps()) && (r < operator[](retval).first); ++retval) {}
-      return retval;
+      const size_t nsteps = steps();
+      for (;;)
+	{
+	  //The step is the first discontinuity which r has not
+	  //passed (in the direction of increasing step ID).
+	  const size_t cached = std::min(cached_steps(), nsteps);
+	  const double* const begin = _r_cache.data();
+	  const double* const end = begin + cached;
+	  const double* const it = direction()
+	    ? std::lower_bound(begin, end, r)
+	    : std::lower_bound(begin, end, r, std::greater<double>());
+	  
+	  if ((it != end) || (cached == nsteps))
+	    return it - begin;
+
+	  //r is beyond the cached steps, calculate the next step
+	  calculateToStep(cached);
+	}
     }
 
     /*! \brief Return a pair with the min-max bounds of the potential
@@ -81,7 +81,30 @@ namespace dynamo {
   IStepped::initialise(size_t nID)
   {
     ID = nID;
-    ICapture::initCaptureMap();
+    _accessedSteps = _potential->cached_steps();
+    //Calculate the steps now, so the event lookups are only binary
+    //searches of the cached steps
+    _potential->cacheAllSteps();
+  }
+
+  bool
+  IStepped::parallelCaptureTest() const
+  {
+    //Every step of a bounded potential was cached in initialise(),
+    //otherwise the test may add steps to the cache
+    return _potential->steps() != std::numeric_limits<size_t>::max();
+  }
+
+  void
+  IStepped::prepareParallelTests()
+  {
+    //getEvent() and the parallel validateState() only look up the
+    //bounds of the stored step of a pair, so caching the deepest
+    //captured step is enough to stop them extending the cache
+    size_t maxStep = 0;
+    for (const detail::CaptureHashMap::value_type& IDs : getCaptures())
+      maxStep = std::max(maxStep, IDs.second);
+    _potential->cacheToStep(maxStep);
   }
 
   size_t 
@@ -101,7 +124,7 @@ namespace dynamo {
   IStepped::getInternalEnergy() const 
   { 
     double Energy = 0.0;
-    for (const ICapture::value_type& IDs : *this)
+    for (const detail::CaptureHashMap::value_type& IDs : getCaptures())
       Energy += getInternalEnergy(Sim->particles[IDs.first.first], Sim->particles[IDs.first.second]);
     return Energy; 
   }
@@ -109,10 +132,10 @@ namespace dynamo {
   double 
   IStepped::getInternalEnergy(const Particle& p1, const Particle& p2) const
   {
-    ICapture::const_iterator capstat = ICapture::find(ICapture::key_type(p1, p2));
-    if (capstat == ICapture::end()) return 0;
+    const size_t step_ID = isCaptured(p1, p2);
+    if (!step_ID) return 0;
     const double energy_scale = 0.5 * (_energyScale->getProperty(p1.getID()) + _energyScale->getProperty(p2.getID()));
-    return (*_potential)[capstat->second - 1].second * energy_scale;
+    return (*_potential)[step_ID - 1].second * energy_scale;
   }
 
   IntEvent
@@ -130,8 +153,7 @@ namespace dynamo {
       M_throw() << "You shouldn't pass p1==p2 events to the interactions!";
 #endif 
 
-    ICapture::const_iterator capstat = ICapture::find(ICapture::key_type(p1, p2));
-    const size_t current_step_ID = (capstat == ICapture::end()) ? 0 : capstat->second;
+    const size_t current_step_ID = isCaptured(p1, p2);
     const std::pair<double, double> step_bounds = _potential->getStepBounds(current_step_ID);
     const double length_scale = 0.5 * (_lengthScale->getProperty(p1.getID()) + _lengthScale->getProperty(p2.getID()));
 
@@ -161,8 +183,7 @@ namespace dynamo {
     const double length_scale = 0.5 * (_lengthScale->getProperty(p1.getID()) + _lengthScale->getProperty(p2.getID()));
     const double energy_scale = 0.5 * (_energyScale->getProperty(p1.getID()) + _energyScale->getProperty(p2.getID()));
 
-    ICapture::const_iterator capstat = ICapture::find(ICapture::key_type(p1, p2));
-    const size_t old_step_ID = (capstat == ICapture::end()) ? 0 : capstat->second;
+    const size_t old_step_ID = isCaptured(p1, p2);
     const std::pair<double, double> step_bounds = _potential->getStepBounds(old_step_ID);
 
     size_t new_step_ID;
@@ -193,7 +214,8 @@ namespace dynamo {
     ++data.counter;
     data.rdotv_sum += retVal.rvdot;
     //Check if the particles changed their step ID
-    if (retVal.getType() != BOUNCE) ICapture::operator[](ICapture::key_type(p1, p2)) = new_step_ID;
+    if (retVal.getType() != BOUNCE) setCaptureState(detail::PairKey(p1, p2), new_step_ID);
+    _accessedSteps = std::max(_accessedSteps, std::max(old_step_ID, new_step_ID) + 1);
     (*Sim->_sigParticleUpdate)(retVal);
     Sim->ptrScheduler->fullUpdate(p1, p2);
     for (shared_ptr<OutputPlugin> & Ptr : Sim->outputPlugins)
@@ -203,8 +225,26 @@ namespace dynamo {
   bool
   IStepped::validateState(const Particle& p1, const Particle& p2, bool textoutput) const
   {
-    ICapture::const_iterator capstat = ICapture::find(ICapture::key_type(p1, p2));
-    const size_t stored_step_ID = (capstat == ICapture::end()) ? 0 : capstat->second;
+    const size_t stored_step_ID = isCaptured(p1, p2);
+
+    if (!textoutput)
+      {
+	//Only test if the pair is within the bounds of its stored
+	//step. Unlike captureTest(), this never calculates new steps,
+	//so it is safe to run in parallel. The bounds are compared
+	//as Potential::calculateStepID() does.
+	const double length_scale = 0.5 * (_lengthScale->getProperty(p1.getID()) + _lengthScale->getProperty(p2.getID()));
+	Vector rij = p1.getPosition() - p2.getPosition();
+	Sim->BCs->applyBC(rij);
+	const double r = rij.nrm() / length_scale;
+	
+	const std::pair<double, double> bounds = _potential->getStepBounds(stored_step_ID);
+	if (_potential->direction())
+	  return !(((bounds.first < r) || (stored_step_ID == 0)) && (r <= bounds.second));
+	else
+	  return !((bounds.first <= r) && (r < bounds.second));
+      }
+
     const size_t calculated_step_ID = captureTest(p1, p2);
     const std::pair<double, double> stored_step_bounds = _potential->getStepBounds(stored_step_ID);
     const std::pair<double, double> calculated_step_bounds = _potential->getStepBounds(calculated_step_ID);
@@ -253,7 +293,15 @@ namespace dynamo {
 	<< attr("MaxDiameter") << _potential->max_distance()
       ;
     
-    for (size_t i(0); i < _potential->cached_steps(); ++i)
+    //Every step is cached in initialise(), so only output the steps
+    //that were calculated before or that a pair has reached (with
+    //the inner bound of the deepest one)
+    size_t accessedSteps = _accessedSteps;
+    for (const detail::CaptureHashMap::value_type& IDs : getCaptures())
+      accessedSteps = std::max(accessedSteps, IDs.second + 1);
+    accessedSteps = std::min(accessedSteps, _potential->cached_steps());
+
+    for (size_t i(0); i < accessedSteps; ++i)
       {
 	double deltaU = (*_potential)[i].second;
 	if (i > 0)
@@ -50,6 +50,10 @@ namespace dynamo {
 
     virtual size_t captureTest(const Particle&, const Particle&) const;
 
+    virtual bool parallelCaptureTest() const;
+
+    virtual void prepareParallelTests();
+
     virtual void initialise(size_t);
 
     virtual IntEvent getEvent(const Particle&, const Particle&) const;
@@ -80,5 +84,10 @@ namespace dynamo {
       double rdotv_sum;
     };
     std::map<std::pair<size_t, EEventType>, EdgeData> _edgedata;
+
+    //!The number of steps calculated before initialise() cached them
+    //!all, or reached by a pair since, which limits the AccessedSteps
+    //!output
+    size_t _accessedSteps;
   };
 }
@@ -142,7 +142,7 @@ namespace dynamo {
   { 
     //Once the capture maps are loaded just iterate through that determining energies
     double Energy = 0.0;
-    for (const ICapture::value_type& IDs : *this)
+    for (const detail::CaptureHashMap::value_type& IDs : getCaptures())
       Energy += getInternalEnergy(Sim->particles[IDs.first.first], Sim->particles[IDs.first.second]);
     return Energy;
   }
@@ -172,7 +172,6 @@ namespace dynamo {
   ISWSequence::initialise(size_t nID)
   {
     ID = nID;
-    ICapture::initCaptureMap();
   }
 
   size_t
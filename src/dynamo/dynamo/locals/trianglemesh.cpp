@@ -23,13 +23,139 @@
 #include <dynamo/units/units.hpp>
 #include <dynamo/schedulers/scheduler.hpp>
 #include <dynamo/outputplugins/outputplugin.hpp>
-
+#include <dynamo/dynamics/newtonian.hpp>
+#include <dynamo/BC/None.hpp>
+#include <magnet/intersection/ray_AABB.hpp>
+#include <algorithm>
+#include <array>
+#include <typeinfo>
 
 namespace dynamo {
   LTriangleMesh::LTriangleMesh(const magnet::xml::Node& XML, dynamo::Simulation* tmp):
-    Local(tmp, "LocalWall")
+    Local(tmp, "LocalWall"),
+    _bvhDynamics(NULL),
+    _bvhBCs(NULL)
   { operator<<(XML); }
 
+  namespace {
+    //! Orders triangle IDs by the coordinate of their centroid along an axis
+    struct CentroidLess
+    {
+      CentroidLess(const std::vector<Vector>& centroids, size_t axis):
+	_centroids(centroids), _axis(axis) {}
+
+      bool operator()(size_t a, size_t b) const
+      { return _centroids[a][_axis] < _centroids[b][_axis]; }
+
+      const std::vector<Vector>& _centroids;
+      size_t _axis;
+    };
+  }
+
+  void
+  LTriangleMesh::initialise(size_t nID)
+  {
+    Local::initialise(nID);
+
+    buildBVH();
+
+    _bvhDynamics = NULL;
+    _bvhBCs = NULL;
+    if ((typeid(*Sim->dynamics) == typeid(DynNewtonian))
+	&& (typeid(*Sim->BCs) == typeid(BCNone)))
+      {
+	_bvhDynamics = Sim->dynamics.get();
+	_bvhBCs = Sim->BCs.get();
+	dout << "Using a BVH of " << _bvh.size() << " nodes for the "
+	     << _elements.size() << " triangles of \"" << localName << "\"" << std::endl;
+      }
+  }
+
+  void
+  LTriangleMesh::buildBVH()
+  {
+    _bvh.clear();
+    _bvhTriangles.clear();
+    if (_elements.empty()) return;
+
+    std::vector<Vector> centroids;
+    centroids.reserve(_elements.size());
+    for (const TriangleElements& elem : _elements)
+      centroids.push_back((_vertices[std::get<0>(elem)] + _vertices[std::get<1>(elem)] 
+			   + _vertices[std::get<2>(elem)]) / 3.0);
+
+    _bvhTriangles.resize(_elements.size());
+    for (size_t id(0); id < _elements.size(); ++id)
+      _bvhTriangles[id] = id;
+
+    //Each split halves the triangles, so this is never exceeded
+    _bvh.reserve(2 * _elements.size());
+    _bvh.push_back(BVHNode());
+    buildBVHNode(0, 0, _elements.size(), centroids);
+
+    //The entry times of the bounds must never be later than the
+    //event times of the triangles inside them, so the bounds are
+    //padded well beyond the round-off of either calculation.
+    const BVHNode& root = _bvh.front();
+    double scale = (root.max - root.min).nrm();
+    for (size_t n(0); n < NDIM; ++n)
+      scale = std::max(scale, std::max(std::abs(root.min[n]), std::abs(root.max[n])));
+    _bvhPadding = 1e-8 * scale;
+  }
+
+  void
+  LTriangleMesh::buildBVHNode(size_t node, size_t begin, size_t end, const std::vector<Vector>& centroids)
+  {
+    //The maximum number of triangles in a leaf
+    const size_t leafSize = 4;
+
+    Vector min(HUGE_VAL, HUGE_VAL, HUGE_VAL), max(-HUGE_VAL, -HUGE_VAL, -HUGE_VAL);
+    Vector cmin(min), cmax(max);
+    for (size_t i(begin); i < end; ++i)
+      {
+	const TriangleElements& elem = _elements[_bvhTriangles[i]];
+	for (const size_t vertex : {std::get<0>(elem), std::get<1>(elem), std::get<2>(elem)})
+	  for (size_t n(0); n < NDIM; ++n)
+	    {
+	      min[n] = std::min(min[n], _vertices[vertex][n]);
+	      max[n] = std::max(max[n], _vertices[vertex][n]);
+	    }
+
+	for (size_t n(0); n < NDIM; ++n)
+	  {
+	    cmin[n] = std::min(cmin[n], centroids[_bvhTriangles[i]][n]);
+	    cmax[n] = std::max(cmax[n], centroids[_bvhTriangles[i]][n]);
+	  }
+      }
+
+    _bvh[node].min = min;
+    _bvh[node].max = max;
+
+    //Split along the longest axis of the centroids
+    size_t axis = 0;
+    for (size_t n(1); n < NDIM; ++n)
+      if ((cmax[n] - cmin[n]) > (cmax[axis] - cmin[axis]))
+	axis = n;
+
+    if (((end - begin) <= leafSize) || (cmax[axis] == cmin[axis]))
+      {
+	_bvh[node].first = begin;
+	_bvh[node].count = end - begin;
+	return;
+      }
+
+    const size_t mid = begin + (end - begin) / 2;
+    std::nth_element(_bvhTriangles.begin() + begin, _bvhTriangles.begin() + mid,
+		     _bvhTriangles.begin() + end, CentroidLess(centroids, axis));
+
+    const size_t child = _bvh.size();
+    _bvh[node].first = child;
+    _bvh[node].count = 0;
+    _bvh.resize(child + 2);
+    buildBVHNode(child, begin, mid, centroids);
+    buildBVHNode(child + 1, mid, end, centroids);
+  }
+
   LocalEvent 
   LTriangleMesh::getEvent(const Particle& part) const
   {
@@ -38,6 +164,27 @@ namespace dynamo {
       M_throw() << "Particle is not up to date";
 #endif
 
+    if (!_bvh.empty() && (Sim->dynamics.get() == _bvhDynamics) && (Sim->BCs.get() == _bvhBCs))
+      {
+#ifdef DYNAMO_DEBUG
+	const LocalEvent event = getEventBVH(part);
+	const LocalEvent linear = getEventLinear(part);
+	if ((event.getdt() != linear.getdt()) || (event.getExtraData() != linear.getExtraData()))
+	  M_throw() << "The BVH event for particle " << part.getID() << " (dt=" << event.getdt() 
+		    << ", data=" << event.getExtraData() << ") does not match a test of every triangle (dt=" 
+		    << linear.getdt() << ", data=" << linear.getExtraData() << ")";
+	return event;
+#else
+	return getEventBVH(part);
+#endif
+      }
+
+    return getEventLinear(part);
+  }
+
+  LocalEvent 
+  LTriangleMesh::getEventLinear(const Particle& part) const
+  {
     size_t triangleid = 0; //The id of the triangle for which the event is for
     double diam = 0.5 * _diameter->getProperty(part.getID());
 
@@ -57,6 +204,70 @@ namespace dynamo {
     return LocalEvent(part, tmin.first, WALL, *this, 8 * triangleid + tmin.second);
   }
 
+  LocalEvent 
+  LTriangleMesh::getEventBVH(const Particle& part) const
+  {
+    size_t triangleid = 0;
+    double diam = 0.5 * _diameter->getProperty(part.getID());
+
+    std::pair<double, size_t> tmin(HUGE_VAL, 0);
+
+    //The bounds are expanded by the interaction distance, so the
+    //entry time of a node is a lower bound on the event times of its
+    //triangles.
+    const double pad = diam + _bvhPadding;
+    const Vector padding(pad, pad, pad);
+    const Vector& pos = part.getPosition();
+    const Vector& vel = part.getVelocity();
+
+    //The nodes still to be visited and their entry times. The tree
+    //depth is at most log2 of the triangle count, and each visit
+    //replaces a node with its two children.
+    std::array<std::pair<double, size_t>, 2 * 64> stack;
+    size_t stackSize = 0;
+
+    double t = magnet::intersection::ray_AABB(pos, vel, _bvh[0].min - padding, _bvh[0].max + padding);
+    if (t != HUGE_VAL) stack[stackSize++] = std::make_pair(t, size_t(0));
+
+    while (stackSize)
+      {
+	const std::pair<double, size_t> entry = stack[--stackSize];
+	//Equal times are not culled, as a tied triangle with a lower ID
+	//is the event the linear search would find
+	if (entry.first > tmin.first) continue;
+
+	const BVHNode& node = _bvh[entry.second];
+	if (node.count)
+	  {
+	    for (size_t i(node.first); i < node.first + node.count; ++i)
+	      {
+		const size_t id = _bvhTriangles[i];
+		std::pair<double, size_t> tri
+		  = Sim->dynamics->getSphereTriangleEvent(part,
+							  _vertices[std::get<0>(_elements[id])],
+							  _vertices[std::get<1>(_elements[id])],
+							  _vertices[std::get<2>(_elements[id])],
+							  diam);
+		if ((tri < tmin) || ((tri == tmin) && (id < triangleid)))
+		  { tmin = tri; triangleid = id; }
+	      }
+	    continue;
+	  }
+
+	//Push the nearer child last, so it is visited first
+	const BVHNode& left = _bvh[node.first];
+	const BVHNode& right = _bvh[node.first + 1];
+	std::pair<double, size_t> tleft(magnet::intersection::ray_AABB(pos, vel, left.min - padding, left.max + padding), node.first);
+	std::pair<double, size_t> tright(magnet::intersection::ray_AABB(pos, vel, right.min - padding, right.max + padding), node.first + 1);
+	if (tleft.first < tright.first) std::swap(tleft, tright);
+
+	if ((tleft.first != HUGE_VAL) && (tleft.first <= tmin.first)) stack[stackSize++] = tleft;
+	if ((tright.first != HUGE_VAL) && (tright.first <= tmin.first)) stack[stackSize++] = tright;
+      }
+
+    return LocalEvent(part, tmin.first, WALL, *this, 8 * triangleid + tmin.second);
+  }
+
   void
   LTriangleMesh::runEvent(Particle& part, const LocalEvent& iEvent) const
   { 
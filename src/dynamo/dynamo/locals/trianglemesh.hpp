@@ -38,11 +38,15 @@ namespace dynamo {
       _e(Sim->_properties.getProperty
 	 (e, Property::Units::Dimensionless())),
       _diameter(Sim->_properties.getProperty
-		(d, Property::Units::Length()))
+		(d, Property::Units::Length())),
+      _bvhDynamics(NULL),
+      _bvhBCs(NULL)
     { localName = name; }
 
     virtual ~LTriangleMesh() {}
 
+    virtual void initialise(size_t);
+
     virtual LocalEvent getEvent(const Particle&) const;
 
     virtual void runEvent(Particle&, const LocalEvent&) const;
@@ -70,5 +74,55 @@ namespace dynamo {
 
     shared_ptr<Property> _e;
     shared_ptr<Property> _diameter;
+
+    /*! \brief A node of the bounding volume hierarchy (BVH) of the
+      triangles.
+
+      Internal nodes have count == 0 and their children are stored
+      at first and first + 1. Leaf nodes hold the triangles
+      _bvhTriangles[first] to _bvhTriangles[first + count - 1].
+    */
+    struct BVHNode
+    {
+      Vector min;
+      Vector max;
+      size_t first;
+      size_t count;
+    };
+
+    //! \brief The BVH nodes, the root node is the first node.
+    std::vector<BVHNode> _bvh;
+    //! \brief The triangle IDs, ordered so each leaf is contiguous.
+    std::vector<size_t> _bvhTriangles;
+    //! \brief A padding added to the BVH bounds to cover round-off.
+    double _bvhPadding;
+    /*! \brief The Dynamics and BoundaryCondition the BVH is valid
+      for.
+
+      The BVH culls triangles using straight line motion in an
+      infinite system, so it is only used while the Dynamics is
+      exactly DynNewtonian and the BC is exactly BCNone. These are
+      NULL if the BVH cannot be used.
+
+      DynGravity is deliberately not supported: its
+      getSphereTriangleEvent() is unfinished and throws for every
+      particle which feels gravity, so there are no events to
+      cull. Supporting it needs the entry time of the parabola into
+      the padded bounds in place of magnet::intersection::ray_AABB.
+      Periodic boundaries would need the minimum image of each
+      triangle.
+    */
+    const Dynamics* _bvhDynamics;
+    const BoundaryCondition* _bvhBCs;
+
+    void buildBVH();
+
+    void buildBVHNode(size_t node, size_t begin, size_t end, const std::vector<Vector>& centroids);
+
+    //! \brief Test the particle against every triangle.
+    LocalEvent getEventLinear(const Particle&) const;
+
+    //! \brief Test the particle against the triangles using the BVH.
+    LocalEvent getEventBVH(const Particle&) const;
   };
 }
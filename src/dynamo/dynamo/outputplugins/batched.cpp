@@ -0,0 +1,260 @@
+/*  dynamo:- Event driven molecular dynamics simulator 
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <dynamo/outputplugins/batched.hpp>
+#include <dynamo/simulation.hpp>
+#include <dynamo/include.hpp>
+#include <dynamo/NparticleEventData.hpp>
+#include <magnet/xmlreader.hpp>
+#include <functional>
+
+namespace dynamo {
+  OPBatched::OPBatched(const dynamo::Simulation* tmp, const char* name, const magnet::xml::Node& XML, 
+		       unsigned char fields, unsigned char order):
+    OutputPlugin(tmp, name, order),
+    _fields(fields),
+    _batchSize(1024),
+    _threaded(false),
+    _stop(false),
+    _discard(false)
+  {
+    if (XML.hasAttribute("BatchSize"))
+      _batchSize = XML.getAttribute("BatchSize").as<size_t>();
+
+    if (!_batchSize)
+      M_throw() << "The BatchSize of the " << name << " plugin must be at least 1";
+
+    _threaded = XML.hasAttribute("Threaded");
+
+    _batch.events.reserve(_batchSize);
+  }
+
+  OPBatched::~OPBatched()
+  {
+    //The derived class should have finished the batches already, but
+    //the consumer thread must not outlive the plugin.
+    if (_consumer.joinable())
+      {
+	{
+	  std::lock_guard<std::mutex> lock(_mutex);
+	  _stop = true;
+	}
+	_batchQueued.notify_all();
+	_consumer.join();
+      }
+  }
+
+  void
+  OPBatched::newRecord(const EventTypeTracking::classKey& key, EEventType type, double dt)
+  {
+    if (_batch.events.size() >= _batchSize)
+      submitBatch();
+
+    EventRecord record;
+    record.key = key;
+    record.type = type;
+    record.dt = dt;
+    record.systemTime = Sim->systemTime;
+    record.value = (_fields & RECORD_VALUE) ? sampleValue() : 0;
+    record.firstParticle = record.endParticle = _batch.particles.size();
+    _batch.events.push_back(record);
+  }
+
+  void
+  OPBatched::recordParticle(size_t ID, EEventType type)
+  {
+    ParticleRecord particle;
+    particle.ID = ID;
+    particle.type = type;
+    _batch.particles.push_back(particle);
+    ++_batch.events.back().endParticle;
+  }
+
+  void
+  OPBatched::recordParticles(const NEventData& NDat)
+  {
+    if (!(_fields & RECORD_PARTICLES)) return;
+
+    for (const ParticleEventData& pData : NDat.L1partChanges)
+      recordParticle(pData.getParticleID(), pData.getType());
+  
+    for (const PairEventData& pData : NDat.L2partChanges)
+      {
+	recordParticle(pData.particle1_.getParticleID(), pData.getType());
+	recordParticle(pData.particle2_.getParticleID(), pData.getType());
+      }
+  }
+
+  void 
+  OPBatched::submitBatch()
+  {
+    if (!_threaded)
+      {
+	processBatch(_batch);
+	_batch.clear();
+	return;
+      }
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (!_consumer.joinable())
+      _consumer = std::thread(std::bind(&OPBatched::consumeBatches, this));
+
+    while (_queue.size() >= MaxQueued)
+      _batchDone.wait(lock);
+
+    rethrowConsumerException();
+
+    _queue.push_back(Batch());
+    _queue.back().swap(_batch);
+
+    if (!_free.empty())
+      {
+	_batch.swap(_free.back());
+	_free.pop_back();
+      }
+    else
+      _batch.events.reserve(_batchSize);
+
+    lock.unlock();
+    _batchQueued.notify_one();
+  }
+
+  void 
+  OPBatched::consumeBatches()
+  {
+    std::unique_lock<std::mutex> lock(_mutex);
+    for (;;)
+      {
+	while (_queue.empty() && !_stop)
+	  _batchQueued.wait(lock);
+
+	if (_queue.empty()) return;
+
+	//The front batch stays in the queue while it is processed, so
+	//finishBatch() waits for it. References to the elements of a
+	//deque are not invalidated by push_back().
+	Batch& batch = _queue.front();
+	const bool discard = _discard;
+	lock.unlock();
+
+	std::exception_ptr exception;
+	if (!discard)
+	  try { processBatch(batch); }
+	  catch (...) { exception = std::current_exception(); }
+	batch.clear();
+
+	lock.lock();
+	if (exception && !_exception)
+	  _exception = exception;
+	_free.push_back(Batch());
+	_free.back().swap(batch);
+	_queue.pop_front();
+	_batchDone.notify_all();
+      }
+  }
+
+  void 
+  OPBatched::rethrowConsumerException()
+  {
+    if (!_exception) return;
+
+    std::exception_ptr exception;
+    std::swap(exception, _exception);
+    std::rethrow_exception(exception);
+  }
+
+  void 
+  OPBatched::processBatch(const Batch& batch)
+  {
+    const ParticleRecord* particles = batch.particles.data();
+    for (const EventRecord& record : batch.events)
+      processEvent(record, particles + record.firstParticle, particles + record.endParticle);
+  }
+
+  void 
+  OPBatched::finishBatch()
+  {
+    if (_threaded)
+      {
+	std::unique_lock<std::mutex> lock(_mutex);
+	while (!_queue.empty())
+	  _batchDone.wait(lock);
+	rethrowConsumerException();
+      }
+
+    processBatch(_batch);
+    _batch.clear();
+  }
+
+  void 
+  OPBatched::discardBatches()
+  {
+    _batch.clear();
+
+    if (!_threaded) return;
+
+    try
+      {
+	std::unique_lock<std::mutex> lock(_mutex);
+	_discard = true;
+	while (!_queue.empty())
+	  _batchDone.wait(lock);
+
+	if (_exception)
+	  {
+	    std::exception_ptr exception;
+	    std::swap(exception, _exception);
+	    try { std::rethrow_exception(exception); }
+	    catch (std::exception& err)
+	      { derr << "Discarding the batched events after an error while processing them:\n" << err.what() << std::endl; }
+	  }
+      }
+    catch (...) {}
+  }
+
+  void 
+  OPBatched::eventUpdate(const IntEvent& event, const PairEventData& PDat)
+  { 
+    newRecord(EventTypeTracking::getClassKey(event), event.getType(), event.getdt());
+    if (_fields & RECORD_PARTICLES)
+      {
+	recordParticle(PDat.particle1_.getParticleID(), event.getType());
+	recordParticle(PDat.particle2_.getParticleID(), event.getType());
+      }
+  }
+
+  void 
+  OPBatched::eventUpdate(const GlobalEvent& event, const NEventData& NDat)
+  { 
+    newRecord(EventTypeTracking::getClassKey(event), event.getType(), event.getdt());
+    recordParticles(NDat);
+  }
+
+  void 
+  OPBatched::eventUpdate(const LocalEvent& event, const NEventData& NDat)
+  { 
+    newRecord(EventTypeTracking::getClassKey(event), event.getType(), event.getdt());
+    recordParticles(NDat);
+  }
+
+  void 
+  OPBatched::eventUpdate(const System& event, const NEventData& NDat, const double& dt)
+  { 
+    newRecord(EventTypeTracking::getClassKey(event), event.getType(), dt);
+    recordParticles(NDat);
+  }
+}
@@ -0,0 +1,165 @@
+/*  dynamo:- Event driven molecular dynamics simulator 
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <dynamo/outputplugins/outputplugin.hpp>
+#include <dynamo/outputplugins/eventtypetracking.hpp>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dynamo {
+  /*! \brief An output plugin base class for plugins which process
+    the events in batches.
+
+    A small EventRecord of each event is stored as it occurs, and the
+    records are processed once BatchSize of them are collected. If
+    the Threaded option is set, the full batches are handed to a
+    consumer thread, which runs for the lifetime of the plugin, while
+    the Simulation continues to collect the next batch. At most
+    MaxQueued batches are waiting or being processed at once; the
+    Simulation waits for the consumer if it falls further behind.
+
+    Only the fields a plugin asks for (see ERecordFields) are
+    recorded. As the records are processed after the event, the
+    derived plugin must only use the data held in the records, and
+    not the current state of the Simulation. Derived classes must
+    call finishBatch() before reading their collected data (e.g., in
+    output()), and discardBatches() in their destructor.
+
+    Plugins which read the post-event particle state, or whose
+    results are read by other parts of the Simulation while it
+    runs, cannot be batched. OPMisc's running totals are used during
+    the event dispatch (by the multicanonical dynamics, the ensemble
+    exchange, and other plugins), and OPEventEffects reads the
+    post-event velocities. OPMSD only samples on the ticker.
+   */
+  class OPBatched: public OutputPlugin
+  {
+  public:
+    //! \brief The optional fields of an EventRecord.
+    typedef enum {
+      //! \brief The IDs and event types of the particles changed.
+      RECORD_PARTICLES = 1,
+      //! \brief The value returned by sampleValue() at the event.
+      RECORD_VALUE = 2
+    } ERecordFields;
+
+    OPBatched(const dynamo::Simulation*, const char*, const magnet::xml::Node&, 
+	      unsigned char fields, unsigned char order=100);
+
+    virtual ~OPBatched();
+
+    void eventUpdate(const IntEvent&, const PairEventData&);
+    void eventUpdate(const GlobalEvent&, const NEventData&);
+    void eventUpdate(const LocalEvent&, const NEventData&);
+    void eventUpdate(const System&, const NEventData&, const double&);
+
+  protected:
+    //! \brief A particle changed by an event.
+    struct ParticleRecord
+    {
+      size_t ID;
+      EEventType type;
+    };
+
+    //! \brief The recorded data of a single event.
+    struct EventRecord
+    {
+      EventTypeTracking::classKey key;
+      EEventType type;
+      //! \brief The time elapsed since the previous event.
+      double dt;
+      //! \brief The Simulation time after the event.
+      double systemTime;
+      //! \brief The value of sampleValue(), if RECORD_VALUE is set.
+      double value;
+      //! \brief The range of the event's ParticleRecords in the batch.
+      size_t firstParticle, endParticle;
+    };
+
+    /*! \brief Process a single event.
+
+      \param begin The first ParticleRecord of the event (only if
+      RECORD_PARTICLES is set).
+      \param end One past the last ParticleRecord of the event.
+     */
+    virtual void processEvent(const EventRecord&, const ParticleRecord* begin, const ParticleRecord* end) = 0;
+
+    /*! \brief Samples a value of the current Simulation state to
+      store in the EventRecord, if RECORD_VALUE is set.
+     */
+    virtual double sampleValue() const { return 0; }
+
+    /*! \brief Wait for the consumer thread to process the queued
+      batches and process the remaining records.
+     */
+    void finishBatch();
+
+    /*! \brief Stop the consumer thread from processing events, and
+      drop all of the records which have not been processed.
+
+      This does not throw, so it may be called from a destructor
+      (also while unwinding from a failed run). Any error of the
+      consumer thread is logged and dropped.
+     */
+    void discardBatches();
+
+  private:
+    struct Batch
+    {
+      std::vector<EventRecord> events;
+      std::vector<ParticleRecord> particles;
+
+      void clear() { events.clear(); particles.clear(); }
+      void swap(Batch& other) { events.swap(other.events); particles.swap(other.particles); }
+    };
+
+    void newRecord(const EventTypeTracking::classKey&, EEventType, double);
+    void recordParticle(size_t, EEventType);
+    void recordParticles(const NEventData&);
+    void submitBatch();
+    void processBatch(const Batch&);
+    void consumeBatches();
+    void rethrowConsumerException();
+
+    //! \brief The largest number of batches queued for the consumer.
+    static const size_t MaxQueued = 2;
+
+    unsigned char _fields;
+    size_t _batchSize;
+    bool _threaded;
+    Batch _batch;
+
+    std::thread _consumer;
+    std::mutex _mutex;
+    std::condition_variable _batchQueued;
+    std::condition_variable _batchDone;
+    //! \brief The batches for the consumer, the front batch is being
+    //! processed.
+    std::deque<Batch> _queue;
+    //! \brief Processed batches, kept to reuse their storage.
+    std::vector<Batch> _free;
+    std::exception_ptr _exception;
+    bool _stop;
+    //! \brief If the queued batches are dropped instead of processed.
+    bool _discard;
+  };
+}
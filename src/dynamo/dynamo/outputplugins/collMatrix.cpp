@@ -22,8 +22,8 @@
 #include <magnet/xmlwriter.hpp>
 
 namespace dynamo {
-  OPCollMatrix::OPCollMatrix(const dynamo::Simulation* tmp, const magnet::xml::Node&):
-    OutputPlugin(tmp,"CollisionMatrix"),
+  OPCollMatrix::OPCollMatrix(const dynamo::Simulation* tmp, const magnet::xml::Node& XML):
+    OPBatched(tmp, "CollisionMatrix", XML, RECORD_PARTICLES),
     totalCount(0)
   {
   }
@@ -35,91 +35,37 @@ namespace dynamo {
   }
 
   OPCollMatrix::~OPCollMatrix()
-  {}
+  { discardBatches(); }
 
   void 
-  OPCollMatrix::eventUpdate(const IntEvent& iEvent, const PairEventData&)
+  OPCollMatrix::processEvent(const EventRecord& record, const ParticleRecord* begin, const ParticleRecord* end)
   {
-    newEvent(iEvent.getParticle1ID(), iEvent.getType(), 
-	     getClassKey(iEvent));
-
-    newEvent(iEvent.getParticle2ID(), iEvent.getType(), 
-	     getClassKey(iEvent));
-  }
-
-
-  void 
-  OPCollMatrix::eventUpdate(const GlobalEvent& globEvent, const NEventData& SDat)
-  {
-    for (const ParticleEventData& pData : SDat.L1partChanges)
-      newEvent(pData.getParticleID(), pData.getType(), 
-	       getClassKey(globEvent));  
-  
-    for (const PairEventData& pData : SDat.L2partChanges)
-      {
-	newEvent(pData.particle1_.getParticleID(), 
-		 pData.getType(), getClassKey(globEvent));
-
-	newEvent(pData.particle2_.getParticleID(), 
-		 pData.getType(), getClassKey(globEvent));
-      }
-  }
-
-  void 
-  OPCollMatrix::eventUpdate(const LocalEvent& localEvent, const NEventData& SDat)
-  {
-    for (const ParticleEventData& pData : SDat.L1partChanges)
-      newEvent(pData.getParticleID(), 
-	       pData.getType(), getClassKey(localEvent));  
-  
-    for (const PairEventData& pData : SDat.L2partChanges)
-      {
-	newEvent(pData.particle1_.getParticleID(), 
-		 pData.getType(), getClassKey(localEvent));
-
-	newEvent(pData.particle2_.getParticleID(),
-		 pData.getType(), getClassKey(localEvent));
-      }
+    for (; begin != end; ++begin)
+      newEvent(begin->ID, begin->type, record.key, record.systemTime);
   }
 
   void 
-  OPCollMatrix::eventUpdate(const System& sysEvent, const NEventData& SDat, const double&)
-  {
-    for (const ParticleEventData& pData : SDat.L1partChanges)
-      newEvent(pData.getParticleID(), pData.getType(), getClassKey(sysEvent));
-  
-    for (const PairEventData& pData : SDat.L2partChanges)
-      {
-	newEvent(pData.particle1_.getParticleID(), 
-		 pData.getType(), getClassKey(sysEvent));
-
-	newEvent(pData.particle2_.getParticleID(), 
-		 pData.getType(), getClassKey(sysEvent));  
-      } 
-  }
-
-
-  void 
-  OPCollMatrix::newEvent(const size_t& part, const EEventType& etype, const classKey& ck)
+  OPCollMatrix::newEvent(const size_t& part, const EEventType& etype, const classKey& ck, const double& time)
   {
     if (lastEvent[part].second.first.second != NONE)
       {
 	counterData& refCount = counters[counterKey(eventKey(ck,etype), lastEvent[part].second)];
       
-	refCount.totalTime += Sim->systemTime - lastEvent[part].first;
+	refCount.totalTime += time - lastEvent[part].first;
 	++(refCount.count);
 	++(totalCount);
       }
     else
       ++initialCounter[eventKey(ck,etype)];
 
-    lastEvent[part].first = Sim->systemTime;
+    lastEvent[part].first = time;
     lastEvent[part].second = eventKey(ck, etype);
   }
 
   void
   OPCollMatrix::output(magnet::xml::XmlStream &XML)
   {
+    finishBatch();
   
     XML << magnet::xml::tag("CollCounters") 
 	<< magnet::xml::tag("TransitionMatrix");
@@ -16,7 +16,7 @@
 */
 
 #pragma once
-#include <dynamo/outputplugins/outputplugin.hpp>
+#include <dynamo/outputplugins/batched.hpp>
 #include <dynamo/eventtypes.hpp>
 #include <dynamo/outputplugins/eventtypetracking.hpp>
 #include <map>
@@ -27,7 +27,13 @@ namespace dynamo {
 
   using namespace EventTypeTracking;
 
-  class OPCollMatrix: public OutputPlugin
+  /*! \brief Counts the transitions between the types of event
+    each particle undergoes.
+
+    The events are processed in batches (see OPBatched), as only the
+    particle IDs, event types and event times are needed.
+   */
+  class OPCollMatrix: public OPBatched
   {
   private:
   
@@ -37,21 +43,20 @@ namespace dynamo {
 
     virtual void initialise();
 
-    virtual void eventUpdate(const IntEvent&, const PairEventData&);
-
-    virtual void eventUpdate(const GlobalEvent&, const NEventData&);
-
-    virtual void eventUpdate(const LocalEvent&, const NEventData&);
-
-    virtual void eventUpdate(const System&, const NEventData&, const double&);
-
     void output(magnet::xml::XmlStream &);
 
     //This is fine to replica exchange as the interaction, global and system lookups are done using names
-    virtual void changeSystem(OutputPlugin* plug) { std::swap(Sim, static_cast<OPCollMatrix*>(plug)->Sim); }
+    virtual void changeSystem(OutputPlugin* plug)
+    {
+      finishBatch();
+      static_cast<OPCollMatrix*>(plug)->finishBatch();
+      std::swap(Sim, static_cast<OPCollMatrix*>(plug)->Sim); 
+    }
   
   protected:
-    void newEvent(const size_t&, const EEventType&, const classKey&);
+    virtual void processEvent(const EventRecord&, const ParticleRecord*, const ParticleRecord*);
+
+    void newEvent(const size_t&, const EEventType&, const classKey&, const double&);
   
     struct counterData
     {
@@ -56,8 +56,12 @@ namespace dynamo {
 
     if (!_interaction)
       M_throw() << "Could not cast \"" << _interaction_name << "\" to an ICapture type to build the contact map";
+
+    //The maps are collected in order, this avoids building an
+    //ordered copy of a hashed capture map at every event
+    _interaction->keepOrderedView();
     
-    _current_map = _collected_maps.insert(CollectedMapType::value_type(*_interaction, MapData(Sim->calcInternalEnergy(), _next_map_id++))).first;
+    _current_map = _collected_maps.insert(CollectedMapType::value_type(_interaction->getCaptureMap(), MapData(Sim->calcInternalEnergy(), _next_map_id++))).first;
   }
 
   void OPContactMap::stream(double dt) { _weight += dt; }
@@ -96,10 +100,11 @@ namespace dynamo {
     size_t oldMapID(_current_map->second._id);
     
     //Try and find the current map in the collected maps
-    _current_map = _collected_maps.find(*_interaction);
+    detail::CaptureMapKey key(_interaction->getCaptureMap());
+    _current_map = _collected_maps.find(key);
     if (_current_map == _collected_maps.end())
       //Insert the new map
-      _current_map = _collected_maps.insert(CollectedMapType::value_type(*_interaction, MapData(Sim->getOutputPlugin<OPMisc>()->getConfigurationalU(), _next_map_id++))).first;
+      _current_map = _collected_maps.insert(CollectedMapType::value_type(std::move(key), MapData(Sim->getOutputPlugin<OPMisc>()->getConfigurationalU(), _next_map_id++))).first;
     
     //Add the link	    
     if (addLink)
@@ -155,7 +160,7 @@ namespace dynamo {
 	    << magnet::xml::attr("Energy") << entry.second._energy / Sim->units.unitEnergy()
 	    << magnet::xml::attr("Weight") << entry.second._weight / _total_weight;
 	
-	for (const ICapture::value_type& ids : entry.first)
+	for (const detail::CaptureMap::value_type& ids : entry.first)
 	  XML << magnet::xml::tag("Contact")
 	      << magnet::xml::attr("ID1") << ids.first.first
 	      << magnet::xml::attr("ID2") << ids.first.second
@@ -16,6 +16,7 @@
 */
 
 #include <dynamo/outputplugins/tickerproperty/include.hpp>
+#include <dynamo/outputplugins/batched.hpp>
 #include <dynamo/outputplugins/collMatrix.hpp>
 #include <dynamo/outputplugins/eventtypetracking.hpp>
 #include <dynamo/outputplugins/msdOrientational.hpp>
@@ -26,37 +26,23 @@
 
 namespace dynamo {
   OPIntEnergyHist::OPIntEnergyHist(const dynamo::Simulation* tmp, const magnet::xml::Node& XML):
-    OutputPlugin(tmp,"InternalEnergyHistogram", 10),//Before OPEnergy
+    OPBatched(tmp, "InternalEnergyHistogram", XML, RECORD_VALUE, 10),//Before OPEnergy
     intEnergyHist(1.0),
     binwidth(1.0)
   {
     operator<<(XML);
   }
 
-  void 
-  OPIntEnergyHist::eventUpdate(const IntEvent &event, 
-			    const PairEventData &) 
-  {
-    intEnergyHist.addVal(_ptrOPMisc->getConfigurationalU(), event.getdt());
-  }
-
-  void 
-  OPIntEnergyHist::eventUpdate(const GlobalEvent &event, const NEventData&) 
-  {
-    intEnergyHist.addVal(_ptrOPMisc->getConfigurationalU(), event.getdt());
-  }
+  OPIntEnergyHist::~OPIntEnergyHist()
+  { discardBatches(); }
 
-  void 
-  OPIntEnergyHist::eventUpdate(const LocalEvent &event, const NEventData&) 
-  {
-    intEnergyHist.addVal(_ptrOPMisc->getConfigurationalU(), event.getdt());
-  }
+  double
+  OPIntEnergyHist::sampleValue() const
+  { return _ptrOPMisc->getConfigurationalU(); }
 
   void 
-  OPIntEnergyHist::eventUpdate(const System&, const NEventData&, const double& dt)
-  {
-    intEnergyHist.addVal(_ptrOPMisc->getConfigurationalU(), dt);
-  }
+  OPIntEnergyHist::processEvent(const EventRecord& record, const ParticleRecord*, const ParticleRecord*)
+  { intEnergyHist.addVal(record.value, record.dt); }
 
   void 
   OPIntEnergyHist::operator<<(const magnet::xml::Node& XML)
@@ -76,12 +62,16 @@ namespace dynamo {
   void 
   OPIntEnergyHist::changeSystem(OutputPlugin* EHist2)
   {
+    finishBatch();
+    static_cast<OPIntEnergyHist*>(EHist2)->finishBatch();
     std::swap(Sim, static_cast<OPIntEnergyHist*>(EHist2)->Sim);
   }
 
   std::unordered_map<int, double>
-  OPIntEnergyHist::getImprovedW() const
+  OPIntEnergyHist::getImprovedW()
   {
+    finishBatch();
+
     if (!std::dynamic_pointer_cast<const DynNewtonianMC>(Sim->dynamics))
       M_throw() << "Cannot improve an non-Multicanonical Dynamics";
 
@@ -127,6 +117,8 @@ namespace dynamo {
   void 
   OPIntEnergyHist::output(magnet::xml::XmlStream& XML)
   {
+    finishBatch();
+
     XML << magnet::xml::tag("EnergyHist")
 	<< magnet::xml::attr("BinWidth") << binwidth;
 
@@ -16,27 +16,27 @@
 */
 
 #pragma once
-#include <dynamo/outputplugins/outputplugin.hpp>
+#include <dynamo/outputplugins/batched.hpp>
 #include <magnet/math/histogram.hpp>
 #include <unordered_map>
 
 namespace dynamo {
   class OPMisc;
 
-  class OPIntEnergyHist: public OutputPlugin
+  /*! \brief Collects a time weighted histogram of the
+    configurational internal energy.
+
+    The events are processed in batches (see OPBatched), as only the
+    internal energy and the time between the events are needed.
+   */
+  class OPIntEnergyHist: public OPBatched
   {
   public:
     OPIntEnergyHist(const dynamo::Simulation*, const magnet::xml::Node&);
 
-    virtual void initialise();
-
-    virtual void eventUpdate(const IntEvent&, const PairEventData&);
-
-    virtual void eventUpdate(const GlobalEvent&, const NEventData&);
+    ~OPIntEnergyHist();
 
-    virtual void eventUpdate(const LocalEvent&, const NEventData&);
-
-    virtual void eventUpdate(const System&, const NEventData&, const double&);
+    virtual void initialise();
 
     virtual void output(magnet::xml::XmlStream&);
 
@@ -44,9 +44,13 @@ namespace dynamo {
   
     void operator<<(const magnet::xml::Node&);
 
-    std::unordered_map<int, double> getImprovedW() const;
+    std::unordered_map<int, double> getImprovedW();
     inline double getBinWidth() const { return intEnergyHist.getBinWidth(); }
   protected:
+    virtual void processEvent(const EventRecord&, const ParticleRecord*, const ParticleRecord*);
+
+    virtual double sampleValue() const;
+
     magnet::math::HistogramWeighted<> intEnergyHist;
     shared_ptr<const OPMisc> _ptrOPMisc;
     double binwidth;
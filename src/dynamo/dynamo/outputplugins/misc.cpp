@@ -21,8 +21,11 @@
 #include <magnet/memUsage.hpp>
 #include <magnet/xmlwriter.hpp>
 #include <dynamo/systems/tHalt.hpp>
+#include <dynamo/globals/neighbourList.hpp>
+#include <dynamo/schedulers/scheduler.hpp>
 #include <sys/time.h>
 #include <ctime>
+#include <algorithm>
 
 namespace dynamo {
   OPMisc::OPMisc(const dynamo::Simulation* tmp, const magnet::xml::Node&):
@@ -107,23 +110,50 @@ namespace dynamo {
     _internalEnergy.clear();
     _internalEnergy.resize(Sim->N, 0);
 
-    for (auto ptr1 = Sim->particles.begin(); ptr1 != Sim->particles.end(); ++ptr1)
-      for (auto ptr2 = ptr1 + 1; ptr2 != Sim->particles.end(); ++ptr2)
-	{
-	  double energy = 0.5 * Sim->getInteraction(*ptr1, *ptr2)->getInternalEnergy(*ptr1, *ptr2);
-	  _internalEnergy[ptr1->getID()] += energy;
-	  _internalEnergy[ptr2->getID()] += energy;
-	}
+    //Pairs only have an internal energy within their interaction
+    //range, so if a neighbour list covers it, only the neighbours are
+    //tested instead of every pair.
+    const GNeighbourList* nblist = GNeighbourList::findCompleteList(Sim, Sim->getLongestInteraction());
 
-    for (const Particle& part : Sim->particles)
+    std::vector<size_t> neighbours;
+    for (const Particle& p1 : Sim->particles)
       {
-	const Species& sp = *(Sim->species[part]);
-	const double mass = sp.getMass(part.getID());
-	if (std::isinf(mass)) continue;
-	kineticP += mass * Dyadic(part.getVelocity(), part.getVelocity());
-	_speciesMasses[sp.getID()] += mass;
-	_speciesMomenta[sp.getID()] += mass * part.getVelocity();
-	thermalConductivityFS += part.getVelocity() * (Sim->dynamics->getParticleKineticEnergy(part) + _internalEnergy[part.getID()]);
+	neighbours.clear();
+	if (nblist)
+	  {
+	    nblist->getParticleNeighbours(p1, neighbours);
+	    //The cells may list a particle more than once in small
+	    //systems
+	    std::sort(neighbours.begin(), neighbours.end());
+	    neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+	  }
+	else
+	  for (size_t ID2(p1.getID() + 1); ID2 < Sim->N; ++ID2)
+	    neighbours.push_back(ID2);
+
+	for (const size_t ID2 : neighbours)
+	  if (ID2 > p1.getID())
+	    {
+	      const Particle& p2 = Sim->particles[ID2];
+	      double energy = 0.5 * Sim->getInteraction(p1, p2)->getInternalEnergy(p1, p2);
+	      _internalEnergy[p1.getID()] += energy;
+	      _internalEnergy[ID2] += energy;
+	    }
+      }
+
+    for (const shared_ptr<Species>& spPtr : Sim->species)
+      {
+	const Species& sp = *spPtr;
+	for (const size_t ID : *(sp.getRange()))
+	  {
+	    const Particle& part = Sim->particles[ID];
+	    const double mass = sp.getMass(ID);
+	    if (std::isinf(mass)) continue;
+	    kineticP += mass * Dyadic(part.getVelocity(), part.getVelocity());
+	    _speciesMasses[sp.getID()] += mass;
+	    _speciesMomenta[sp.getID()] += mass * part.getVelocity();
+	    thermalConductivityFS += part.getVelocity() * (Sim->dynamics->getParticleKineticEnergy(part) + _internalEnergy[ID]);
+	  }
       }
 
     Vector sysMomentum(0, 0, 0);
@@ -384,6 +414,8 @@ namespace dynamo {
 	 << "\nTotal Collisions Executed " << Sim->eventCount
 	 << "\nAvg Events/s " << getEventsPerSecond()
 	 << "\nSim time per second " << getSimTimePerSecond()
+	 << "\nNew neighbour predictions skipped " << Sim->ptrScheduler->getSkippedPredictionCount()
+	 << " of " << Sim->ptrScheduler->getNewNeighbourCount()
 	 << std::endl;
 
     const double V = Sim->getSimVolume();
@@ -506,6 +538,10 @@ namespace dynamo {
 	<< tag("NegativeTimeEvents")
 	<< attr("Count") << _reverseEvents
 	<< endtag("NegativeTimeEvents")
+	<< tag("NewNeighbourPredictions")
+	<< attr("Count") << Sim->ptrScheduler->getNewNeighbourCount()
+	<< attr("Skipped") << Sim->ptrScheduler->getSkippedPredictionCount()
+	<< endtag("NewNeighbourPredictions")
 	<< tag("Memusage")
 	<< attr("MaxKiloBytes") << magnet::process_mem_usage()
 	<< endtag("Memusage")
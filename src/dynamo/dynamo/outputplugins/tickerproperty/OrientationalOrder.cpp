@@ -88,12 +88,14 @@ namespace dynamo {
   {
     size_t count(0);
     ComplexNum sum(0,0);
+    std::vector<size_t> ids;
     for (const Particle& part : Sim->particles)
       {
 	Neighbours nbs;
 	
-	std::unique_ptr<IDRange> ids(Sim->ptrScheduler->getParticleNeighbours(part));
-	for (const size_t& id1 : *ids)
+	ids.clear();
+	Sim->ptrScheduler->getParticleNeighbours(part, ids);
+	for (const size_t& id1 : ids)
 	  nbs.addNeighbour(part, id1);
 	
 	if (nbs._neighbours.size() >= 6)
@@ -88,10 +88,12 @@ namespace dynamo {
   {
     sphericalsum ssum(Sim, rg, maxl);
   
+    std::vector<size_t> ids;
     for (const Particle& part : Sim->particles)
       {
-	std::unique_ptr<IDRange> ids(Sim->ptrScheduler->getParticleNeighbours(part));
-	for (const size_t& id1 : *ids)
+	ids.clear();
+	Sim->ptrScheduler->getParticleNeighbours(part, ids);
+	for (const size_t& id1 : ids)
 	  ssum(part, id1);
       
 	for (size_t l(0); l < maxl; ++l)
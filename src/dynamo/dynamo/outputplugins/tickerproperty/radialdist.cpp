@@ -19,8 +19,13 @@
 #include <dynamo/outputplugins/misc.hpp>
 #include <dynamo/include.hpp>
 #include <dynamo/dynamics/dynamics.hpp>
+#include <dynamo/BC/LEBC.hpp>
 #include <magnet/xmlwriter.hpp>
 #include <magnet/xmlreader.hpp>
+#include <magnet/thread/threadpool.hpp>
+#include <algorithm>
+#include <cmath>
+#include <functional>
 
 namespace dynamo {
   OPRadialDistribution::OPRadialDistribution(const dynamo::Simulation* tmp, 
@@ -28,6 +33,7 @@ namespace dynamo {
     OPTicker(tmp,"RadialDistribution"),
     binWidth(0.1),
     length(100),
+    referenceStride(1),
     sampleCount(0),
     sample_energy(0),
     sample_energy_bin_width(0)
@@ -62,6 +68,12 @@ namespace dynamo {
 	    + static_cast<size_t>(Sim->primaryCellSize[mindir] / (2 * binWidth));
 	}
 
+      if (XML.hasAttribute("ReferenceStride"))
+	referenceStride = XML.getAttribute("ReferenceStride").as<size_t>();
+
+      if (!referenceStride)
+	M_throw() << "ReferenceStride must be at least 1";
+
       if (XML.hasAttribute("SampleEnergy"))
 	{
 	  sample_energy 
@@ -76,7 +88,8 @@ namespace dynamo {
 	}
       
       dout << "Binwidth = " << binWidth / Sim->units.unitLength()
-	   << "\nLength = " << length << std::endl;
+	   << "\nLength = " << length
+	   << "\nReferenceStride = " << referenceStride << std::endl;
     }
     catch (std::exception& excep)
       {
@@ -88,12 +101,20 @@ namespace dynamo {
   void 
   OPRadialDistribution::initialise()
   {
-    data.resize
-      (Sim->species.size(),
-       std::vector<std::vector<unsigned long> >
-       (Sim->species.size(),
-	std::vector<unsigned long>(length, 0))
-       );
+    const size_t nSpecies = Sim->species.size();
+    const size_t nBlocks = Sim->threads ? 4 * std::max(size_t(1), Sim->threads->getThreadCount()) : 1;
+    data.assign(nBlocks, std::vector<unsigned long>(nSpecies * nSpecies * length, 0));
+
+    //Particles outside of all species are not sampled
+    _speciesID.assign(Sim->N, nSpecies);
+    _referenceCount.assign(nSpecies, 0);
+    for (const shared_ptr<Species>& sp : Sim->species)
+      for (const size_t& p : *sp->getRange())
+	{
+	  _speciesID[p] = sp->getID();
+	  if (!(p % referenceStride))
+	    ++_referenceCount[sp->getID()];
+	}
 
     if (!(Sim->getOutputPlugin<OPMisc>()))
       M_throw() << "Radial Distribution requires the Misc output plugin";
@@ -101,6 +122,119 @@ namespace dynamo {
     ticker();
   }
 
+  void 
+  OPRadialDistribution::buildCells()
+  {
+    _cellStart.clear();
+
+    //The sheared images of the Lees-Edwards BC do not line up with
+    //the cells
+    if (std::dynamic_pointer_cast<BCLeesEdwards>(Sim->BCs))
+      return;
+
+    //Any pair which is binned is closer than this
+    const double maxDistance = length * binWidth;
+
+    //There is no benefit in having more cells than particles
+    const size_t maxCells = 1 + static_cast<size_t>(std::cbrt(double(Sim->N)));
+
+    size_t nCells = 1;
+    for (size_t iDim(0); iDim < NDIM; ++iDim)
+      {
+	const double cells = std::floor(Sim->primaryCellSize[iDim] / maxDistance);
+
+	//At least 3 cells are needed so that the neighbouring
+	//cells of a cell are all distinct
+	if (!(cells >= 3))
+	  return;
+
+	_cellCount[iDim] = std::min(maxCells, static_cast<size_t>(std::min(cells, 1e6)));
+	nCells *= _cellCount[iDim];
+      }
+
+    //Counting sort the particles into the cells
+    _particleCell.resize(Sim->N);
+    _cellStart.assign(nCells + 1, 0);
+    for (const Particle& part : Sim->particles)
+      {
+	size_t cell = 0;
+	for (size_t iDim(NDIM); iDim != 0; --iDim)
+	  {
+	    //The position in the primary image, as a fraction of the box
+	    double x = part.getPosition()[iDim - 1] / Sim->primaryCellSize[iDim - 1] + 0.5;
+	    x -= std::floor(x);
+	    cell = cell * _cellCount[iDim - 1]
+	      + std::min(static_cast<size_t>(x * _cellCount[iDim - 1]), _cellCount[iDim - 1] - 1);
+	  }
+	_particleCell[part.getID()] = cell;
+	++_cellStart[cell + 1];
+      }
+
+    for (size_t c(0); c < nCells; ++c)
+      _cellStart[c + 1] += _cellStart[c];
+
+    std::vector<size_t> next(_cellStart.begin(), _cellStart.end() - 1);
+    _cellParticles.resize(Sim->N);
+    for (size_t p(0); p < Sim->N; ++p)
+      _cellParticles[next[_particleCell[p]]++] = p;
+  }
+
+  void
+  OPRadialDistribution::samplePair(size_t p1, size_t p2, std::vector<unsigned long>& histogram) const
+  {
+    if (_speciesID[p2] == Sim->species.size()) return;
+
+    Vector  rij = Sim->particles[p1].getPosition()
+      - Sim->particles[p2].getPosition();
+	
+    Sim->BCs->applyBC(rij);
+	
+    size_t i = (long) (((rij.nrm())/binWidth) + 0.5);
+	
+    if (i < length)
+      ++histogram[(_speciesID[p1] * Sim->species.size() + _speciesID[p2]) * length + i];
+  }
+
+  void
+  OPRadialDistribution::sampleBlock(size_t begin, size_t end, std::vector<unsigned long>& histogram) const
+  {
+    for (size_t p1 = referenceStride * ((begin + referenceStride - 1) / referenceStride); 
+	 p1 < end; p1 += referenceStride)
+      {
+	if (_speciesID[p1] == Sim->species.size()) continue;
+
+	if (_cellStart.empty())
+	  {
+	    for (size_t p2(0); p2 < Sim->N; ++p2)
+	      samplePair(p1, p2, histogram);
+	    continue;
+	  }
+
+	//Test the particles of the 27 cells around (and including)
+	//the cell of p1
+	std::array<size_t, 3> coords;
+	size_t cell = _particleCell[p1];
+	for (size_t iDim(0); iDim < NDIM; ++iDim)
+	  {
+	    coords[iDim] = cell % _cellCount[iDim];
+	    cell /= _cellCount[iDim];
+	  }
+
+	for (size_t z(0); z < 3; ++z)
+	  for (size_t y(0); y < 3; ++y)
+	    for (size_t x(0); x < 3; ++x)
+	      {
+		const size_t neighbour 
+		  = (coords[0] + _cellCount[0] + x - 1) % _cellCount[0]
+		  + _cellCount[0] * ((coords[1] + _cellCount[1] + y - 1) % _cellCount[1]
+				     + _cellCount[1] * ((coords[2] + _cellCount[2] + z - 1) % _cellCount[2]));
+
+		for (size_t j(_cellStart[neighbour]); j < _cellStart[neighbour + 1]; ++j)
+		  samplePair(p1, _cellParticles[j], histogram);
+	      }
+      }
+  }
+
   void 
   OPRadialDistribution::ticker()
   {
@@ -123,22 +257,25 @@ namespace dynamo {
       }
     
     ++sampleCount;
-  
-    for (const shared_ptr<Species>& sp1 : Sim->species)
-      for (const shared_ptr<Species>& sp2 : Sim->species)
-      for (const size_t& p1 : *sp1->getRange())
-      for (const size_t& p2 : *sp2->getRange())
+
+    buildCells();
+
+    //Each block of reference particles has its own histogram, so
+    //the blocks can be sampled in parallel
+    const size_t nBlocks = data.size();
+    const size_t blockSize = (Sim->N + nBlocks - 1) / nBlocks;
+    if ((nBlocks > 1) && Sim->threads)
       {
-	Vector  rij = Sim->particles[p1].getPosition()
-	  - Sim->particles[p2].getPosition();
-	
-	Sim->BCs->applyBC(rij);
-	
-	size_t i = (long) (((rij.nrm())/binWidth) + 0.5);
-	
-	if (i < length)
-	  ++data[sp1->getID()][sp2->getID()][i];
+	std::vector<std::function<void()> > tasks;
+	for (size_t i(0); i < nBlocks; ++i)
+	  tasks.push_back(std::bind(&OPRadialDistribution::sampleBlock, this, std::min(Sim->N, i * blockSize),
+				    std::min(Sim->N, (i + 1) * blockSize), std::ref(data[i])));
+	Sim->threads->queueTasks(tasks);
+	Sim->threads->wait();
       }
+    else
+      for (size_t i(0); i < nBlocks; ++i)
+	sampleBlock(std::min(Sim->N, i * blockSize), std::min(Sim->N, (i + 1) * blockSize), data[i]);
   }
 
   void
@@ -154,7 +291,7 @@ namespace dynamo {
       {
 	double density = sp2->getCount() / Sim->getSimVolume();
 
-	unsigned long originsTaken = sampleCount * sp1->getCount();
+	unsigned long originsTaken = sampleCount * _referenceCount[sp1->getID()];
 
 	XML << magnet::xml::tag("Species")
 	    << magnet::xml::attr("Name1")
@@ -171,7 +308,11 @@ namespace dynamo {
 	    double radius = binWidth * i;
 	    double volshell = (4.0 * M_PI * binWidth * radius * radius) +
 	      ((M_PI * binWidth * binWidth * binWidth) / 3.0);
-	    double GR = static_cast<double>(data[sp1->getID()][sp2->getID()][i])
+	    unsigned long count = 0;
+	    for (const std::vector<unsigned long>& histogram : data)
+	      count += histogram[(sp1->getID() * Sim->species.size() + sp2->getID()) * length + i];
+
+	    double GR = static_cast<double>(count)
 	      / (density * originsTaken * volshell);
 
 	    XML << radius / Sim->units.unitLength() << " " 
@@ -19,9 +19,25 @@
 
 #include <dynamo/outputplugins/tickerproperty/ticker.hpp>
 #include <magnet/math/histogram.hpp>
+#include <array>
 #include <vector>
 
 namespace dynamo {
+  /*! \brief Samples the radial distribution function, g(r), of each
+    pair of species.
+
+    On each tick, the particles are sorted into a temporary grid of
+    cells no narrower than the largest sampled distance, so only the
+    particles in the neighbouring cells of each reference particle are
+    tested. If the box is too small for this (or it is sheared), all
+    pairs are tested instead. The reference particles are split into
+    blocks, which are sampled in parallel if the simulation has a
+    thread pool.
+
+    Setting the ReferenceStride attribute to n only uses every n-th
+    particle (by ID) as a reference particle, reducing the cost of
+    each sample by the same factor.
+   */
   class OPRadialDistribution: public OPTicker
   {
   public:
@@ -39,11 +55,37 @@ namespace dynamo {
     void operator<<(const magnet::xml::Node&);
 
   protected:
+    //! \brief Sorts the particles into the cell grid, or clears it if it cannot be used.
+    void buildCells();
+
+    /*! \brief Adds the pairs of the reference particles in [begin,
+        end) to a histogram.
+     */
+    void sampleBlock(size_t begin, size_t end, std::vector<unsigned long>& histogram) const;
+
+    //! \brief Adds the pair (p1, p2) to a histogram.
+    inline void samplePair(size_t p1, size_t p2, std::vector<unsigned long>& histogram) const;
+
     double binWidth;
     size_t length;
+    size_t referenceStride;
     unsigned long sampleCount;
     double sample_energy; 
     double sample_energy_bin_width;
-    std::vector<std::vector<std::vector<unsigned long> > > data;
+
+    /*! \brief The histogram of each block of reference particles,
+        indexed by [(species1 * species + species2) * length + bin].
+     */
+    std::vector<std::vector<unsigned long> > data;
+    //! \brief The number of reference particles in each species.
+    std::vector<size_t> _referenceCount;
+    //! \brief The species ID of each particle.
+    std::vector<size_t> _speciesID;
+
+    std::array<size_t, 3> _cellCount;
+    //! \brief The particles of cell c are _cellParticles[_cellStart[c]] to _cellParticles[_cellStart[c+1]-1].
+    std::vector<size_t> _cellStart;
+    std::vector<size_t> _cellParticles;
+    std::vector<size_t> _particleCell;
   };
 }
@@ -18,9 +18,11 @@
 #include <magnet/exception.hpp>
 #include <magnet/xmlwriter.hpp>
 #include <magnet/xmlreader.hpp>
+#include <magnet/xmlpullparser.hpp>
 #include <magnet/units.hpp>
 #include <vector>
 #include <string>
+#include <iostream>
 #include <algorithm>
 #include <cmath>
 
@@ -84,6 +86,21 @@ namespace dynamo {
     inline virtual void outputParticleXMLData(magnet::xml::XmlStream& XML, 
 					      const size_t pID) const {}
 
+    /*! Write the values of this Property for all N particles in the
+      binary configuration format.
+    */
+    inline virtual void outputParticleBinaryData(std::ostream& os, const size_t N) const {}
+
+    /*! Load the values of this Property for all N particles from the
+      binary configuration format.
+    */
+    inline virtual void loadParticleBinaryData(std::istream& is, const size_t N) {}
+
+    /*! Load the value of this Property for the next particle from
+      the attributes of its Pt tag.
+    */
+    inline virtual void loadParticleXMLData(const magnet::xml::PullParser& parser) {}
+
   protected:
     virtual void outputXML(magnet::xml::XmlStream& XML) const 
     { M_throw() << "Unimplemented"; }
@@ -156,11 +173,7 @@ namespace dynamo {
       Property(Property::Units(node.getAttribute("Units").getValue())),
       _name(node.getAttribute("Name").getValue())
     {
-      //Move up to the particles nodes, and start loading the property values
-      for (magnet::xml::Node pNode = node.getParent().getParent()
-	     .getNode("ParticleData").fastGetNode("Pt");
-	   pNode.valid(); ++pNode)
-	_values.push_back(pNode.getAttribute(_name).as<double>());
+      //The values are loaded along with the particle data
     }
   
     inline virtual const double& getProperty(size_t ID) const 
@@ -202,7 +215,24 @@ namespace dynamo {
 
     inline void outputParticleXMLData(magnet::xml::XmlStream& XML, const size_t pID) const
     { XML << magnet::xml::attr(_name) << getProperty(pID); }
-  
+
+    inline void outputParticleBinaryData(std::ostream& os, const size_t N) const
+    {
+      if (_values.size() != N)
+	M_throw() << "ParticleProperty \"" << _name << "\" has " << _values.size() 
+		  << " entries but there are " << N << " particles";
+      os.write(reinterpret_cast<const char*>(_values.data()), N * sizeof(double));
+    }
+
+    inline void loadParticleBinaryData(std::istream& is, const size_t N)
+    {
+      _values.resize(N);
+      if (!is.read(reinterpret_cast<char*>(_values.data()), N * sizeof(double)))
+	M_throw() << "Failed to read the binary data of the ParticleProperty \"" << _name << "\"";
+    }
+
+    inline void loadParticleXMLData(const magnet::xml::PullParser& parser)
+    { _values.push_back(parser.getAttributeAs<double>(_name.c_str())); }
   
   protected:
     /*! \brief Output an XML representation of the Property to the
@@ -347,6 +377,33 @@ namespace dynamo {
 	property->outputParticleXMLData(XML, pID);
     }
 
+    /*! \brief Write the per-particle data of all Property-s in the
+        binary configuration format.
+     */
+    inline void outputParticleBinaryData(std::ostream& os, size_t N) const 
+    {
+      for (const auto& property : _namedProperties)
+	property->outputParticleBinaryData(os, N);
+    }
+
+    /*! \brief Load the per-particle data of all Property-s from the
+        binary configuration format.
+     */
+    inline void loadParticleBinaryData(std::istream& is, size_t N)
+    {
+      for (auto& property : _namedProperties)
+	property->loadParticleBinaryData(is, N);
+    }
+
+    /*! \brief Load the per-particle data of all Property-s for the
+        next particle, from the attributes of its Pt tag.
+     */
+    inline void loadParticleXMLData(const magnet::xml::PullParser& parser)
+    {
+      for (auto& property : _namedProperties)
+	property->loadParticleXMLData(parser);
+    }
+
     /*! \brief Method for pushing constructed properties into the
       PropertyStore.
      
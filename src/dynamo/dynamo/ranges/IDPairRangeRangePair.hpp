@@ -41,6 +41,9 @@ namespace dynamo {
       return false;
     }
 
+    const shared_ptr<IDRange>& getRange1() const { return range1; }
+    const shared_ptr<IDRange>& getRange2() const { return range2; }
+
   protected:
 
     virtual void outputXML(magnet::xml::XmlStream& XML) const
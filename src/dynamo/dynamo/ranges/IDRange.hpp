@@ -30,6 +30,12 @@ namespace dynamo {
   {
   public:
 
+    /*! \brief An iterator over the IDs of a range.
+
+      If the range is a contiguous block of IDs, the iterator holds
+      the ID itself and no virtual calls are made while iterating.
+      Otherwise each ID is looked up through operator[].
+     */
     class iterator
     {
       friend class IDRange;
@@ -58,7 +64,7 @@ namespace dynamo {
       { ++pos; return *this; }
 
       inline size_t operator*() const
-      { return (*rangePtr)[pos]; }
+      { return rangePtr ? (*rangePtr)[pos] : pos; }
 
       typedef size_t difference_type;
       typedef size_t value_type;
@@ -83,13 +89,33 @@ namespace dynamo {
 
     virtual unsigned long at(unsigned long) const = 0;
 
+    /*! \brief Tests if the range is the contiguous block of IDs
+        [start, start + size()).
+
+      \param start Set to the first ID of the range, if it is contiguous.
+     */
+    virtual bool isContiguous(unsigned long& start) const { return false; }
+
     static IDRange* getClass(const magnet::xml::Node&, const dynamo::Simulation * Sim);
 
     friend magnet::xml::XmlStream& operator<<(magnet::xml::XmlStream& XML,
 					      const IDRange& range);
 
-    iterator begin() const { return IDRange::iterator(0, this); }
-    iterator end() const { return IDRange::iterator(size(), this); }
+    iterator begin() const 
+    { 
+      unsigned long start;
+      if (isContiguous(start))
+	return IDRange::iterator(start, NULL);
+      return IDRange::iterator(0, this);
+    }
+
+    iterator end() const
+    { 
+      unsigned long start;
+      if (isContiguous(start))
+	return IDRange::iterator(start + size(), NULL);
+      return IDRange::iterator(size(), this);
+    }
 
     inline bool empty() const { return begin() == end(); }
 
@@ -44,6 +44,9 @@ namespace dynamo {
     virtual unsigned long operator[](unsigned long i) const  
     { return i; }
 
+    virtual bool isContiguous(unsigned long& start) const
+    { start = 0; return true; }
+
     virtual unsigned long at(unsigned long i) const 
     { 
       if (i >= Sim->particles.size())
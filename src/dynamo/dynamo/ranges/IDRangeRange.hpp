@@ -40,6 +40,9 @@ namespace dynamo {
     virtual unsigned long operator[](unsigned long i) const  
     { return startID + i; }
 
+    virtual bool isContiguous(unsigned long& start) const
+    { start = startID; return true; }
+
     virtual unsigned long at(unsigned long i) const 
     { 
       if (i >= endID - startID)
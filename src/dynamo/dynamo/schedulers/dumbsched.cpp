@@ -19,8 +19,6 @@
 #include <dynamo/interactions/intEvent.hpp>
 #include <dynamo/simulation.hpp>
 #include <dynamo/locals/local.hpp>
-#include <dynamo/ranges/IDRangeAll.hpp>
-#include <dynamo/ranges/IDRangeRange.hpp>
 #include <magnet/xmlreader.hpp>
 #include <cmath> //for huge val
 
@@ -45,21 +43,24 @@ namespace dynamo {
 	<< magnet::xml::endtag("Sorter");
   }
 
-  std::unique_ptr<IDRange>
-  SDumb::getParticleNeighbours(const Particle&) const
+  void
+  SDumb::getParticleNeighbours(const Particle&, std::vector<size_t>& retlist) const
   {
-    return std::unique_ptr<IDRange>(new IDRangeAll(Sim));
+    for (size_t id(0); id < Sim->N; ++id)
+      retlist.push_back(id);
   }
 
-  std::unique_ptr<IDRange>
-  SDumb::getParticleNeighbours(const Vector&) const
+  void
+  SDumb::getParticleNeighbours(const Vector&, std::vector<size_t>& retlist) const
   {
-    return std::unique_ptr<IDRange>(new IDRangeAll(Sim));
+    for (size_t id(0); id < Sim->N; ++id)
+      retlist.push_back(id);
   }
 
-  std::unique_ptr<IDRange>
-  SDumb::getParticleLocals(const Particle&) const
+  void
+  SDumb::getParticleLocals(const Particle&, std::vector<size_t>& retlist) const
   {
-    return std::unique_ptr<IDRange>(new IDRangeRange(0, Sim->locals.size()));
+    for (size_t id(0); id < Sim->locals.size(); ++id)
+      retlist.push_back(id);
   }
 }
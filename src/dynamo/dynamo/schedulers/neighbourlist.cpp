@@ -26,7 +26,6 @@
 #include <dynamo/globals/neighbourList.hpp>
 #include <dynamo/locals/local.hpp>
 #include <dynamo/locals/localEvent.hpp>
-#include <dynamo/ranges/IDRangeRange.hpp>
 #include <magnet/xmlreader.hpp>
 #include <boost/bind.hpp>
 #include <boost/progress.hpp>
@@ -61,7 +60,7 @@ namespace dynamo {
 		<< Sim->getLongestInteraction() / Sim->units.unitLength();
 
     nblist->markAsUsedInScheduler();
-    nblist->_sigNewNeighbour.connect<Scheduler, &Scheduler::addInteractionEvent>(this);
+    nblist->_sigNewNeighbour.connect<Scheduler, &Scheduler::addNewNeighbourEvent>(this);
     Scheduler::initialise();
   }
 
@@ -86,8 +85,8 @@ namespace dynamo {
     Scheduler(Sim,"NeighbourListScheduler", ns)
   { dout << "Neighbour List Scheduler Algorithmn Loaded" << std::endl; }
 
-  std::unique_ptr<IDRange>
-  SNeighbourList::getParticleNeighbours(const Particle& part) const
+  void
+  SNeighbourList::getParticleNeighbours(const Particle& part, std::vector<size_t>& retlist) const
   {
 #ifdef DYNAMO_DEBUG
     if (!std::dynamic_pointer_cast<GNeighbourList>(Sim->globals[NBListID]))
@@ -99,11 +98,11 @@ namespace dynamo {
 				 (Sim->globals[NBListID]
 				  .get()));
   
-    return std::unique_ptr<IDRange>(new IDRangeList(nblist.getParticleNeighbours(part)));
+    nblist.getParticleNeighbours(part, retlist);
   }
 
-  std::unique_ptr<IDRange>
-  SNeighbourList::getParticleNeighbours(const Vector& vec) const
+  void
+  SNeighbourList::getParticleNeighbours(const Vector& vec, std::vector<size_t>& retlist) const
   {
 #ifdef DYNAMO_DEBUG
     if (!std::dynamic_pointer_cast<GNeighbourList>(Sim->globals[NBListID]))
@@ -115,12 +114,13 @@ namespace dynamo {
 				 (Sim->globals[NBListID]
 				  .get()));
   
-    return std::unique_ptr<IDRange>(new IDRangeList(nblist.getParticleNeighbours(vec)));
+    nblist.getParticleNeighbours(vec, retlist);
   }
     
-  std::unique_ptr<IDRange> 
-  SNeighbourList::getParticleLocals(const Particle& part) const
+  void
+  SNeighbourList::getParticleLocals(const Particle& part, std::vector<size_t>& retlist) const
   {
-    return std::unique_ptr<IDRange>(new IDRangeRange(0, Sim->locals.size()));
+    for (size_t id(0); id < Sim->locals.size(); ++id)
+      retlist.push_back(id);
   }
 }
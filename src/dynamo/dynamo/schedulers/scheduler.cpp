@@ -18,6 +18,7 @@
 #include <dynamo/schedulers/include.hpp>
 #include <dynamo/schedulers/scheduler.hpp>
 #include <dynamo/interactions/intEvent.hpp>
+#include <dynamo/interactions/interaction.hpp>
 #include <dynamo/globals/global.hpp>
 #include <dynamo/globals/globEvent.hpp>
 #include <dynamo/locals/local.hpp>
@@ -33,7 +34,9 @@
 
 #include <magnet/xmlwriter.hpp>
 #include <magnet/xmlreader.hpp>
+#include <magnet/thread/threadpool.hpp>
 #include <boost/math/special_functions/fpclassify.hpp>
+#include <functional>
 
 namespace dynamo {
   Scheduler::Scheduler(dynamo::Simulation* const tmp, const char * aName,
@@ -41,7 +44,9 @@ namespace dynamo {
     SimBase(tmp, aName),
     sorter(nS),
     _interactionRejectionCounter(0),
-    _localRejectionCounter(0)
+    _localRejectionCounter(0),
+    _newNeighbourCount(0),
+    _skippedPredictionCount(0)
   {}
 
   Scheduler::~Scheduler() {}
@@ -56,33 +61,103 @@ namespace dynamo {
   Scheduler::initialise()
   {
     //Now, the scheduler is used to test the state of the system.
-    dout << "Checking the simulation configuration for any errors" << std::endl;
+    if (Sim->validateLevel)
+      {
+	dout << "Checking the simulation configuration for any errors" << std::endl;
+	const size_t warnings = validateState(Sim->validateLevel == 1, 101);
+
+	if (warnings > 100)
+	  derr << "Over 100 warnings of invalid states, further output was suppressed (total of " << warnings << " warnings detected)" << std::endl;
+      }
+
+    dout << "Building all events on collision " << Sim->eventCount << std::endl;
+    rebuildList();
+  }
+
+  size_t
+  Scheduler::validateState(const bool sample, const size_t max_reports, const bool allPairs) const
+  {
     size_t warnings(0);
 
     for (const auto& interaction_ptr : Sim->interactions)
-      warnings += interaction_ptr->validateState(warnings < 101, 101 - warnings);
-    
-    for (size_t id1(0); id1 < Sim->particles.size(); ++id1)
+      warnings += interaction_ptr->validateState(warnings < max_reports, max_reports - std::min(warnings, max_reports));
+
+    //When sampling, roughly this many particles are tested
+    const size_t sampleSize = 10000;
+    const size_t stride = sample ? std::max(size_t(1), Sim->N / sampleSize) : 1;
+
+    //The blocks all start on a sampled particle
+    const size_t nBlocks = Sim->threads ? 4 * std::max(size_t(1), Sim->threads->getThreadCount()) : 1;
+    const size_t blockSize = stride * ((Sim->N + nBlocks * stride - 1) / (nBlocks * stride));
+
+    std::vector<InvalidList> pairs(nBlocks), locals(nBlocks);
+    if (nBlocks > 1)
       {
-	std::unique_ptr<IDRange> ids(getParticleNeighbours(Sim->particles[id1]));
-	for (const size_t id2 : *ids)
-	  if (id2 > id1)
-	    if (Sim->getInteraction(Sim->particles[id1], Sim->particles[id2])
-		->validateState(Sim->particles[id1], Sim->particles[id2], (warnings < 101)))
-	      ++warnings;
+	for (const shared_ptr<Interaction>& interaction : Sim->interactions)
+	  interaction->prepareParallelTests();
+
+	std::vector<std::function<void()> > tasks;
+	for (size_t i(0); i < nBlocks; ++i)
+	  tasks.push_back(std::bind(&Scheduler::findInvalidStates, this, std::min(Sim->N, i * blockSize),
+				    std::min(Sim->N, (i + 1) * blockSize), stride, allPairs, std::ref(pairs[i]), std::ref(locals[i])));
+	Sim->threads->queueTasks(tasks);
+	Sim->threads->wait();
       }
-    
-    for(const Particle& part : Sim->particles)
-      for (const shared_ptr<Local>& lcl : Sim->locals)
-      if (lcl->isInteraction(part))
-	if (lcl->validateState(part, (warnings < 101)))
+    else
+      findInvalidStates(0, Sim->N, stride, allPairs, pairs[0], locals[0]);
+
+    //Now write the reports, in the same order as a serial test
+    for (const InvalidList& list : pairs)
+      for (const std::pair<size_t, size_t>& IDs : list)
+	{
+	  if (warnings < max_reports)
+	    Sim->getInteraction(Sim->particles[IDs.first], Sim->particles[IDs.second])
+	      ->validateState(Sim->particles[IDs.first], Sim->particles[IDs.second], true);
 	  ++warnings;
-    
-    if (warnings > 100)
-      derr << "Over 100 warnings of invalid states, further output was suppressed (total of " << warnings << " warnings detected)" << std::endl;
+	}
 
-    dout << "Building all events on collision " << Sim->eventCount << std::endl;
-    rebuildList();
+    for (const InvalidList& list : locals)
+      for (const std::pair<size_t, size_t>& IDs : list)
+	{
+	  if (warnings < max_reports)
+	    Sim->locals[IDs.second]->validateState(Sim->particles[IDs.first], true);
+	  ++warnings;
+	}
+
+    return warnings;
+  }
+
+  void
+  Scheduler::findInvalidStates(const size_t begin, const size_t end, const size_t stride, const bool allPairs,
+			       InvalidList& pairs, InvalidList& locals) const
+  {
+    std::vector<size_t> ids;
+    for (size_t id1(begin); id1 < end; id1 += stride)
+      {
+	const Particle& p1 = Sim->particles[id1];
+	ids.clear();
+	if (allPairs)
+	  {
+	    for (size_t id2(0); id2 < Sim->N; ++id2)
+	      if (id2 != id1) ids.push_back(id2);
+	  }
+	else
+	  getParticleNeighbours(p1, ids);
+
+	for (const size_t id2 : ids)
+	  //Each pair is tested once. When sampling, the pairs with
+	  //particles outside the sample are tested from this side.
+	  if ((id2 > id1) || (id2 % stride))
+	    {
+	      const Particle& p2 = Sim->particles[id2];
+	      if (Sim->getInteraction(p1, p2)->validateState(p1, p2, false))
+		pairs.push_back(std::make_pair(id1, id2));
+	    }
+
+	for (size_t lID(0); lID < Sim->locals.size(); ++lID)
+	  if (Sim->locals[lID]->isInteraction(p1) && Sim->locals[lID]->validateState(p1, false))
+	    locals.push_back(std::make_pair(id1, lID));
+      }
   }
 
   void
@@ -94,8 +169,34 @@ namespace dynamo {
     eventCount.clear();
     eventCount.resize(Sim->N+1, 0);
 
-    for (Particle& part : Sim->particles)
-      addEvents(part);
+    if (Sim->threads)
+      {
+	//The particles are first brought up to date, then the events
+	//are predicted. The predictions only read the particle data
+	//and each particle's events are pushed to its own PEL, so the
+	//blocks of particles are independent in both passes.
+	const size_t nBlocks = 4 * std::max(size_t(1), Sim->threads->getThreadCount());
+	const size_t blockSize = (Sim->N + nBlocks - 1) / nBlocks;
+
+	std::vector<std::function<void()> > updates, predictions;
+	for (size_t i(0); i < nBlocks; ++i)
+	  {
+	    const size_t begin = std::min(Sim->N, i * blockSize), end = std::min(Sim->N, (i + 1) * blockSize);
+	    updates.push_back(std::bind(&Scheduler::updateParticles, this, begin, end));
+	    predictions.push_back(std::bind(&Scheduler::predictEvents, this, begin, end));
+	  }
+
+	for (const shared_ptr<Interaction>& interaction : Sim->interactions)
+	  interaction->prepareParallelTests();
+
+	Sim->threads->queueTasks(updates);
+	Sim->threads->wait();
+	Sim->threads->queueTasks(predictions);
+	Sim->threads->wait();
+      }
+    else
+      for (Particle& part : Sim->particles)
+	addEvents(part);
   
     sorter->init();
 
@@ -107,22 +208,46 @@ namespace dynamo {
   Scheduler::addEvents(Particle& part)
   {  
     Sim->dynamics->updateParticle(part);
+    addEvents(part, _idBuffer, true);
+  }
 
+  void
+  Scheduler::addEvents(const Particle& part, std::vector<size_t>& ids, const bool updateNeighbours) const
+  {
     //Add the global events
     for (const shared_ptr<Global>& glob : Sim->globals)
       if (glob->isInteraction(part))
 	sorter->push(glob->getEvent(part), part.getID());
   
     //Add the local cell events
-    std::unique_ptr<IDRange> ids(getParticleLocals(part));
-    
-    for (const size_t id2 : *ids)
+    ids.clear();
+    getParticleLocals(part, ids);
+    for (const size_t id2 : ids)
       addLocalEvent(part, id2);
 
     //Now add the interaction events
-    ids = getParticleNeighbours(part);
-    for (const size_t id2 : *ids)
-      addInteractionEvent(part, id2);
+    ids.clear();
+    getParticleNeighbours(part, ids);
+    for (const size_t id2 : ids)
+      if (updateNeighbours)
+	addInteractionEvent(part, id2);
+      else
+	pushInteractionEvent(part, id2);
+  }
+
+  void
+  Scheduler::updateParticles(const size_t begin, const size_t end) const
+  {
+    for (size_t id(begin); id < end; ++id)
+      Sim->dynamics->updateParticle(Sim->particles[id]);
+  }
+
+  void
+  Scheduler::predictEvents(const size_t begin, const size_t end) const
+  {
+    std::vector<size_t> ids;
+    for (size_t id(begin); id < end; ++id)
+      addEvents(Sim->particles[id], ids, false);
   }
 
   shared_ptr<Scheduler>
@@ -402,11 +527,40 @@ namespace dynamo {
 				 const size_t& id) const
   {
     if (part.getID() == id) return;
-    Particle& part1(Sim->particles[part.getID()]);
-    Particle& part2(Sim->particles[id]);
+    Sim->dynamics->updateParticle(Sim->particles[id]);
+    pushInteractionEvent(part, id);
+  }
 
+  void
+  Scheduler::addNewNeighbourEvent(const Particle& part, 
+				  const size_t& id) const
+  {
+    if (part.getID() == id) return;
+    const Particle& part1(Sim->particles[part.getID()]);
+    Particle& part2(Sim->particles[id]);
     Sim->dynamics->updateParticle(part2);
 
+    ++_newNeighbourCount;
+    const shared_ptr<Interaction>& interaction = Sim->getInteraction(part1, part2);
+    if (Sim->dynamics->pairNeverApproaches(part1, part2, interaction->maxIntDist()))
+      {
+	++_skippedPredictionCount;
+	return;
+      }
+
+    const IntEvent& eevent(interaction->getEvent(part1, part2));
+
+    if (eevent.getType() != NONE)
+      sorter->push(Event(eevent, eventCount[id]), part1.getID());
+  }
+
+  void
+  Scheduler::pushInteractionEvent(const Particle& part, const size_t id) const
+  {
+    if (part.getID() == id) return;
+    const Particle& part1(Sim->particles[part.getID()]);
+    const Particle& part2(Sim->particles[id]);
+
     const IntEvent& eevent(Sim->getEvent(part1, part2));
 
     if (eevent.getType() != NONE)
@@ -425,7 +579,11 @@ namespace dynamo {
   Scheduler::lazyDeletionCleanup()
   {
     std::pair<size_t, Event> next_event = sorter->next();
-    while ((next_event.second.type == INTERACTION) && (next_event.second.collCounter2 != eventCount[next_event.second.particle2ID]))
+    //Only the lower 32 bits of the event counters are compared, as
+    //this is all that compact PEL's (e.g., PELCompact) store.
+    while ((next_event.second.type == INTERACTION) 
+	   && (static_cast<uint32_t>(next_event.second.collCounter2) 
+	       != static_cast<uint32_t>(eventCount[next_event.second.particle2ID])))
       {
 	//Not valid, update the list
 	sorter->popNextEvent();
@@ -21,7 +21,7 @@
 #include <dynamo/interactions/intEvent.hpp>
 #include <dynamo/globals/globEvent.hpp>
 #include <magnet/function/delegate.hpp>
-#include <dynamo/ranges/IDRange.hpp>
+#include <limits>
 #include <memory>
 #include <vector>
 
@@ -41,6 +41,26 @@ namespace dynamo {
     virtual void initialise();
 
     void rebuildList();
+
+    /*! \brief Checks the configuration for invalid states (e.g.,
+        overlapping particles), writing a report of each one found.
+
+      The pairs of particles tested are taken from
+      getParticleNeighbours, unless allPairs is set. If the
+      Simulation has a ThreadPool, the particles are tested in
+      parallel, but the reports are still written in particle order.
+
+      \param sample If true, only a sample of the particles (and
+      their neighbours) are tested.
+      \param max_reports The maximum number of invalid states to
+      write reports for.
+      \param allPairs If true, every pair of particles is tested
+      (O(N^2)), so states which the neighbour list cannot see are
+      also found.
+      \return The number of invalid states found.
+     */
+    size_t validateState(bool sample = false, size_t max_reports = std::numeric_limits<size_t>::max(),
+			 bool allPairs = false) const;
   
     /*! \brief Retest for events for a single particle.
      */
@@ -99,16 +119,81 @@ namespace dynamo {
     void rebuildSystemEvents() const;
 
     void addInteractionEvent(const Particle&, const size_t&) const;
+
+    /*! \brief Adds the interaction event between a particle and a
+        particle which has just entered its neighbourhood.
+
+	Unlike addInteractionEvent(), the prediction is skipped if the
+	Dynamics can cheaply show that the pair will never come within
+	range of its interaction.
+     */
+    void addNewNeighbourEvent(const Particle&, const size_t&) const;
+
+    //! \brief The number of new neighbours passed to addNewNeighbourEvent().
+    size_t getNewNeighbourCount() const { return _newNeighbourCount; }
+
+    //! \brief The number of new neighbours whose event prediction was skipped.
+    size_t getSkippedPredictionCount() const { return _skippedPredictionCount; }
     
     void addLocalEvent(const Particle&, const size_t&) const;
 
-    virtual std::unique_ptr<IDRange> getParticleNeighbours(const Particle&) const = 0;
-    virtual std::unique_ptr<IDRange> getParticleNeighbours(const Vector&) const = 0;
-    virtual std::unique_ptr<IDRange> getParticleLocals(const Particle&) const = 0;
+    /*! \brief Appends the IDs of the particles which may interact
+        with the passed particle to the list.
+
+	The list is not cleared first, so callers can reuse the same
+	list (and its capacity) across many calls.
+     */
+    virtual void getParticleNeighbours(const Particle&, std::vector<size_t>&) const = 0;
+
+    /*! \brief Appends the IDs of the particles which may interact
+        with a particle at the passed position to the list.
+     */
+    virtual void getParticleNeighbours(const Vector&, std::vector<size_t>&) const = 0;
+
+    /*! \brief Appends the IDs of the Local's which may interact with
+        the passed particle to the list.
+     */
+    virtual void getParticleLocals(const Particle&, std::vector<size_t>&) const = 0;
     
     const std::vector<size_t>& getEventCounts() const { return eventCount; }
 
   protected:
+    typedef std::vector<std::pair<size_t, size_t> > InvalidList;
+
+    /*! \brief Tests the particles begin, begin + stride, ... < end
+        for invalid states, without writing any reports.
+
+      \param allPairs If true, each particle is tested against every
+      other particle instead of its neighbours.
+      \param pairs The ID pairs of the particles with an invalid
+      interaction state are appended here.
+      \param locals The particle and Local IDs with an invalid state
+      are appended here.
+     */
+    void findInvalidStates(size_t begin, size_t end, size_t stride, bool allPairs, InvalidList& pairs, InvalidList& locals) const;
+
+    /*! \brief Adds the events of an up to date particle.
+
+      \param ids A buffer for the neighbour and local IDs.
+      \param updateNeighbours If false, the neighbours of the
+      particle must already be up to date. Otherwise they are
+      updated as they are tested.
+     */
+    void addEvents(const Particle& part, std::vector<size_t>& ids, bool updateNeighbours) const;
+
+    /*! \brief Adds the interaction event between a particle and a
+        neighbour which are both already up to date.
+     */
+    void pushInteractionEvent(const Particle& part, size_t id) const;
+
+    //! \brief Brings the particles in [begin, end) up to date.
+    void updateParticles(size_t begin, size_t end) const;
+
+    /*! \brief Adds the events of the particles in [begin, end),
+        once every particle is up to date.
+     */
+    void predictEvents(size_t begin, size_t end) const;
+
     /*! \brief Performs the lazy deletion algorithm to find the next
      * valid event in the queue.
      *
@@ -120,10 +205,16 @@ namespace dynamo {
 
     mutable shared_ptr<FEL> sorter;
     mutable std::vector<size_t> eventCount;
+
+    //! \brief A reusable list for the IDs visited in addEvents().
+    std::vector<size_t> _idBuffer;
   
     size_t _interactionRejectionCounter;
     size_t _localRejectionCounter;
 
+    mutable size_t _newNeighbourCount;
+    mutable size_t _skippedPredictionCount;
+
     virtual void outputXML(magnet::xml::XmlStream&) const = 0;
   };
 }
@@ -37,6 +37,9 @@ namespace dynamo {
 
   class PELSingleEvent;
 
+  template<size_t Size>
+  class PELCompact;
+
   template<class T> struct FELBoundedPQName;
 
   template<>
@@ -51,6 +54,12 @@ namespace dynamo {
     inline static std::string name() { return std::string("BoundedPQMinMax") + boost::lexical_cast<std::string>(I); }
   };
 
+  template<size_t I>
+  struct FELBoundedPQName<PELCompact<I> >
+  {
+    inline static std::string name() { return std::string("BoundedPQCompact") + boost::lexical_cast<std::string>(I); }
+  };
+
   template<>
   struct FELBoundedPQName<PELSingleEvent>
   {
@@ -0,0 +1,617 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <dynamo/schedulers/sorters/event.hpp>
+#include <dynamo/schedulers/sorters/sorter.hpp>
+#include <dynamo/schedulers/sorters/heapPEL.hpp>
+#include <magnet/exception.hpp>
+#include <magnet/xmlwriter.hpp>
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <iostream>
+
+#ifdef DYNAMO_DEBUG
+#include <boost/math/special_functions/fpclassify.hpp>
+#endif
+
+namespace dynamo {
+  /*! \brief A calendar queue Future Event List which never restreams
+      its Particle Event Lists when the calendar wraps.
+
+      This sorter has the same structure as FELBoundedPQ: each PEL is
+      placed in a linked list for the calendar "day" of its next
+      event, and only the PELs of the current day are sorted in a
+      complete binary tree. The differences are in how time is
+      represented.
+
+      FELBoundedPQ stores event times relative to the start of the
+      current calendar "year" and must stream every PEL (O(N)) each
+      time the calendar wraps. Here, the PELs store their times
+      relative to an epoch origin. Days are absolute (monotonically
+      increasing) integers, so a wrap is just the bucket index
+      returning to zero. The epoch origin is advanced once a year to
+      bound the round-off of the stored times. PELs are moved over to
+      the new epoch a few at a time as the calendar advances, so no
+      single step has to touch every particle.
+
+      The overflow list, which holds the PELs whose events lie beyond
+      the current year, is also swept incrementally instead of all at
+      once on each wrap.
+
+      Finally, the day width is retuned from the observed number of
+      events sorted per day. A new width only takes effect for days
+      beyond the current calendar window. Every PEL already sitting in
+      a day stays correctly placed, so no rebuild() is needed.
+   */
+  class FELCalendarQueue: public FEL
+  {
+  private:
+    struct eventQEntry
+    {
+      eventQEntry(): next(-1), previous(-1), qIndex(-1), epoch(0) {}
+
+      PELHeap data;
+      int next;
+      int previous;
+      int qIndex;
+      size_t epoch;
+    };
+
+    //Calendar variables
+    std::vector<int> linearLists;
+    int nlists;
+    int currentIndex;
+    long long currentDay;
+
+    //The mapping from (epoch) time to calendar days
+    double _width;
+    double _originTime;
+    long long _originDay;
+
+    //A day width change scheduled for the days outside the current
+    //calendar window.
+    bool _switchPending;
+    double _nextWidth;
+    double _nextOriginTime;
+    long long _nextOriginDay;
+
+    //The epoch representation of the event times. An event time in
+    //the current epoch is the stored time plus the _epochShift of
+    //the epoch the PEL was stored in.
+    double pecTime;
+    size_t _epoch;
+    double _epochShift[2];
+    size_t _migrateIndex;
+    size_t _migrateChunk;
+
+    //The number of PELs waiting in the days of the calendar window
+    size_t _dayCount;
+
+    //Incremental sweeping of the overflow list
+    size_t _overflowCount;
+    int _sweepCursor;
+    size_t _sweepChunk;
+
+    //Bucket width tuning statistics
+    size_t _yearInserts;
+    size_t _emptyDays;
+
+    //Binary tree variables
+    std::vector<unsigned long> CBT;
+    std::vector<unsigned long> Leaf;
+    std::vector<eventQEntry> Min;
+    size_t NP, N;
+
+  public:
+    FELCalendarQueue() { clear(); }
+
+    void resize(const size_t& a)
+    {
+      clear();
+      N = a;
+      CBT.resize(2 * N);
+      Leaf.resize(N + 1);
+      Min.resize(N + 1);
+    }
+
+    void clear()
+    {
+      Min.clear();
+      CBT.clear();
+      Leaf.clear();
+      linearLists.clear();
+      N = 0;
+      NP = 0;
+      nlists = 0;
+      currentIndex = 0;
+      currentDay = 0;
+      pecTime = 0.0;
+      _width = 1.0;
+      _originTime = 0.0;
+      _originDay = 0;
+      _switchPending = false;
+      _nextWidth = 1.0;
+      _nextOriginTime = 0.0;
+      _nextOriginDay = 0;
+      _epoch = 0;
+      _epochShift[0] = _epochShift[1] = 0.0;
+      _migrateIndex = 0;
+      _migrateChunk = 1;
+      _dayCount = 0;
+      _overflowCount = 0;
+      _sweepCursor = -1;
+      _sweepChunk = 1;
+      _yearInserts = 0;
+      _emptyDays = 0;
+    }
+
+    inline void stream(const double& ndt) { pecTime += ndt; }
+
+    void init() { init(false); }
+
+    void rebuild() { init(true); }
+
+    void init(bool quiet)
+    {
+      NP = 0;
+
+      //Bring every PEL into the current epoch
+      for (size_t i(1); i <= N; ++i)
+	migrate(i);
+      _migrateIndex = N + 1;
+
+      //Determine the day width and number of days by instrumenting
+      //the queue, the same way as FELBoundedPQ
+      double minVal(0), maxVal(-HUGE_VAL);
+      size_t counter(0);
+      for (size_t i(1); i <= N; ++i)
+	{
+	  const double dt = Min[i].data.getdt() - pecTime;
+	  if (!std::isinf(dt))
+	    {
+	      minVal = std::min(minVal, dt);
+	      maxVal = std::max(maxVal, dt);
+	      ++counter;
+	    }
+	}
+
+      if (counter < 10)
+	{
+	  std::cerr <<
+	    "The event queue doesn't have more than 10 VALID events in it"
+	    "\nThis means the queue cannot be instrumented properly to"
+	    "\ndetermine the optimal settings for the calendar queue, now"
+	    "\nusing some (probably inefficient) defaults."
+	    "\nIf this is a proper simulation, consider using a different Sorter (e.g., CBT)."
+		    << std::endl;
+	  _width = 0.1;
+	  nlists = 1000;
+	}
+      else
+	{
+	  if (maxVal < 0 )
+	    std::cerr << "WARNING! The event queue is filled with negative events!"
+		      << std::endl;
+
+	  _width = (maxVal - minVal) / counter;
+	  nlists = Min.size();
+	}
+
+      if (!(_width > 0) || std::isinf(_width))
+	M_throw() << "The day width for the calendar queue is invalid (" << _width
+		  << "). May be caused by only having zero time, or a large number of negative time events.";
+
+      if (!quiet)
+	std::cout << "Length of calendar = " << nlists
+		  << " Day width = " << _width
+		  << std::endl;
+
+      linearLists.clear();
+      linearLists.resize(nlists + 1, -1); /*+1 for overflow, -1 for
+					    marking empty*/
+
+      currentDay = 0;
+      currentIndex = 0;
+      _originTime = pecTime;
+      _originDay = 0;
+      _switchPending = false;
+      _dayCount = 0;
+      _overflowCount = 0;
+      _sweepCursor = -1;
+      _sweepChunk = 1;
+      _yearInserts = 0;
+      _emptyDays = 0;
+      _migrateChunk = N / nlists + 1;
+
+      for (size_t i = 1; i <= N; i++)
+	insertInEventQ(i);
+
+      orderNextEvent();
+    }
+
+    inline void push(const Event& tmpVal, const size_t& pID)
+    {
+#ifdef DYNAMO_DEBUG
+      if (boost::math::isnan(tmpVal.dt))
+	M_throw() << "NaN value pushed into the sorter! Should be Inf I guess?";
+#endif
+      migrate(pID + 1);
+      tmpVal.dt += pecTime;
+      Min[pID + 1].data.push(tmpVal);
+    }
+
+    inline void update(const size_t& pID)
+    {
+      deleteFromEventQ(pID + 1);
+      insertInEventQ(pID + 1);
+    }
+
+    inline void clearPEL(const size_t& ID)
+    {
+      Min[ID+1].data.clear();
+      Min[ID+1].epoch = _epoch;
+    }
+
+    inline void popNextPELEvent(const size_t& ID) { Min[ID+1].data.pop(); }
+    inline void popNextEvent() { Min[CBT[1]].data.pop(); }
+    virtual bool empty() const { return Min[CBT[1]].data.empty(); }
+
+    virtual std::pair<size_t, Event> next() const
+    {
+      Event nextevent = Min[CBT[1]].data.top();
+      nextevent.dt += _epochShift[Min[CBT[1]].epoch & 1] - pecTime;
+      return std::pair<size_t, Event>(CBT[1] - 1, nextevent);
+    }
+
+    inline void sort() { orderNextEvent(); }
+
+    inline void rescaleTimes(const double& factor)
+    {
+      for (eventQEntry& dat : Min)
+	dat.data.rescaleTimes(factor);
+
+      pecTime *= factor;
+      _epochShift[0] *= factor;
+      _epochShift[1] *= factor;
+      _width *= factor;
+      _originTime *= factor;
+      _nextWidth *= factor;
+      _nextOriginTime *= factor;
+    }
+
+  private:
+    /*! \brief The time of the next event of a PEL in the current
+        epoch.
+     */
+    inline double getTime(const int& p) const
+    { return Min[p].data.getdt() + _epochShift[Min[p].epoch & 1]; }
+
+    /*! \brief Move the stored times of a PEL into the current epoch.
+
+      This does not change the ordering of the PELs.
+     */
+    inline void migrate(const size_t& p)
+    {
+      if (Min[p].epoch == _epoch) return;
+      Min[p].data.stream(-_epochShift[Min[p].epoch & 1]);
+      Min[p].epoch = _epoch;
+    }
+
+    /*! \brief Determine the calendar day of an event time, relative
+        to the current day.
+
+	Returns the number of days ahead of the current day, which is
+	negative if the event is due before the current day, and may
+	be infinite.
+     */
+    inline double daysAhead(const double& t) const
+    {
+      if (_switchPending && (t >= _nextOriginTime))
+	return std::floor((t - _nextOriginTime) / _nextWidth) + (_nextOriginDay - currentDay);
+
+      double day = std::floor((t - _originTime) / _width) + (_originDay - currentDay);
+      //Guard against round-off placing the event in the new segment
+      if (_switchPending)
+	day = std::min(day, double(_nextOriginDay - currentDay - 1));
+      return day;
+    }
+
+    ///////////////////////////CALENDAR QUEUE IMPLEMENTATION
+    inline void insertInEventQ(int p)
+    {
+      const double ahead = daysAhead(getTime(p));
+
+      int i;
+      if (!(ahead < nlists)) //Also catches NaN's
+	i = nlists; //Put this in the overflow list
+      else
+	//This line makes negative time events possible
+	i = (ahead > 0) ? static_cast<int>((currentDay + static_cast<long long>(ahead)) % nlists) : currentIndex;
+
+      Min[p].qIndex = i;
+
+      if (i == currentIndex)
+	{
+	  ++_yearInserts;
+	  Insert(p); /* insert in PQ */
+	}
+      else
+	{
+	  /* insert in linked list */
+	  int oldFirst = linearLists[i];
+	  Min[p].previous = -1;
+	  Min[p].next = oldFirst;
+	  linearLists[i] = p;
+	  if (oldFirst != -1)
+	    Min[oldFirst].previous = p;
+	  if (i == nlists)
+	    ++_overflowCount;
+	  else
+	    ++_dayCount;
+	}
+    }
+
+    inline void deleteFromEventQ(const int& e)
+    {
+      if (Min[e].qIndex == currentIndex)
+	Delete(e); /* delete from pq */
+      else
+	{
+	  if (Min[e].qIndex == nlists)
+	    {
+	      --_overflowCount;
+	      if (_sweepCursor == e) _sweepCursor = Min[e].next;
+	    }
+	  else
+	    --_dayCount;
+
+	  /* remove from linked list */
+	  int prev = Min[e].previous,
+	    next = Min[e].next;
+	  if (prev == -1)
+	    linearLists[Min[e].qIndex] = next;
+	  else
+	    Min[prev].next = next;
+
+	  if (next != -1)
+	    Min[next].previous = prev;
+	}
+    }
+
+    /*! \brief Re-files a bounded number of PELs from the overflow
+        list.
+
+	The sweep chunk is chosen so that the entire overflow list is
+	visited at least every nlists/4 days. PELs are re-filed at the
+	head of the overflow list, behind the sweep cursor, so every
+	PEL is always examined well before its event enters the
+	calendar window.
+     */
+    inline void sweepOverflow()
+    {
+      if (_sweepCursor == -1)
+	{
+	  //Begin a new sweep of the overflow list
+	  _sweepCursor = linearLists[nlists];
+	  _sweepChunk = (4 * _overflowCount) / nlists + 1;
+	}
+
+      for (size_t n(0); (n < _sweepChunk) && (_sweepCursor != -1); ++n)
+	{
+	  const int e = _sweepCursor;
+	  deleteFromEventQ(e);
+	  insertInEventQ(e);
+	}
+    }
+
+    /*! \brief Called when the calendar returns to its first day.
+
+	This is the point at which the day width is retuned and the
+	epoch origin is advanced, neither of which requires touching
+	all of the PELs.
+     */
+    inline void newYear()
+    {
+      //Retune the day width from the number of PELs sorted per
+      //day. The aim is for about one PEL to be sorted by the binary
+      //tree each day.
+      if (!_switchPending && _yearInserts)
+	{
+	  const double perDay = double(_yearInserts) / nlists;
+	  if ((perDay > 4) || (perDay < 0.25))
+	    {
+	      _switchPending = true;
+	      _nextWidth = _width / std::min(16.0, std::max(1.0 / 16, perDay));
+	      _nextOriginDay = currentDay + nlists;
+	      _nextOriginTime = _originTime + (_nextOriginDay - _originDay) * _width;
+	    }
+	}
+      _yearInserts = 0;
+
+      //Advance the epoch once all PELs have migrated to the current
+      //one, the stored times of the PELs then remain bounded by a few
+      //calendar years.
+      if (_migrateIndex > N)
+	{
+	  const double delta = pecTime;
+	  ++_epoch;
+	  _epochShift[_epoch & 1] = 0;
+	  _epochShift[(_epoch - 1) & 1] = -delta;
+	  pecTime -= delta;
+	  _originTime -= delta;
+	  _nextOriginTime -= delta;
+	  _migrateIndex = 1;
+	}
+    }
+
+    /*! \brief Moves the calendar onto a later day, used if the
+        calendar window has been empty for a full year.
+
+	All of the PELs are then in the overflow list.
+     */
+    inline void jumpToOverflow()
+    {
+      double tmin = HUGE_VAL;
+      for (int e = linearLists[nlists]; e != -1; e = Min[e].next)
+	tmin = std::min(tmin, getTime(e));
+
+      if (std::isinf(tmin))
+	M_throw() << "The calendar queue has run out of events";
+
+      //All other days are empty, so the calendar can be restarted on
+      //the next day
+      _switchPending = false;
+      _originDay = currentDay + 1;
+      _originTime = tmin;
+      _emptyDays = 0;
+      _sweepCursor = -1;
+
+      int e = linearLists[nlists];
+      linearLists[nlists] = -1;
+      _overflowCount = 0;
+      while (e != -1)
+	{
+	  int eNext = Min[e].next;
+	  insertInEventQ(e);
+	  e = eNext;
+	}
+    }
+
+    inline void orderNextEvent()
+    {
+      while (NP == 0)
+	{
+	  /*The current priority queue is exhausted, move on to the
+	    next day*/
+	  ++currentDay;
+	  currentIndex = currentDay % nlists;
+
+	  if (_switchPending && (currentDay == _nextOriginDay))
+	    {
+	      _switchPending = false;
+	      _width = _nextWidth;
+	      _originDay = _nextOriginDay;
+	      _originTime = _nextOriginTime;
+	    }
+
+	  if (!currentIndex) newYear();
+
+	  for (size_t n(0); (n < _migrateChunk) && (_migrateIndex <= N); ++n)
+	    migrate(_migrateIndex++);
+
+	  sweepOverflow();
+
+	  /* populate pq */
+	  for (int e = linearLists[currentIndex]; e != -1; e = Min[e].next)
+	    {
+	      ++_yearInserts;
+	      --_dayCount;
+	      Insert(e);
+	    }
+
+	  linearLists[currentIndex] = -1;
+
+	  //The sweep of the overflow list may have filed PELs into the
+	  //calendar window, so the window is only empty if no PELs are
+	  //waiting in its days
+	  if (NP || _dayCount)
+	    _emptyDays = 0;
+	  else if ((++_emptyDays > size_t(nlists)) && _overflowCount)
+	    jumpToOverflow();
+	}
+    }
+
+    ///////////////////////////BINARY TREE IMPLEMENTATION
+    inline void UpdateCBT(const unsigned int& i)
+    {
+      unsigned int f = Leaf[i] / 2;
+
+      for(; (f > 0) && (CBT[f] == i); f /= 2)
+	{
+	  unsigned int l = CBT[f*2],
+	    r = CBT[f*2+1];
+	  CBT[f] = (getTime(r) > getTime(l)) ? l : r;
+	}
+
+      //Walk up finding the winners till it doesn't change or you hit
+      //the top of the tree
+      for( ; f>0; f /= 2)
+	{
+	  unsigned int w = CBT[f], /* old winner */
+	    l = CBT[f*2],
+	    r = CBT[f*2+1];
+
+	  CBT[f] = (getTime(r) > getTime(l)) ? l : r;
+
+	  if (CBT[f] == w) return; /* end of the event time comparisons */
+	}
+    }
+
+    inline void Insert(const unsigned int& i)
+    {
+      if (NP)
+	{
+	  int j = CBT[NP];
+	  CBT [NP*2] = j;
+	  CBT [NP*2+1] = i;
+	  Leaf[j] = NP*2;
+	  Leaf[i]= NP*2+1;
+	  ++NP;
+	  UpdateCBT(j);
+	}
+      else
+	{
+	  CBT[1]=i;
+	  ++NP;
+	}
+    }
+
+    inline void Delete(const unsigned int& i)
+    {
+      if (NP < 2) { CBT[1]=0; Leaf[0]=1; --NP; return; }
+
+      int l = NP * 2 - 1;
+
+      if (CBT[l-1] == i)
+	{
+	  Leaf[CBT[l]] = l/2;
+	  CBT[l/2] =CBT[l];
+	  UpdateCBT(CBT[l]);
+	  --NP;
+	  return;
+	}
+
+      Leaf[CBT[l-1]] = l/2;
+      CBT[l/2] = CBT[l-1];
+      UpdateCBT(CBT[l-1]);
+
+      if (CBT[l] != i)
+	{
+	  CBT[Leaf[i]] = CBT[l];
+	  Leaf[CBT[l]] = Leaf[i];
+	  UpdateCBT(CBT[l]);
+	}
+
+      --NP;
+    }
+
+    virtual void outputXML(magnet::xml::XmlStream& XML) const
+    { XML << magnet::xml::attr("Type") << "CalendarQueue"; }
+  };
+}
@@ -0,0 +1,203 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <dynamo/schedulers/sorters/event.hpp>
+#include <magnet/exception.hpp>
+#include <vector>
+#include <limits>
+#include <cstdint>
+#include <cmath>
+
+namespace dynamo {
+  /*! \brief A 16 byte encoding of an Event, used by PELCompact.
+
+    The partner/local/global/system ID is stored in 27 bits and the
+    event type in 5 bits. The collision counter only keeps its lower
+    32 bits, which is all the Scheduler compares when lazily deleting
+    events (see Scheduler::lazyDeletionCleanup()).
+   */
+  struct PELCompactEvent
+  {
+    static const uint32_t IDMask = (uint32_t(1) << 27) - 1;
+
+    inline PELCompactEvent() {}
+
+    inline PELCompactEvent(const Event& e):
+      dt(e.dt),
+      collCounter2(static_cast<uint32_t>(e.collCounter2)),
+      ID((e.extraID == std::numeric_limits<size_t>::max()) ? IDMask : static_cast<uint32_t>(e.extraID)),
+      type(e.type)
+    {
+      if ((e.extraID >= IDMask) && (e.extraID != std::numeric_limits<size_t>::max()))
+	M_throw() << "The ID " << e.extraID << " is too large for the compact event encoding of the PELCompact Particle Event List, please use another Sorter type.";
+    }
+
+    inline Event decode() const
+    {
+      return Event(dt, static_cast<EEventType>(type),
+		   (ID == IDMask) ? std::numeric_limits<size_t>::max() : ID,
+		   collCounter2);
+    }
+
+    double dt;
+    uint32_t collCounter2;
+    uint32_t ID : 27;
+    uint32_t type : 5;
+  };
+
+  static_assert(sizeof(PELCompactEvent) == 16, "PELCompactEvent is not compact");
+
+  /*! \brief A Particle Event List with a fixed inline capacity,
+      which spills into an overflow buffer if it fills.
+
+    When stored in the FELBoundedPQ, the inline event storage of all
+    the PEL's lies in a single contiguous slab of memory, and events
+    are stored in the compact 16 byte PELCompactEvent form. Unlike the
+    PELMinMax, no events are discarded when the inline storage is
+    full. The overflow buffer retains its capacity when cleared so,
+    once the simulation has reached a steady state, pushing and
+    popping events performs no heap allocations.
+
+    The earliest event is always kept in the first slot so that
+    getdt() and the comparisons used by the sorters are O(1). Popping
+    an event is a linear search over the remaining events, which is
+    cheap for the small PEL sizes this is designed for.
+   */
+  template<size_t Size>
+  class PELCompact
+  {
+    static_assert(Size > 0, "PELCompact must have some inline storage");
+    static_assert(FINAL_ENUM_TO_CATCH_THE_COMMA < 32, "The event types no longer fit in PELCompactEvent");
+
+    PELCompactEvent _events[Size];
+    size_t _count;
+    std::vector<PELCompactEvent> _overflow;
+
+  public:
+    PELCompact(): _count(0) {}
+
+    inline size_t size() const { return _count + _overflow.size(); }
+    inline bool empty() const { return !_count; }
+
+    inline Event top() const { return _events[0].decode(); }
+
+    inline double getdt() const { return _count ? _events[0].dt : HUGE_VAL; }
+
+    inline void clear()
+    {
+      _count = 0;
+      //This does not release the capacity of the overflow buffer
+      _overflow.clear();
+    }
+
+    inline void push(const Event& e)
+    {
+      PELCompactEvent ce(e);
+
+      if (_count < Size)
+	{
+	  _events[_count] = ce;
+	  if (ce.dt < _events[0].dt)
+	    std::swap(_events[0], _events[_count]);
+	  ++_count;
+	  return;
+	}
+
+      //Inline storage is full, spill the later of the two events
+      if (ce.dt < _events[0].dt)
+	std::swap(ce, _events[0]);
+      _overflow.push_back(ce);
+    }
+
+    inline void pop()
+    {
+      if ((_count < 2) && _overflow.empty()) { _count = 0; return; }
+
+      //Find the next earliest event
+      size_t minIndex = 1;
+      for (size_t i(2); i < _count; ++i)
+	if (_events[i].dt < _events[minIndex].dt)
+	  minIndex = i;
+
+      size_t overflowIndex = _overflow.size();
+      for (size_t i(0); i < _overflow.size(); ++i)
+	if (((minIndex >= _count) || (_overflow[i].dt < _events[minIndex].dt))
+	    && ((overflowIndex == _overflow.size()) || (_overflow[i].dt < _overflow[overflowIndex].dt)))
+	  overflowIndex = i;
+
+      if (overflowIndex != _overflow.size())
+	{
+	  //The next event is in the overflow buffer
+	  _events[0] = _overflow[overflowIndex];
+	  _overflow[overflowIndex] = _overflow.back();
+	  _overflow.pop_back();
+	  return;
+	}
+
+      if (minIndex < _count)
+	_events[0] = _events[minIndex];
+
+      //Fill the hole left in the inline storage
+      if (!_overflow.empty())
+	{
+	  _events[minIndex] = _overflow.back();
+	  _overflow.pop_back();
+	}
+      else
+	{
+	  _events[minIndex] = _events[_count - 1];
+	  --_count;
+	}
+    }
+
+    inline bool operator> (const PELCompact& ip) const { return getdt() > ip.getdt(); }
+
+    inline bool operator< (const PELCompact& ip) const { return getdt() < ip.getdt(); }
+
+    inline void stream(const double& ndt)
+    {
+      for (size_t i(0); i < _count; ++i)
+	_events[i].dt -= ndt;
+      for (PELCompactEvent& e : _overflow)
+	e.dt -= ndt;
+    }
+
+    inline void rescaleTimes(const double& scale)
+    {
+      for (size_t i(0); i < _count; ++i)
+	_events[i].dt *= scale;
+      for (PELCompactEvent& e : _overflow)
+	e.dt *= scale;
+    }
+
+    inline void swap(PELCompact& rhs)
+    {
+      std::swap(_events, rhs._events);
+      std::swap(_count, rhs._count);
+      _overflow.swap(rhs._overflow);
+    }
+  };
+}
+
+namespace std
+{
+  /*! \brief Template specialisation of the std::swap function for PELCompact*/
+  template<size_t Size>
+  void swap(dynamo::PELCompact<Size>& lhs, dynamo::PELCompact<Size>& rhs)
+  { lhs.swap(rhs); }
+}
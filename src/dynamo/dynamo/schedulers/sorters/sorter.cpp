@@ -42,8 +42,16 @@ namespace dynamo {
       return shared_ptr<FEL>(new FELBoundedPQ<PELMinMax<7> >());
     if (std::string(XML.getAttribute("Type")) == FELBoundedPQName<PELMinMax<8> >::name())
       return shared_ptr<FEL>(new FELBoundedPQ<PELMinMax<8> >());
+    if (std::string(XML.getAttribute("Type")) == FELBoundedPQName<PELCompact<4> >::name())
+      return shared_ptr<FEL>(new FELBoundedPQ<PELCompact<4> >());
+    if (std::string(XML.getAttribute("Type")) == FELBoundedPQName<PELCompact<8> >::name())
+      return shared_ptr<FEL>(new FELBoundedPQ<PELCompact<8> >());
+    if (std::string(XML.getAttribute("Type")) == FELBoundedPQName<PELCompact<16> >::name())
+      return shared_ptr<FEL>(new FELBoundedPQ<PELCompact<16> >());
     else if (std::string(XML.getAttribute("Type")) == std::string("CBT"))
       return shared_ptr<FEL>(new FELCBT());
+    else if (std::string(XML.getAttribute("Type")) == std::string("CalendarQueue"))
+      return shared_ptr<FEL>(new FELCalendarQueue());
     else 
       M_throw() << "Unknown type of Sorter encountered";
   }
@@ -18,7 +18,6 @@
 #include <dynamo/schedulers/systemonly.hpp>
 #include <dynamo/interactions/intEvent.hpp>
 #include <dynamo/simulation.hpp>
-#include <dynamo/ranges/IDRangeNone.hpp>
 #include <magnet/xmlreader.hpp>
 #include <cmath> //for huge val
 
@@ -78,21 +77,15 @@ namespace dynamo {
 	<< magnet::xml::endtag("Sorter");
   }
 
-  std::unique_ptr<IDRange>
-  SSystemOnly::getParticleNeighbours(const Particle&) const
-  {
-    return std::unique_ptr<IDRange>(new IDRangeNone());
-  }
+  void
+  SSystemOnly::getParticleNeighbours(const Particle&, std::vector<size_t>&) const
+  {}
 
-  std::unique_ptr<IDRange>
-  SSystemOnly::getParticleNeighbours(const Vector&) const
-  {
-    return std::unique_ptr<IDRange>(new IDRangeNone());
-  }
+  void
+  SSystemOnly::getParticleNeighbours(const Vector&, std::vector<size_t>&) const
+  {}
 
-  std::unique_ptr<IDRange>
-  SSystemOnly::getParticleLocals(const Particle&) const
-  {
-    return std::unique_ptr<IDRange>(new IDRangeNone());
-  }
+  void
+  SSystemOnly::getParticleLocals(const Particle&, std::vector<size_t>&) const
+  {}
 }
@@ -16,6 +16,7 @@
 */
 
 #include <dynamo/simulation.hpp>
+#include <dynamo/NparticleEventData.hpp>
 #include <dynamo/schedulers/scheduler.hpp>
 #include <dynamo/dynamics/dynamics.hpp>
 #include <dynamo/schedulers/scheduler.hpp>
@@ -35,13 +36,65 @@
 #include <boost/iostreams/filter/bzip2.hpp>
 #include <boost/iostreams/chain.hpp>
 #include <boost/iostreams/device/back_inserter.hpp>
-#include <boost/iostreams/copy.hpp>
+#include <magnet/stream/parallel_bzip2.hpp>
 #include <dynamo/BC/BC.hpp>
+#include <dynamo/interactions/captures.hpp>
+#include <dynamo/ranges/IDPairRangeAll.hpp>
+#include <dynamo/ranges/IDPairRangeNone.hpp>
+#include <dynamo/ranges/IDPairRangeSingle.hpp>
+#include <dynamo/ranges/IDPairRangeRangePair.hpp>
 #include <iomanip>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
 
 //! The configuration file version, a version mismatch prevents an XML file load.
 static const std::string configFileVersion("1.5.0");
 
+namespace {
+  /*! \brief The identifying string at the start of a binary
+      configuration file.
+  */
+  const char binaryConfigMagic[8] = {'D', 'y', 'n', 'a', 'm', 'O', 'B', '\0'};
+
+  /*! \brief The layout version of the binary configuration file.
+    
+    This only versions the binary header and the particle arrays, the
+    embedded XML is versioned by configFileVersion.
+  */
+  const uint64_t binaryConfigVersion = 2;
+
+  //! Used to detect files written on a machine of different endianness.
+  const uint64_t binaryConfigByteOrder = 0x0102030405060708ull;
+
+  /*! \brief The alignment of the particle arrays in a binary
+      configuration file.
+
+    The embedded XML is padded so that the arrays start on a double
+    boundary, and can be read (or mapped) straight into memory.
+  */
+  const uint64_t binaryConfigAlignment = sizeof(double);
+
+  bool hasExtension(const std::string& fileName, const std::string& extension)
+  {
+    return (fileName.size() >= extension.size())
+      && (fileName.compare(fileName.size() - extension.size(), extension.size(), extension) == 0);
+  }
+
+  /*! \brief Orders particle IDs by their rows of a flat bit table,
+      which has words 64-bit words per particle.
+  */
+  struct MembershipLess
+  {
+    const uint64_t* table;
+    size_t words;
+
+    bool operator()(const size_t a, const size_t b) const
+    { return std::lexicographical_compare(table + a * words, table + (a + 1) * words, table + b * words, table + (b + 1) * words); }
+  };
+}
+
 namespace dynamo
 {
   Simulation::Simulation():
@@ -52,15 +105,22 @@ namespace dynamo
     eventPrintInterval(50000),
     nextPrintEvent(0),
     N(0),
+    threads(nullptr),
+    validateLevel(2),
+    checkInteractionLookup(false),
     primaryCellSize(1,1,1),
     ranGenerator(std::random_device()()),
     lastRunMFT(0.0),
     simID(0),
     replexExchangeNumber(0),
     status(START),
-    _sigParticleUpdate(new magnet::Signal<void(const NEventData&)>)
+    _sigParticleUpdate(new magnet::Signal<void(const NEventData&)>),
+    eventDataPool(new NEventDataPool),
+    _interactionGroups(0)
   {}
 
+  Simulation::~Simulation() {}
+
   namespace {
     /*! \brief Hidden functor used for sorting containers of
         shared_ptr's holiding OutputPlugin classes.
@@ -137,6 +197,10 @@ namespace dynamo
 
     dynamics->initialise();
 
+    //Interactions may search for their particle pairs while
+    //initialising, so the lookup is built first
+    buildInteractionLookup();
+
     {
       size_t ID=0;
       
@@ -175,6 +239,12 @@ namespace dynamo
 	ptr->initialise(ID++);
     }
 
+    //The capture maps are built once the neighbour lists are
+    //available, so only nearby pairs need to be tested.
+    for (shared_ptr<Interaction>& ptr : interactions)
+      if (shared_ptr<ICapture> capture = std::dynamic_pointer_cast<ICapture>(ptr))
+	capture->initCaptureMap();
+
     {
       size_t ID=0;
       
@@ -201,11 +271,7 @@ namespace dynamo
   IntEvent 
   Simulation::getEvent(const Particle& p1, const Particle& p2) const
   {
-    for (const shared_ptr<Interaction>& ptr : interactions)
-      if (ptr->isInteraction(p1,p2))
-	return ptr->getEvent(p1,p2);
-    
-    M_throw() << "Could not find the right interaction to test for";
+    return getInteraction(p1, p2)->getEvent(p1, p2);
   }
 
   void 
@@ -231,12 +297,127 @@ namespace dynamo
     return maxval;
   }
 
+  void
+  Simulation::buildInteractionLookup()
+  {
+    _interactionGroup.clear();
+    _interactionLookup.clear();
+    _interactionGroups = 0;
+
+    //Collect the IDRange's which determine the simple IDPairRange's
+    std::vector<const IDRange*> ranges;
+    for (const shared_ptr<Interaction>& ptr : interactions)
+      {
+	const IDPairRange* range = ptr->getRange().get();
+	if (const IDPairRangeSingle* single = dynamic_cast<const IDPairRangeSingle*>(range))
+	  ranges.push_back(single->getRange().get());
+	else if (const IDPairRangePair* pair = dynamic_cast<const IDPairRangePair*>(range))
+	  {
+	    ranges.push_back(pair->getRange1().get());
+	    ranges.push_back(pair->getRange2().get());
+	  }
+      }
+
+    //Determine the membership of each particle, by walking the
+    //ranges (IDRangeList::isInRange is a linear search). Each
+    //particle has a row of bits in a flat table.
+    const size_t words = (ranges.size() + 63) / 64;
+    std::vector<uint64_t> membership(N * words, 0);
+    for (size_t r(0); r < ranges.size(); ++r)
+      for (const size_t ID : *ranges[r])
+	if (ID < N)
+	  membership[ID * words + r / 64] |= uint64_t(1) << (r % 64);
+
+    //Sort the particles into groups of identical membership. The
+    //sort is stable, so the first particle of each group is its
+    //lowest ID.
+    std::vector<size_t> order(N);
+    for (size_t ID(0); ID < N; ++ID)
+      order[ID] = ID;
+
+    MembershipLess less;
+    less.table = membership.data();
+    less.words = words;
+    std::stable_sort(order.begin(), order.end(), less);
+
+    std::vector<size_t> representatives;
+    _interactionGroup.resize(N);
+    for (size_t i(0); i < N; ++i)
+      {
+	if (!i || less(order[i - 1], order[i]))
+	  representatives.push_back(order[i]);
+	_interactionGroup[order[i]] = representatives.size() - 1;
+      }
+
+    //Don't build a table which would be larger than the particle data
+    if (representatives.size() * representatives.size() > std::max(N, size_t(1024)))
+      {
+	_interactionGroup.clear();
+	return;
+      }
+
+    _interactionGroups = representatives.size();
+    _interactionLookup.resize(_interactionGroups * _interactionGroups);
+    for (size_t g1(0); g1 < _interactionGroups; ++g1)
+      for (size_t g2(0); g2 < _interactionGroups; ++g2)
+	{
+	  const Particle& p1 = particles[representatives[g1]];
+	  const Particle& p2 = particles[representatives[g2]];
+	  InteractionLookup& entry = _interactionLookup[g1 * _interactionGroups + g2];
+	  entry.ID = interactions.size();
+	  entry.resolved = false;
+	  for (size_t i(0); i < interactions.size(); ++i)
+	    {
+	      const IDPairRange* range = interactions[i]->getRange().get();
+	      if (!dynamic_cast<const IDPairRangeAll*>(range)
+		  && !dynamic_cast<const IDPairRangeNone*>(range)
+		  && !dynamic_cast<const IDPairRangeSingle*>(range)
+		  && !dynamic_cast<const IDPairRangePair*>(range))
+		{
+		  //This range depends on more than the group membership
+		  entry.ID = i;
+		  break;
+		}
+
+	      if (range->isInRange(p1, p2))
+		{
+		  entry.ID = i;
+		  entry.resolved = true;
+		  break;
+		}
+	    }
+	}
+  }
+
   const shared_ptr<Interaction>&
   Simulation::getInteraction(const Particle& p1, const Particle& p2) const 
   {
-    for (const shared_ptr<Interaction>& ptr : interactions)
-      if (ptr->isInteraction(p1,p2))
-	return ptr;
+    size_t start = 0;
+    if (!_interactionGroup.empty())
+      {
+	const InteractionLookup& entry = _interactionLookup[_interactionGroup[p1.getID()] * _interactionGroups + _interactionGroup[p2.getID()]];
+	start = entry.ID;
+	
+	if (entry.resolved)
+	  {
+	    if (checkInteractionLookup)
+	      for (size_t i(0); i < interactions.size(); ++i)
+		if (interactions[i]->isInteraction(p1, p2))
+		  {
+		    if (i != entry.ID)
+		      M_throw() << "The interaction lookup table returned \"" << interactions[entry.ID]->getName()
+				<< "\" for particles " << p1.getID() << " and " << p2.getID()
+				<< ", but the first matching Interaction is \"" << interactions[i]->getName() << "\"";
+		    break;
+		  }
+
+	    return interactions[entry.ID];
+	  }
+      }
+
+    for (size_t i(start); i < interactions.size(); ++i)
+      if (interactions[i]->isInteraction(p1,p2))
+	return interactions[i];
   
     M_throw() << "Could not find an Interaction between particles " << p1.getID() << " and " << p2.getID() << ". All particle pairings must have a corresponding Interaction defined.";
   }
@@ -281,29 +462,78 @@ namespace dynamo
     
     namespace io = boost::iostreams;
     
-    dout << "Reading the XML input file into memory" << std::endl;
     if (!boost::filesystem::exists(fileName))
       M_throw() << "Could not find the XML file named " << fileName
 		<< "\nPlease check the file exists.";
-    { //This scopes out the file objects
-      
-      //We use the boost iostreams library to load the file into a
-      //string which may be compressed.
+
+    //The binary format embeds the XML as a header, the particle
+    //arrays which follow are read once the XML is loaded.
+    const bool binary = hasExtension(fileName, ".dbin");
+    std::ifstream binaryFile;
+
+    //The XML particle data is not loaded into the Document, it is
+    //parsed straight from the (possibly compressed) file once the
+    //rest of the configuration is loaded. This avoids holding the
+    //text and nodes of every particle in memory.
+    io::filtering_istream inputFile;
+    std::unique_ptr<PullParser> parser;
+
+    if (binary)
+      {
+	dout << "Reading the binary input file header" << std::endl;
+	binaryFile.open(fileName.c_str(), std::ios::in | std::ios::binary);
+
+	char magic[sizeof(binaryConfigMagic)];
+	uint64_t version, byteOrder, xmlSize, dataOffset;
+	binaryFile.read(magic, sizeof(magic));
+	binaryFile.read(reinterpret_cast<char*>(&version), sizeof(version));
+	binaryFile.read(reinterpret_cast<char*>(&byteOrder), sizeof(byteOrder));
+	binaryFile.read(reinterpret_cast<char*>(&xmlSize), sizeof(xmlSize));
+	binaryFile.read(reinterpret_cast<char*>(&dataOffset), sizeof(dataOffset));
+
+	if (!binaryFile || !std::equal(magic, magic + sizeof(magic), binaryConfigMagic))
+	  M_throw() << "The file " << fileName << " is not a binary DynamO configuration file";
+
+	if (version != binaryConfigVersion)
+	  M_throw() << "The binary configuration file " << fileName << " has layout version " << version
+		    << ", but only version " << binaryConfigVersion << " is supported";
+
+	if (byteOrder != binaryConfigByteOrder)
+	  M_throw() << "The binary configuration file " << fileName << " was written on a machine with a different byte order";
+
+	doc.getStoredXMLData().resize(xmlSize);
+	if (!binaryFile.read(&doc.getStoredXMLData()[0], xmlSize))
+	  M_throw() << "The binary configuration file " << fileName << " is truncated";
+
+	//Skip the padding to the particle arrays
+	if (dataOffset % binaryConfigAlignment)
+	  M_throw() << "The binary configuration file " << fileName << " has misaligned particle arrays at offset " << dataOffset;
+	if (!binaryFile.seekg(dataOffset))
+	  M_throw() << "The binary configuration file " << fileName << " is truncated";
+      }
+    else
+      {
+	dout << "Reading the XML input file header" << std::endl;
       
-      //We make our filtering iostream
-      io::filtering_istream inputFile;
+	//We use the boost iostreams library to read the file, which
+	//may be compressed.
       
-      //Now check if we should add a decompressor filter
-      if (std::string(fileName.end()-8, fileName.end()) == ".xml.bz2")
-	inputFile.push(io::bzip2_decompressor());
-      else if (!(std::string(fileName.end()-4, fileName.end()) == ".xml"))
-	M_throw() << "Unrecognized extension for xml file";
-
-      //Finally, add the file as a source
-      inputFile.push(io::file_source(fileName));
-	  
-      io::copy(inputFile, io::back_inserter(doc.getStoredXMLData()));
-    }
+	//Check if we should add a decompressor filter
+	if (hasExtension(fileName, ".xml.bz2"))
+	  inputFile.push(io::bzip2_decompressor());
+	else if (!hasExtension(fileName, ".xml"))
+	  M_throw() << "Unrecognized extension for xml file";
+
+	//Finally, add the file as a source
+	inputFile.push(io::file_source(fileName));
+	parser.reset(new PullParser(inputFile));
+
+	//The ParticleData is the last tag of the DynamOconfig tag, so
+	//the Document is completed with an empty ParticleData tag
+	std::string& data = doc.getStoredXMLData();
+	if (parser->copyUntilTag("ParticleData", data))
+	  data += parser->getEmptyTag() + "</DynamOconfig>";
+      }
 
     dout << "Parsing the XML" << std::endl;
     try {
@@ -390,7 +620,18 @@ namespace dynamo
 
     ptrScheduler = Scheduler::getClass(simNode.getNode("Scheduler"), this);
 
-    dynamics->loadParticleXMLData(mainNode);
+    if (binary)
+      {
+	dynamics->loadParticleBinaryData(mainNode, binaryFile);
+	_properties.loadParticleBinaryData(binaryFile, N);
+      }
+    else
+      {
+	dynamics->loadParticleXMLData(mainNode, *parser);
+
+	if (!parser->nextTag() || !parser->isEndTag() || (parser->name() != "DynamOconfig") || parser->nextTag())
+	  M_throw() << "The ParticleData tag must be the last tag in the DynamOconfig tag of " << fileName;
+      }
   
     //Fixes or conversions once system is loaded
     lastRunMFT *= units.unitTime();
@@ -409,19 +650,61 @@ namespace dynamo
 
   void
   Simulation::writeXMLfile(std::string fileName, bool applyBC, bool round)
+  {
+    writeFile(fileName, std::bind(&Simulation::writeConfigData, this, std::placeholders::_1,
+				  hasExtension(fileName, ".dbin"), applyBC, round), threads);
+    dout << "Config written to " << fileName << std::endl;
+  }
+
+  namespace {
+    void writeString(std::ostream& os, const std::string& data)
+    { os.write(data.data(), data.size()); }
+  }
+
+  void
+  Simulation::writeFile(const std::string& fileName, const std::string& data, magnet::thread::ThreadPool* pool)
+  { writeFile(fileName, std::bind(&writeString, std::placeholders::_1, std::cref(data)), pool); }
+
+  void
+  Simulation::writeFile(const std::string& fileName, const std::function<void(std::ostream&)>& writer,
+			magnet::thread::ThreadPool* pool)
+  {
+    std::ofstream file(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+
+    if (hasExtension(fileName, ".bz2"))
+      {
+	magnet::stream::ParallelBzip2Stream bz(file, pool);
+	writer(bz);
+	if (!bz)
+	  M_throw() << "Failed while compressing the file " << fileName;
+	bz.close();
+      }
+    else
+      writer(file);
+
+    if (!file)
+      M_throw() << "Failed while writing the file " << fileName;
+  }
+
+  std::string
+  Simulation::getConfigData(bool binary, bool applyBC, bool round)
+  {
+    std::ostringstream data(std::ios::out | std::ios::binary);
+    writeConfigData(data, binary, applyBC, round);
+    return data.str();
+  }
+
+  void
+  Simulation::writeConfigData(std::ostream& os, bool binary, bool applyBC, bool round)
   {
     if (status < INITIALISED || status == ERROR)
       M_throw() << "Cannot write out configuration in this state";
   
-    namespace io = boost::iostreams;
-    io::filtering_ostream coutputFile;
-
-    if (std::string(fileName.end()-4, fileName.end()) == ".bz2")
-      coutputFile.push(io::bzip2_compressor());
-  
-    coutputFile.push(io::file_sink(fileName));
-  
-    magnet::xml::XmlStream XML(coutputFile);
+    //The XML is written straight to the stream, except in the binary
+    //format, which writes the length of the XML into the file header
+    std::ostringstream xmlData;
+    std::ostream& xmlOut = binary ? static_cast<std::ostream&>(xmlData) : os;
+    magnet::xml::XmlStream XML(xmlOut);
     XML.setFormatXML(true);
 
     dynamics->updateAllParticles();
@@ -512,11 +795,40 @@ namespace dynamo
 	<< magnet::xml::endtag("Simulation")
 	<< _properties;
 
-    dynamics->outputParticleXMLData(XML, applyBC);
-
-    XML << magnet::xml::endtag("DynamOconfig");
-
-    dout << "Config written to " << fileName << std::endl;
+    if (binary)
+      {
+	XML << magnet::xml::tag("ParticleData")
+	    << magnet::xml::attr("N") << N;
+
+	if (dynamics->hasOrientationData())
+	  XML << magnet::xml::attr("OrientationData") << "Y";
+
+	XML << magnet::xml::endtag("ParticleData")
+	    << magnet::xml::endtag("DynamOconfig");
+
+	const std::string xml = xmlData.str();
+	const uint64_t xmlSize = xml.size();
+	const uint64_t headerSize = sizeof(binaryConfigMagic) + 4 * sizeof(uint64_t);
+	//The particle arrays start at the first aligned offset after the XML
+	const uint64_t dataOffset = (headerSize + xmlSize + binaryConfigAlignment - 1) 
+	  / binaryConfigAlignment * binaryConfigAlignment;
+	os.write(binaryConfigMagic, sizeof(binaryConfigMagic));
+	os.write(reinterpret_cast<const char*>(&binaryConfigVersion), sizeof(binaryConfigVersion));
+	os.write(reinterpret_cast<const char*>(&binaryConfigByteOrder), sizeof(binaryConfigByteOrder));
+	os.write(reinterpret_cast<const char*>(&xmlSize), sizeof(xmlSize));
+	os.write(reinterpret_cast<const char*>(&dataOffset), sizeof(dataOffset));
+	os.write(xml.data(), xml.size());
+	const char padding[binaryConfigAlignment] = {};
+	os.write(padding, dataOffset - headerSize - xmlSize);
+
+	dynamics->outputParticleBinaryData(os, applyBC);
+	_properties.outputParticleBinaryData(os, N);
+      }
+    else
+      {
+	dynamics->outputParticleXMLData(XML, applyBC);
+	XML << magnet::xml::endtag("DynamOconfig");
+      }
 
     //Rescale the properties back to the simulation units
     _properties.rescaleUnit(Property::Units::L, 
@@ -621,15 +933,16 @@ namespace dynamo
     long double sumMass(0);
 
     //Determine the discrepancy VECTOR
-    for (Particle & Part : particles)
-      {
-	Vector  pos(Part.getPosition()), vel(Part.getVelocity());
-	BCs->applyBC(pos,vel);
-	double mass = species[Part]->getMass(Part.getID());
-	//Note we sum the negatives!
-	sumMV -= vel * mass;
-	sumMass += mass;
-      }
+    for (const shared_ptr<Species>& sp : species)
+      for (const size_t ID : *(sp->getRange()))
+	{
+	  Vector  pos(particles[ID].getPosition()), vel(particles[ID].getVelocity());
+	  BCs->applyBC(pos,vel);
+	  double mass = sp->getMass(ID);
+	  //Note we sum the negatives!
+	  sumMV -= vel * mass;
+	  sumMass += mass;
+	}
   
     sumMV /= sumMass;
   
@@ -681,54 +994,51 @@ namespace dynamo
   Simulation::checkSystem()
   {
     dynamics->updateAllParticles();
+    //Every pair is tested, so this check does not rely on the
+    //neighbour lists being correct
+    ptrScheduler->validateState(false, std::numeric_limits<size_t>::max(), true);
+  }
 
-    std::vector<Particle>::const_iterator iPtr1, iPtr2;
-  
-    for (const shared_ptr<Interaction>& interaction_ptr : interactions)
-      interaction_ptr->validateState();
-
-    for (iPtr1 = particles.begin(); iPtr1 != particles.end(); ++iPtr1)
-      for (iPtr2 = iPtr1 + 1; iPtr2 != particles.end(); ++iPtr2)
-	getInteraction(*iPtr1, *iPtr2)->validateState(*iPtr1, *iPtr2);
+  void
+  Simulation::outputData(std::string filename)
+  {
+    writeFile(filename, std::bind(&Simulation::writeOutputData, this, std::placeholders::_1), threads);
+    dout << "Output written to " << filename << std::endl;
+  }
 
-    for (const Particle& part : particles)
-      for (const shared_ptr<Local>& lcl : locals)
-      if (lcl->isInteraction(part)) lcl->validateState(part);
+  std::string
+  Simulation::getOutputData()
+  {
+    std::ostringstream outputData;
+    writeOutputData(outputData);
+    return outputData.str();
   }
 
   void
-  Simulation::outputData(std::string filename)
+  Simulation::writeOutputData(std::ostream& os)
   {
     if (status < INITIALISED || status == ERROR)
       M_throw() << "Cannot output data when not initialised!";
 
-    namespace io = boost::iostreams;
-    io::filtering_ostream coutputFile;
-  
-    if (std::string(filename.end()-4, filename.end()) == ".bz2")
-      coutputFile.push(io::bzip2_compressor());
-  
-    coutputFile.push(io::file_sink(filename));
-  
-    magnet::xml::XmlStream XML(coutputFile);
-    XML.setFormatXML(true);
+    {
+      magnet::xml::XmlStream XML(os);
+      XML.setFormatXML(true);
   
-    XML << std::setprecision(std::numeric_limits<double>::digits10 + 2)
-	<< magnet::xml::prolog() << magnet::xml::tag("OutputData");
+      XML << std::setprecision(std::numeric_limits<double>::digits10 + 2)
+	  << magnet::xml::prolog() << magnet::xml::tag("OutputData");
   
-    //Output the data and delete the outputplugins
-    for (shared_ptr<OutputPlugin> & Ptr : outputPlugins)
-      Ptr->output(XML);
+      //Output the data and delete the outputplugins
+      for (shared_ptr<OutputPlugin> & Ptr : outputPlugins)
+	Ptr->output(XML);
   
-    for (shared_ptr<Interaction> & Ptr : interactions)
-      Ptr->outputData(XML);
+      for (shared_ptr<Interaction> & Ptr : interactions)
+	Ptr->outputData(XML);
 
-    for (shared_ptr<Local> & Ptr : locals)
-      Ptr->outputData(XML);
+      for (shared_ptr<Local> & Ptr : locals)
+	Ptr->outputData(XML);
 
-    XML << magnet::xml::endtag("OutputData");
-
-    dout << "Output written to " << filename << std::endl;
+      XML << magnet::xml::endtag("OutputData");
+    }
   }
 
   void 
@@ -22,9 +22,13 @@
 #include <dynamo/property.hpp>
 #include <dynamo/units/units.hpp>
 #include <magnet/function/delegate.hpp>
+#include <functional>
+#include <ostream>
 #include <random>
 #include <vector>
 
+namespace magnet { namespace thread { class ThreadPool; } }
+
 namespace dynamo
 {  
   class Scheduler;
@@ -42,6 +46,7 @@ namespace dynamo
   class System;
 
   class NEventData;
+  class NEventDataPool;
   class PairEventData;
   class ParticleEventData;
 
@@ -121,6 +126,8 @@ namespace dynamo
     /*! \brief Significant default value initialisation.
      */
     Simulation();
+
+    ~Simulation();
     
     /*! \brief Initialise the entire Simulation and the Simulation struct.
      
@@ -176,6 +183,9 @@ namespace dynamo
      */  
     void setCOMVelocity(const Vector COMVelocity = Vector(0,0,0));
 
+    /*! \brief Checks every pair of particles for invalid states,
+        reporting all that are found (see Scheduler::validateState).
+     */
     void checkSystem();
 
     void addSystemTicker();
@@ -215,16 +225,27 @@ namespace dynamo
     
       \param filename The path to the XML file to write (this file
       will either be created or overwritten). The filename must end in
-      either ".xml" for uncompressed xml files or ".bz2" for bzip2
-      compressed configuration files.
+      either ".xml" for uncompressed xml files, ".bz2" for bzip2
+      compressed configuration files, or ".dbin" for binary
+      configuration files (see loadXMLfile()).
     */
     void outputData(std::string filename = "output.xml.bz2");
 
     /*! \brief Loads a Simulation from the passed XML file.
 
       \param filename The path to the XML file to load. The filename
-     must end in either ".xml" for uncompressed xml files or ".bz2"
-     for bzip2 compressed configuration files.
+     must end in either ".xml" for uncompressed xml files, ".bz2"
+     for bzip2 compressed configuration files, or ".dbin" for binary
+     configuration files.
+
+     The binary format is a header (an identifying string, the layout
+     version, a byte order marker, the length of the XML and the
+     offset of the particle data), then the XML configuration without
+     the per-particle data, then the particle data as raw arrays (see
+     Dynamics::outputParticleBinaryData and
+     PropertyStore::outputParticleBinaryData). The XML is padded so
+     the arrays start at an offset which is a multiple of
+     sizeof(double), and each array keeps that alignment.
     */
     void loadXMLfile(std::string filename);
     
@@ -232,8 +253,9 @@ namespace dynamo
 
       \param filename The path to the XML file to write (this file
       will either be created or overwritten). The filename must end in
-      either ".xml" for uncompressed xml files or ".bz2" for bzip2
-      compressed configuration files.
+      either ".xml" for uncompressed xml files, ".bz2" for bzip2
+      compressed configuration files, or ".dbin" for binary
+      configuration files (see loadXMLfile()).
 
       \param round If true, the data in the XML file will be written
       out at 2 s.f. lower precision to round all the values. This is
@@ -242,6 +264,49 @@ namespace dynamo
     */
     void writeXMLfile(std::string filename, bool applyBC = true, bool round = false);
 
+    /*! \brief Writes the contents of a configuration file, as
+        written by writeXMLfile() (before any compression), to a
+        stream.
+
+      \param binary If true, the binary ".dbin" format is written,
+      otherwise the XML format.
+
+      \sa writeXMLfile()
+     */
+    void writeConfigData(std::ostream& os, bool binary, bool applyBC = true, bool round = false);
+
+    /*! \brief Returns the contents of a configuration file in
+        memory (see writeConfigData()).
+     */
+    std::string getConfigData(bool binary, bool applyBC = true, bool round = false);
+
+    /*! \brief Writes the contents of the output data file, as
+        written by outputData() (before any compression), to a
+        stream.
+     */
+    void writeOutputData(std::ostream& os);
+
+    /*! \brief Returns the contents of the output data file in
+        memory (see writeOutputData()).
+     */
+    std::string getOutputData();
+
+    /*! \brief Writes a file by passing a stream to the writer
+        function, compressing the data if the filename ends in
+        ".bz2".
+
+      The data is streamed into the file. The bzip2 compression is
+      split into blocks, which are compressed in parallel if a
+      ThreadPool is passed (see magnet::stream::ParallelBzip2Stream).
+     */
+    static void writeFile(const std::string& fileName, const std::function<void(std::ostream&)>& writer,
+			  magnet::thread::ThreadPool* pool = NULL);
+
+    /*! \brief Writes data held in memory to the named file (see
+        writeFile()).
+     */
+    static void writeFile(const std::string& fileName, const std::string& data, magnet::thread::ThreadPool* pool = NULL);
+
     /*! \brief The Ensemble of the Simulation. */
     shared_ptr<Ensemble> ensemble;
 
@@ -310,6 +375,38 @@ namespace dynamo
     /*! \brief Number of Particle's in the system. */
     size_t N;
     
+    /*! \brief The ThreadPool available for parallel work within
+        this Simulation, or nullptr if everything must run serially.
+     
+      This is set by the Engine (see ESingleSimulation). It is left
+      unset when the Simulation itself is run as a task of the
+      Engine's ThreadPool (e.g., EReplicaExchangeSimulation), as
+      waiting on the pool from within one of its own tasks would
+      deadlock.
+
+      The events themselves are always executed one at a time, in
+      time order. The pool is only used for the O(N) work around the
+      event loop, such as rebuilding the event lists, validating the
+      state and sampling. There is no spatially decomposed event
+      loop.
+     */
+    magnet::thread::ThreadPool* threads;
+
+    /*! \brief How thoroughly the configuration is checked for
+        invalid states when the Scheduler is initialised.
+
+      0 skips the checks, 1 checks a sample of the particles and 2
+      (the default) checks every particle. See
+      Scheduler::validateState.
+     */
+    size_t validateLevel;
+
+    /*! \brief If set, every Interaction found through the lookup
+        table of getInteraction() is checked against a linear search
+        of the Interaction's.
+     */
+    bool checkInteractionLookup;
+
     /*! \brief The Particle's of the system. */
     std::vector<Particle> particles;  
     
@@ -367,8 +464,38 @@ namespace dynamo
      */
     mutable std::unique_ptr<magnet::Signal<void(const NEventData&)> > _sigParticleUpdate;
 
+    /*! \brief Reusable buffers for recording the changes of
+      events which affect many particles.
+     */
+    mutable std::unique_ptr<NEventDataPool> eventDataPool;
+
   private:
     size_t _nextPrint;
+
+    /*! \brief Builds the lookup table used by getInteraction().
+
+      Particles are sorted into groups which share the same membership
+      of every IDRange used by the IDPairRangeSingle and
+      IDPairRangePair ranges of the Interaction's. For these (and the
+      All and None) ranges, the first matching Interaction depends only
+      on the groups of the two particles, so it is stored in a table
+      indexed by the pair of groups. If any other type of IDPairRange
+      (e.g., a chain or union range) is reached while searching the
+      interactions for a pair of groups, the table entry instead
+      records where the linear search must resume.
+     */
+    void buildInteractionLookup();
+
+    struct InteractionLookup
+    {
+      //! The Interaction ID, or where to start searching if !resolved.
+      size_t ID;
+      bool resolved;
+    };
+
+    std::vector<size_t> _interactionGroup;
+    std::vector<InteractionLookup> _interactionLookup;
+    size_t _interactionGroups;
   };
 
 }
@@ -0,0 +1,93 @@
+/*  dynamo:- Event driven molecular dynamics simulator 
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <dynamo/systems/cellsAutoTune.hpp>
+#include <dynamo/simulation.hpp>
+#include <dynamo/NparticleEventData.hpp>
+#include <dynamo/globals/cells.hpp>
+#include <dynamo/units/units.hpp>
+#include <dynamo/schedulers/scheduler.hpp>
+#include <dynamo/outputplugins/outputplugin.hpp>
+#include <algorithm>
+#include <cmath>
+
+#ifdef DYNAMO_DEBUG 
+#include <boost/math/special_functions/fpclassify.hpp>
+#endif
+
+namespace dynamo {
+  SysCellsAutoTune::SysCellsAutoTune(dynamo::Simulation* nSim, size_t cellsID, size_t trialEvents, std::string nName):
+    System(nSim),
+    _cellsID(cellsID),
+    _trialEvents(trialEvents),
+    _lastEventCount(0)
+  {
+    sysName = nName;
+    type = VIRTUAL;
+  }
+
+  void 
+  SysCellsAutoTune::initialise(size_t nID)
+  {
+    ID = nID;
+
+    if (!std::dynamic_pointer_cast<GCells>(Sim->globals[_cellsID]))
+      M_throw() << "Have the globals been shuffled? The cellsID of " << sysName << " is no longer a GCells.";
+
+    //Each particle has roughly one event per mean free time. If this
+    //is not known, the unit of time is assumed to be similar.
+    const double mft = (Sim->lastRunMFT > 0) ? Sim->lastRunMFT : Sim->units.unitTime();
+    dt = mft * _trialEvents / (4.0 * std::max(Sim->N, size_t(1)));
+    _lastEventCount = Sim->eventCount;
+  }
+
+  void
+  SysCellsAutoTune::runEvent() const
+  {
+    double locdt = dt;
+  
+#ifdef DYNAMO_DEBUG 
+    if (boost::math::isnan(dt))
+      M_throw() << "A NAN system event time has been found";
+#endif
+
+    Sim->systemTime += locdt;
+
+    Sim->ptrScheduler->stream(locdt);
+  
+    //dynamics must be updated first
+    Sim->stream(locdt);
+
+    const bool tuning = dynamic_cast<GCells&>(*Sim->globals[_cellsID]).autoTune();
+
+    //Check again after roughly a quarter of a trial, using the event
+    //rate since the last check (the event count is swapped by replica
+    //exchange, so it may have decreased).
+    const size_t events = (Sim->eventCount > _lastEventCount) ? Sim->eventCount - _lastEventCount : 0;
+    if (!tuning)
+      dt = HUGE_VAL;
+    else if (events)
+      dt = locdt * _trialEvents / (4.0 * events);
+    else
+      dt = 2 * locdt;
+
+    _lastEventCount = Sim->eventCount;
+
+    for (shared_ptr<OutputPlugin>& Ptr : Sim->outputPlugins)
+      Ptr->eventUpdate(*this, NEventData(), locdt);
+  }
+}
@@ -0,0 +1,54 @@
+/*  dynamo:- Event driven molecular dynamics simulator 
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <dynamo/systems/system.hpp>
+
+namespace dynamo {
+  /*! \brief Drives the auto-tuning of a GCells neighbour list.
+
+    This System is added by GCells when its AutoTune attribute is
+    set. Each time it runs, the cells check if the current trial has
+    run for enough events (see GCells::autoTune()). The trials are
+    measured by the global event count, so the tuning advances even
+    if the cells have no transition events. The time until the next
+    check is estimated from the recent event rate, so that it is
+    roughly a quarter of a trial. Once the tuning is complete, the
+    System never runs again.
+
+    It is not written to the configuration, as the cells recreate it
+    if they are still being tuned.
+   */
+  class SysCellsAutoTune: public System
+  {
+  public:
+    SysCellsAutoTune(dynamo::Simulation*, size_t cellsID, size_t trialEvents, std::string);
+  
+    virtual void runEvent() const;
+
+    virtual void initialise(size_t);
+
+    virtual void operator<<(const magnet::xml::Node&) {}
+
+  protected:
+    virtual void outputXML(magnet::xml::XmlStream&) const {}
+
+    size_t _cellsID;
+    size_t _trialEvents;
+    mutable size_t _lastEventCount;
+  };
+}
@@ -90,11 +90,11 @@ namespace dynamo {
     dout << "Rescaling kT " << currentkT 
 	 << " To " << _kT / Sim->units.unitEnergy() <<  std::endl;
 
-    NEventData SDat;
+    NEventDataPool::Buffer SDat(*Sim->eventDataPool);
 
     for (const shared_ptr<Species>& species : Sim->species)
       for (const unsigned long& partID : *species->getRange())
-      SDat.L1partChanges.push_back(ParticleEventData(Sim->particles[partID], *species, RESCALE));
+      SDat->L1partChanges.push_back(ParticleEventData(Sim->particles[partID], *species, RESCALE));
 
     Sim->dynamics->updateAllParticles();
     Sim->dynamics->rescaleSystemKineticEnergy(_kT / currentkT);
@@ -105,14 +105,14 @@ namespace dynamo {
 
     scaleFactor += std::log(currentkT);
 
-    (*Sim->_sigParticleUpdate)(SDat);
+    (*Sim->_sigParticleUpdate)(*SDat);
   
     //Only 1ParticleEvents occur
-    for (const ParticleEventData& PDat : SDat.L1partChanges)
+    for (const ParticleEventData& PDat : SDat->L1partChanges)
       Sim->ptrScheduler->fullUpdate(Sim->particles[PDat.getParticleID()]);
   
     for (shared_ptr<OutputPlugin>& Ptr : Sim->outputPlugins)
-      Ptr->eventUpdate(*this, SDat, locdt); 
+      Ptr->eventUpdate(*this, *SDat, locdt); 
 
     for (shared_ptr<OutputPlugin>& Ptr : Sim->outputPlugins)
       Ptr->temperatureRescale(1.0/currentkT);
@@ -59,11 +59,11 @@ namespace dynamo {
     //Does not increment the event counter
     //++Sim->eventCount;
 
-    NEventData SDat;
+    NEventDataPool::Buffer SDat(*Sim->eventDataPool);
 
     for (const shared_ptr<Species>& species : Sim->species)
       for (const unsigned long& partID : *species->getRange())
-      SDat.L1partChanges.push_back(ParticleEventData(Sim->particles[partID], *species, RECALCULATE));
+      SDat->L1partChanges.push_back(ParticleEventData(Sim->particles[partID], *species, RECALCULATE));
 
     Sim->dynamics->updateAllParticles();
     
@@ -76,11 +76,11 @@ namespace dynamo {
     Vector newg = magnet::math::Quaternion::fromAngleAxis(_angularvel * _timestep, _rotationaxis) *  dynamics->getGravityVector();
     dynamics->setGravityVector(newg.normal() * g);
 
-    for (const ParticleEventData& PDat : SDat.L1partChanges)
+    for (const ParticleEventData& PDat : SDat->L1partChanges)
       Sim->ptrScheduler->fullUpdate(Sim->particles[PDat.getParticleID()]);
   
     for (shared_ptr<OutputPlugin>& Ptr : Sim->outputPlugins)
-      Ptr->eventUpdate(*this, SDat, locdt); 
+      Ptr->eventUpdate(*this, *SDat, locdt); 
 
     dt = _timestep;
     Sim->ptrScheduler->rebuildList();
@@ -240,7 +240,7 @@ namespace dynamo {
 
     //++Sim->eventCount;
 
-    NEventData SDat;
+    NEventDataPool::Buffer SDat(*Sim->eventDataPool);
 
     typedef std::map<size_t, Vector>::value_type locPair;
     for (const locPair& p : stateChange)
@@ -289,18 +289,18 @@ namespace dynamo {
 	    M_throw() << "Bad event type!";
 	  }
 	  
-	SDat.L1partChanges.push_back(EDat);
+	SDat->L1partChanges.push_back(EDat);
       }
 
     //Must clear the state before calling the signal, otherwise this
     //will erroneously schedule itself again
     stateChange.clear(); 
-    (*Sim->_sigParticleUpdate)(SDat);
+    (*Sim->_sigParticleUpdate)(*SDat);
 
-    for (const ParticleEventData& PDat : SDat.L1partChanges)
+    for (const ParticleEventData& PDat : SDat->L1partChanges)
       Sim->ptrScheduler->fullUpdate(Sim->particles[PDat.getParticleID()]);
     
     for (shared_ptr<OutputPlugin>& Ptr : Sim->outputPlugins)
-      Ptr->eventUpdate(*this, SDat, locdt); 
+      Ptr->eventUpdate(*this, *SDat, locdt); 
   }
 }
@@ -29,10 +29,11 @@
 #endif
 
 namespace dynamo {
-  SSnapshot::SSnapshot(dynamo::Simulation* nSim, double nPeriod, std::string nName, std::string format, bool applyBC):
+  SSnapshot::SSnapshot(dynamo::Simulation* nSim, double nPeriod, std::string nName, std::string format, bool applyBC, bool binary):
     System(nSim),
     _applyBC(applyBC),
     _format(format),
+    _binary(binary),
     _saveCounter(0)
   {
     if (nPeriod <= 0.0)
@@ -74,15 +75,51 @@ namespace dynamo {
     for (shared_ptr<OutputPlugin>& Ptr : Sim->outputPlugins)
       Ptr->eventUpdate(*this, NEventData(), locdt);
   
-    std::string filename = magnet::string::search_replace("Snapshot."+_format+".xml.bz2", "%COUNT", boost::lexical_cast<std::string>(_saveCounter));
+    std::string filename = magnet::string::search_replace("Snapshot."+_format+(_binary ? ".dbin" : ".xml.bz2"), "%COUNT", boost::lexical_cast<std::string>(_saveCounter));
     filename = magnet::string::search_replace(filename, "%ID", boost::lexical_cast<std::string>(Sim->simID));
-    Sim->writeXMLfile(filename, _applyBC);
     
     dout << "Printing SNAPSHOT" << std::endl;
     
-    filename = magnet::string::search_replace("Snapshot.output."+_format+".xml.bz2", "%COUNT", boost::lexical_cast<std::string>(_saveCounter++));
-    filename = magnet::string::search_replace(filename, "%ID", boost::lexical_cast<std::string>(Sim->simID));
-    Sim->outputData(filename);
+    std::string outputname = magnet::string::search_replace("Snapshot.output."+_format+".xml.bz2", "%COUNT", boost::lexical_cast<std::string>(_saveCounter++));
+    outputname = magnet::string::search_replace(outputname, "%ID", boost::lexical_cast<std::string>(Sim->simID));
+
+    //Only the state is captured here, the compression and writing
+    //of the files is done on a background thread while the
+    //simulation continues. Only one snapshot is written at a time.
+    finishWrite();
+    _writer = std::async(std::launch::async, &SSnapshot::writeFiles, 
+			 filename, Sim->getConfigData(_binary, _applyBC), 
+			 outputname, Sim->getOutputData(), Sim->threads);
+  }
+
+  SSnapshot::~SSnapshot()
+  {
+    try {
+      finishWrite();
+    } catch (std::exception& except)
+      {
+	derr << "Failed to write the last snapshot: " << except.what() << std::endl;
+      }
+  }
+
+  void
+  SSnapshot::finishWrite() const
+  {
+    //get() rethrows any exception from the background write
+    if (_writer.valid())
+      _writer.get();
+  }
+
+  void
+  SSnapshot::writeFiles(const std::string& configname, const std::string& configdata,
+			const std::string& outputname, const std::string& outputdata,
+			magnet::thread::ThreadPool* pool)
+  {
+    //The bzip2 blocks are compressed on the pool while the
+    //simulation runs. The writer only waits on its own blocks, so
+    //this does not interfere with the simulation's use of the pool.
+    Simulation::writeFile(configname, configdata, pool);
+    Simulation::writeFile(outputname, outputdata, pool);
   }
 
   void 
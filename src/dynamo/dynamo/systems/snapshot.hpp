@@ -17,14 +17,20 @@
 
 #pragma once
 #include <dynamo/systems/system.hpp>
+#include <future>
+#include <string>
+
+namespace magnet { namespace thread { class ThreadPool; } }
 
 namespace dynamo {
   //! \brief A System Event which periodically saves the state of the system.
   class SSnapshot: public System
   {
   public:
-    SSnapshot(dynamo::Simulation*, double, std::string, std::string, bool);
+    SSnapshot(dynamo::Simulation*, double, std::string, std::string, bool, bool binary = false);
   
+    ~SSnapshot();
+
     virtual void runEvent() const;
 
     virtual void initialise(size_t);
@@ -44,6 +50,18 @@ namespace dynamo {
     double _period;
     bool _applyBC;
     std::string _format;
+    //! Write the configuration snapshots in the binary (".dbin") format.
+    bool _binary;
     mutable size_t _saveCounter;
+
+    //! \brief The background write of the last snapshot.
+    mutable std::future<void> _writer;
+
+    //! \brief Waits for the background write of the last snapshot.
+    void finishWrite() const;
+
+    static void writeFiles(const std::string& configname, const std::string& configdata,
+			   const std::string& outputname, const std::string& outputdata,
+			   magnet::thread::ThreadPool* pool);
   };
 }
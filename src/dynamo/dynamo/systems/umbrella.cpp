@@ -97,6 +97,7 @@ namespace dynamo {
   SysUmbrella::initialise(size_t nID)
   {
     ID = nID;
+    _potential->cacheAllSteps();
 
     if (_stepID == std::numeric_limits<size_t>::max())
       {
@@ -21,6 +21,7 @@
 #include <dynamo/schedulers/include.hpp>
 #include <dynamo/inputplugins/include.hpp>
 #include <magnet/exception.hpp>
+#include <magnet/thread/threadpool.hpp>
 #include <boost/program_options.hpp>
 #include <boost/tokenizer.hpp>
 #include <boost/lexical_cast.hpp>
@@ -36,6 +37,7 @@ main(int argc, char *argv[])
 	    << "under certain conditions. See the licence you obtained with\n"
 	    << "the code\n";
 
+  magnet::thread::ThreadPool threads;
   dynamo::Simulation sim;
 
   ////////////////////////PROGRAM OPTIONS!!!!!!!!!!!!!!!!!!!!!!!
@@ -47,7 +49,7 @@ main(int argc, char *argv[])
 
       allopts.add_options()
 	("help,h", "Produces this message OR if --pack-mode/-m is set, it lists the specific options available for that packer mode.")
-	("out-config-file,o", po::value<string>()->default_value("config.out.xml.bz2"), "Configuration output file.")
+	("out-config-file,o", po::value<string>()->default_value("config.out.xml.bz2"), "Configuration output file (.xml, .xml.bz2 or the binary .dbin format).")
 	("random-seed,s", po::value<unsigned int>(), "Seed value for the random number generator.")
 	("rescale-T,r", po::value<double>(), "Rescales the kinetic temperature of the input/generated config to this value.")
 	("thermostat,T", po::value<double>(), "Change or add a thermostatt with the temperature provided. A temperature of zero will remove the thermostatt.")
@@ -59,6 +61,8 @@ main(int argc, char *argv[])
 	("round", "Output the XML config file with one less digit of accuracy to remove rounding errors (used in the test harness).")
 	("unwrapped", "Don't apply the boundary conditions of the system when writing out the particle positions.")
 	("check", "Runs tests on the configuration to ensure the system is not in an invalid state.")
+	("n-threads,N", po::value<unsigned int>(),
+	 "Number of threads to use when building and writing out the configuration. The output does not depend on this setting.")
 	;
 
       loadopts.add_options()
@@ -115,6 +119,12 @@ main(int argc, char *argv[])
 
       if (vm.count("random-seed"))
 	sim.ranGenerator.seed(vm["random-seed"].as<unsigned int>());
+
+      if (vm.count("n-threads"))
+	{
+	  threads.setThreadCount(vm["n-threads"].as<unsigned int>());
+	  sim.threads = &threads;
+	}
       
       if (!vm.count("pack-mode") && (vm.count("help") || !vm.count("config-file")))
 	{
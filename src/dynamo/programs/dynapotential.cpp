@@ -24,6 +24,41 @@
 
 #include <dynamo/interactions/potentials/lennard_jones.hpp>
 #include <boost/program_options.hpp>
+#include <chrono>
+#include <random>
+#include <vector>
+
+namespace {
+  /*! \brief The linear scan for the step ID of a separation, used as
+      a reference by the benchmark.
+  */
+  size_t linearStepID(const dynamo::Potential& pot, const double r)
+  {
+    size_t retval(0);
+    if (pot.direction())
+      for (; (retval < pot.steps()) && (r > pot[retval].first); ++retval) {}
+    else
+      for (; (retval < pot.steps()) && (r < pot[retval].first); ++retval) {}
+    return retval;
+  }
+
+  /*! \brief Times the step lookups made for each pair test of a
+      stepped interaction (the step ID, then its bounds) and returns
+      the lookups per second.
+  */
+  template<class LookupFunc>
+  double timeLookups(const dynamo::Potential& pot, const std::vector<double>& samples, LookupFunc lookup, size_t& checksum)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    for (const double r : samples)
+      {
+	const size_t ID = lookup(pot, r);
+	checksum += ID + size_t(pot.getStepBounds(ID).first > 0);
+      }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return samples.size() / elapsed.count();
+  }
+}
 
 /*! \brief Starting point for the dynapotential program.
  
@@ -54,6 +89,7 @@ int main(int argc, char *argv[])
 	("virial", "Use the virial algorithm for step energies")
 	("midvolume", "Use the Middle Volume algorithm for step energies")
 	("kT", po::value<double>()->default_value(1), "Set the temperature for the B2 algorithm")
+	("benchmark", po::value<size_t>(), "Instead of outputting the steps, time this many random step lookups and report the lookup throughput")
 	;
 
       boost::program_options::store(po::command_line_parser(argc, argv).
@@ -95,6 +131,34 @@ int main(int argc, char *argv[])
 	M_throw() << "Please specify which step energy algorithm to use";
 
       PotentialLennardJones LJ(1.0, 1.0, vm["cutoff"].as<double>(), U_mode, R_mode, vm["attractive-steps"].as<double>(), vm["kT"].as<double>());
+
+      if (vm.count("benchmark"))
+	{
+	  //Sample separations around the stepped region of the
+	  //potential, as an interaction would
+	  std::mt19937 RNG;
+	  std::uniform_real_distribution<double> dist(0.9, 1.1 * LJ.max_distance());
+	  std::vector<double> samples(vm["benchmark"].as<size_t>());
+	  for (double& r : samples) r = dist(RNG);
+
+	  LJ.cacheAllSteps();
+	  //Any lazily calculated steps are cached before the timing
+	  for (const double r : samples) LJ.calculateStepID(r);
+
+	  size_t binaryChecksum(0), linearChecksum(0);
+	  const double binaryRate = timeLookups(LJ, samples, std::mem_fn(&Potential::calculateStepID), binaryChecksum);
+	  const double linearRate = timeLookups(LJ, samples, &linearStepID, linearChecksum);
+
+	  if (binaryChecksum != linearChecksum)
+	    M_throw() << "The binary search and linear scan step IDs do not match";
+
+	  std::cout << "Cached steps " << LJ.cached_steps() << "\n"
+		    << "Lookups " << samples.size() << "\n"
+		    << "Binary search lookups/s " << binaryRate << "\n"
+		    << "Linear scan lookups/s " << linearRate << "\n"
+		    << "Speedup " << binaryRate / linearRate << std::endl;
+	  return 0;
+	}
       
       for (size_t i(0); i < std::min(LJ.steps(), vm["steps"].as<size_t>()); ++i)
 	std::cout << LJ[i].first << " " << LJ[i].second << "\n";
@@ -0,0 +1,216 @@
+/*  dynamo:- Event driven molecular dynamics simulator 
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* A test of the bulk particle passes of the Dynamics.
+
+   Dynamics::updateAllParticles() (which DynNewtonian implements with
+   a loop free of virtual calls), getSystemKineticEnergy() and
+   rescaleSystemKineticEnergy() work species by species. They are
+   checked against the per-particle updateParticle() and
+   getParticleKineticEnergy(), with periodic and Lees-Edwards
+   boundary conditions and a species of infinitely heavy particles.
+
+   The bulk passes are then timed against the per-particle loops
+   they replaced, for a large system.
+*/
+
+#include <dynamo/simulation.hpp>
+#include <dynamo/dynamics/newtonian.hpp>
+#include <dynamo/BC/PBC.hpp>
+#include <dynamo/BC/LEBC.hpp>
+#include <dynamo/species/point.hpp>
+#include <dynamo/ranges/IDRangeRange.hpp>
+#include <iostream>
+#include <stdexcept>
+#include <random>
+#include <vector>
+#include <limits>
+#include <cmath>
+#include <time.h>
+
+using namespace dynamo;
+
+std::mt19937 RNG(1234);
+
+Vector randomVector(double scale)
+{
+  std::uniform_real_distribution<double> uniform(-scale, scale);
+  return Vector(uniform(RNG), uniform(RNG), uniform(RNG));
+}
+
+double seconds()
+{
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec + 1e-9 * now.tv_nsec;
+}
+
+bool close(const double a, const double b)
+{ return std::abs(a - b) <= 1e-12 * std::max(1.0, std::max(std::abs(a), std::abs(b))); }
+
+bool close(const Vector& a, const Vector& b)
+{ return close(a[0], b[0]) && close(a[1], b[1]) && close(a[2], b[2]); }
+
+/*! \brief Builds a system of N particles with delayed states, in
+    three species. The second species is infinitely heavy.
+ */
+void buildSystem(Simulation& sim, const size_t N, bool LEBC)
+{
+  sim.dynamics = shared_ptr<Dynamics>(new DynNewtonian(&sim));
+  if (LEBC)
+    sim.BCs = shared_ptr<BoundaryCondition>(new BCLeesEdwards(&sim));
+  else
+    sim.BCs = shared_ptr<BoundaryCondition>(new BCPeriodic(&sim));
+
+  std::uniform_real_distribution<double> uniform(-1, 1);
+  for (size_t ID(0); ID < N; ++ID)
+    {
+      sim.particles.push_back(Particle(randomVector(0.5), randomVector(1), ID));
+      sim.particles.back().getPecTime() = 0.1 * uniform(RNG);
+    }
+  sim.N = N;
+
+  sim.species.push_back(shared_ptr<Species>(new SpPoint(&sim, new IDRangeRange(0, N / 2), 1.3, "A", 0)));
+  sim.species.push_back(shared_ptr<Species>(new SpPoint(&sim, new IDRangeRange(N / 2, (3 * N) / 4), 
+							std::numeric_limits<double>::infinity(), "Heavy", 1)));
+  sim.species.push_back(shared_ptr<Species>(new SpPoint(&sim, new IDRangeRange((3 * N) / 4, N), 0.7, "B", 2)));
+
+  sim.dynamics->stream(0.05);
+}
+
+void check(bool LEBC)
+{
+  const char* name = LEBC ? "Lees-Edwards" : "periodic";
+  Simulation sim;
+  buildSystem(sim, 10000, LEBC);
+  const Dynamics& dynamics = *sim.dynamics;
+
+  //Streaming
+  const std::vector<Particle> initial = sim.particles;
+  for (Particle& part : sim.particles)
+    dynamics.updateParticle(part);
+  const std::vector<Particle> expected = sim.particles;
+
+  sim.particles = initial;
+  dynamics.updateAllParticles();
+
+  for (size_t ID(0); ID < sim.N; ++ID)
+    if (!close(sim.particles[ID].getPosition(), expected[ID].getPosition())
+	|| (sim.particles[ID].getVelocity() != expected[ID].getVelocity())
+	|| !dynamics.isUpToDate(sim.particles[ID]))
+      {
+	std::cerr << "Particle " << ID << " was streamed to " << sim.particles[ID].getPosition().toString()
+		  << " in bulk, but to " << expected[ID].getPosition().toString() << " individually (" << name << ")" << std::endl;
+	throw std::runtime_error("The bulk streaming differs");
+      }
+
+  //The kinetic energy
+  double energy = 0;
+  for (const Particle& part : sim.particles)
+    energy += dynamics.getParticleKineticEnergy(part);
+
+  const double bulkEnergy = dynamics.getSystemKineticEnergy();
+  if (!close(energy, bulkEnergy))
+    {
+      std::cerr << "The kinetic energy is " << bulkEnergy << " in bulk, but " << energy << " individually (" << name << ")" << std::endl;
+      throw std::runtime_error("The bulk kinetic energy differs");
+    }
+
+  //Rescaling the kinetic energy
+  const double scale = 1.7;
+  std::vector<Vector> velocities;
+  for (const Particle& part : sim.particles)
+    {
+      Vector vel = part.getVelocity();
+      if (!std::isinf(sim.species[part]->getMass(part.getID())))
+	{
+	  if (LEBC)
+	    {
+	      const BCLeesEdwards& bc = static_cast<const BCLeesEdwards&>(*sim.BCs);
+	      vel = bc.getPeculiarVelocity(part) * std::sqrt(scale) + bc.getStreamVelocity(part);
+	    }
+	  else
+	    vel *= std::sqrt(scale);
+	}
+      velocities.push_back(vel);
+    }
+
+  sim.dynamics->rescaleSystemKineticEnergy(scale);
+
+  for (size_t ID(0); ID < sim.N; ++ID)
+    if (!close(sim.particles[ID].getVelocity(), velocities[ID]))
+      {
+	std::cerr << "Particle " << ID << " was rescaled to " << sim.particles[ID].getVelocity().toString()
+		  << ", but expected " << velocities[ID].toString() << " (" << name << ")" << std::endl;
+	throw std::runtime_error("The bulk rescaling differs");
+      }
+
+  if (!close(dynamics.getSystemKineticEnergy(), scale * bulkEnergy))
+    throw std::runtime_error("The rescaled kinetic energy is wrong");
+
+  std::cout << "The bulk passes match the per-particle results (" << name << ")" << std::endl;
+}
+
+void benchmark(const size_t N)
+{
+  Simulation sim;
+  buildSystem(sim, N, false);
+  const Dynamics& dynamics = *sim.dynamics;
+  const size_t repeats = 5;
+
+  double start = seconds();
+  for (size_t i(0); i < repeats; ++i)
+    {
+      sim.dynamics->stream(0.01);
+      for (Particle& part : sim.particles)
+	dynamics.updateParticle(part);
+    }
+  const double streamTime = (seconds() - start) / repeats;
+
+  start = seconds();
+  for (size_t i(0); i < repeats; ++i)
+    {
+      sim.dynamics->stream(0.01);
+      dynamics.updateAllParticles();
+    }
+  const double bulkStreamTime = (seconds() - start) / repeats;
+
+  double sum = 0;
+  start = seconds();
+  for (size_t i(0); i < repeats; ++i)
+    for (const Particle& part : sim.particles)
+      sum += dynamics.getParticleKineticEnergy(part);
+  const double energyTime = (seconds() - start) / repeats;
+
+  start = seconds();
+  for (size_t i(0); i < repeats; ++i)
+    sum -= dynamics.getSystemKineticEnergy();
+  const double bulkEnergyTime = (seconds() - start) / repeats;
+
+  std::cout << "N=" << N << " streaming: " << streamTime * 1e9 / N << "ns per particle individually, " 
+	    << bulkStreamTime * 1e9 / N << "ns in bulk (speedup " << streamTime / bulkStreamTime << ")" << std::endl;
+  std::cout << "N=" << N << " kinetic energy: " << energyTime * 1e9 / N << "ns per particle individually, " 
+	    << bulkEnergyTime * 1e9 / N << "ns in bulk (speedup " << energyTime / bulkEnergyTime 
+	    << ", difference " << sum << ")" << std::endl;
+}
+
+int main()
+{
+  check(false);
+  check(true);
+  benchmark(2000000);
+}
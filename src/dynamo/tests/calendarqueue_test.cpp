@@ -0,0 +1,175 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* A test of the FELCalendarQueue sorter.
+
+   The sorter is driven with the same pattern of calls the Scheduler
+   makes, and every event it returns is checked against a brute force
+   list of the absolute event times of each particle. The event rate
+   is changed by orders of magnitude during the run, so the day width
+   is retuned in both directions, the epoch origin is advanced many
+   times and the overflow list is swept and jumped to. The sorter is
+   also resized and rebuilt part way through, and the event times are
+   rescaled, as a SysRescale event would.
+*/
+
+#include <dynamo/schedulers/sorters/include.hpp>
+#include <iostream>
+#include <stdexcept>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+using namespace dynamo;
+
+//The absolute event times of each particle's PEL
+typedef std::vector<std::vector<double> > Reference;
+
+std::mt19937 RNG(1234);
+double now = 0;
+
+void push(FEL& sorter, Reference& ref, const size_t ID, const double dt)
+{
+  sorter.push(Event(dt, INTERACTION, 0, 0), ID);
+  ref[ID].push_back(now + dt);
+}
+
+//Refill the PEL of a particle, as Scheduler::fullUpdate() would
+void addEvents(FEL& sorter, Reference& ref, const size_t ID, const double meanTime)
+{
+  std::uniform_int_distribution<size_t> eventCount(1, 6);
+  std::exponential_distribution<double> dt(1.0 / meanTime);
+  std::uniform_real_distribution<double> uniform;
+
+  const size_t events = eventCount(RNG);
+  for (size_t i(0); i < events; ++i)
+    {
+      const double u = uniform(RNG);
+      if (u < 0.01)
+	//A rare event far in the future, which is placed in the
+	//overflow list
+	push(sorter, ref, ID, 1000 * meanTime * uniform(RNG));
+      else if (u < 0.02)
+	//An event which will never occur
+	push(sorter, ref, ID, HUGE_VAL);
+      else
+	push(sorter, ref, ID, dt(RNG));
+    }
+}
+
+void fill(FEL& sorter, Reference& ref, const size_t N, const double meanTime)
+{
+  sorter.resize(N);
+  ref.clear();
+  ref.resize(N);
+  for (size_t i(0); i < ref.size(); ++i)
+    addEvents(sorter, ref, i, meanTime);
+}
+
+void runEvents(FEL& sorter, Reference& ref, const size_t events, const double meanTime)
+{
+  for (size_t n(0); n < events; ++n)
+    {
+      sorter.sort();
+      const std::pair<size_t, Event> next = sorter.next();
+
+      size_t minID = 0;
+      double minTime = HUGE_VAL;
+      for (size_t i(0); i < ref.size(); ++i)
+	for (const double& t : ref[i])
+	  if (t < minTime)
+	    {
+	      minTime = t;
+	      minID = i;
+	    }
+
+      if ((next.first != minID)
+	  || (std::abs(next.second.dt - (minTime - now)) > 1e-8 * std::max(1.0, std::abs(now))))
+	{
+	  std::cerr << "Event " << n << ": the sorter returned particle " << next.first
+		    << " at dt=" << next.second.dt << ", expected particle " << minID
+		    << " at dt=" << minTime - now << std::endl;
+	  throw std::runtime_error("The calendar queue returned the wrong event");
+	}
+
+      sorter.stream(next.second.dt);
+      now = minTime;
+
+      if (RNG() % 2)
+	{
+	  //Treat the event as invalid, so the next event in the PEL is
+	  //used and a replacement is added
+	  sorter.popNextEvent();
+	  ref[minID].erase(std::min_element(ref[minID].begin(), ref[minID].end()));
+	  std::exponential_distribution<double> dt(1.0 / meanTime);
+	  push(sorter, ref, minID, dt(RNG));
+	}
+      else
+	{
+	  sorter.clearPEL(minID);
+	  ref[minID].clear();
+	  addEvents(sorter, ref, minID, meanTime);
+	}
+      sorter.update(minID);
+    }
+}
+
+int main()
+{
+  FELCalendarQueue sorter;
+  Reference ref;
+
+  fill(sorter, ref, 1000, 1.0);
+  sorter.init(true);
+  runEvents(sorter, ref, 100000, 1.0);
+
+  //A faster event rate, so the days are too wide
+  runEvents(sorter, ref, 100000, 0.01);
+
+  //A much slower event rate, so the days are too narrow and the
+  //calendar runs out of events before the end of a year
+  runEvents(sorter, ref, 100000, 1000.0);
+
+  //Rescale the event times, as a SysRescale event does
+  sorter.rescaleTimes(0.5);
+  now *= 0.5;
+  for (std::vector<double>& times : ref)
+    for (double& t : times)
+      t *= 0.5;
+  runEvents(sorter, ref, 50000, 5.0);
+
+  //Rebuild the calendar in place, as the Scheduler does when the
+  //system changes
+  sorter.rebuild();
+  runEvents(sorter, ref, 50000, 5.0);
+
+  //Resize the sorter, which discards all of the events
+  fill(sorter, ref, 3000, 0.1);
+  sorter.init(true);
+  runEvents(sorter, ref, 50000, 0.1);
+
+  //A small system where the events suddenly become so rare that the
+  //calendar window is left empty, and the calendar has to jump
+  //forward to the overflow list
+  fill(sorter, ref, 20, 0.001);
+  sorter.init(true);
+  runEvents(sorter, ref, 5000, 0.001);
+  runEvents(sorter, ref, 5000, 1e6);
+
+  std::cout << "The calendar queue returned the correct events" << std::endl;
+}
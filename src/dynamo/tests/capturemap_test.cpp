@@ -0,0 +1,125 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* A test of the hashed store of the ICapture pair states.
+
+   The same random sequence of state changes is applied to an ordered
+   CaptureStore and to a hashed CaptureStore (with an ordered view),
+   and the lookups, the iterated pairs and the ordered view are
+   compared. The stores are also switched between the two containers
+   part way through.
+*/
+
+#include <dynamo/interactions/captures.hpp>
+#include <iostream>
+#include <stdexcept>
+#include <random>
+#include <map>
+
+using namespace dynamo;
+using namespace dynamo::detail;
+
+std::mt19937 RNG(1234);
+
+void check(const CaptureStore& ordered, const CaptureStore& hashed, const size_t N)
+{
+  if (ordered.size() != hashed.size())
+    throw std::runtime_error("The stores hold a different number of pairs");
+
+  if (ordered.getOrdered() != hashed.getOrdered())
+    throw std::runtime_error("The ordered view of the hashed store differs from the ordered store");
+
+  //The pairs iterated over must match, in any order
+  CaptureMap pairs;
+  for (const CaptureHashMap::value_type& IDs : hashed.getPairs())
+    {
+      if (pairs[IDs.first])
+	throw std::runtime_error("A pair was iterated over twice");
+      pairs[IDs.first] = IDs.second;
+    }
+  if (pairs != ordered.getOrdered())
+    throw std::runtime_error("The pairs of the hashed store differ from the ordered store");
+
+  for (size_t i(0); i < 1000; ++i)
+    {
+      const size_t ID1 = RNG() % N, ID2 = RNG() % N;
+      if (ID1 == ID2) continue;
+      const PairKey key(ID1, ID2);
+      if (ordered[key] != hashed[key])
+	throw std::runtime_error("A lookup in the hashed store differs from the ordered store");
+    }
+}
+
+void randomChanges(CaptureStore& ordered, CaptureStore& hashed, const size_t N, const size_t changes)
+{
+  std::uniform_int_distribution<size_t> ID(0, N - 1);
+  std::uniform_int_distribution<size_t> state(0, 3);
+  for (size_t i(0); i < changes; ++i)
+    {
+      const size_t ID1 = ID(RNG), ID2 = ID(RNG);
+      if (ID1 == ID2) continue;
+      const size_t val = state(RNG);
+      ordered.set(PairKey(ID1, ID2), val);
+      hashed.set(PairKey(ID1, ID2), val);
+    }
+}
+
+int main()
+{
+  const size_t N = 200;
+  CaptureStore ordered, hashed;
+  hashed.setHashed(true);
+  hashed.keepOrderedView();
+
+  for (size_t i(0); i < 20; ++i)
+    {
+      randomChanges(ordered, hashed, N, 5000);
+      check(ordered, hashed, N);
+    }
+
+  //Move the pairs between the containers, keeping the view
+  hashed.setHashed(false);
+  check(ordered, hashed, N);
+  randomChanges(ordered, hashed, N, 5000);
+  hashed.setHashed(true);
+  check(ordered, hashed, N);
+  randomChanges(ordered, hashed, N, 5000);
+  check(ordered, hashed, N);
+
+  //The view can be requested once the hashed store is filled
+  CaptureStore late;
+  late.setHashed(true);
+  for (const CaptureMap::value_type& IDs : ordered.getOrdered())
+    late.set(IDs.first, IDs.second);
+  late.keepOrderedView();
+  check(ordered, late, N);
+
+  //Without the view, the ordered map is not available
+  CaptureStore noView;
+  noView.setHashed(true);
+  bool thrown = false;
+  try { noView.getOrdered(); }
+  catch (std::exception&) { thrown = true; }
+  if (!thrown)
+    throw std::runtime_error("The ordered view of a hashed store was returned without keepOrderedView()");
+
+  ordered.clear();
+  hashed.clear();
+  check(ordered, hashed, N);
+
+  std::cout << "The hashed and ordered capture stores agree" << std::endl;
+}
@@ -0,0 +1,130 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* A benchmark of the Particle Event Lists in the FELBoundedPQ.
+
+   This drives the sorter with the same pattern of calls the Scheduler
+   makes when it executes events, using a synthetic event time
+   distribution, and counts the number of heap allocations made per
+   event once the sorter has reached a steady state.
+*/
+
+#include <dynamo/schedulers/sorters/include.hpp>
+#include <iostream>
+#include <stdexcept>
+#include <random>
+#include <cstdlib>
+#include <new>
+#include <time.h>
+
+namespace {
+  size_t allocations = 0;
+}
+
+void* operator new(size_t size)
+{
+  ++allocations;
+  if (void* ptr = std::malloc(size)) return ptr;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) throw() { std::free(ptr); }
+
+using namespace dynamo;
+
+const size_t N = 10000;
+const size_t warmupEvents = 2000000;
+const size_t measuredEvents = 2000000;
+
+//Refill the PEL of a particle, as Scheduler::fullUpdate() would
+void addEvents(FEL& sorter, const size_t ID, std::mt19937& RNG)
+{
+  std::uniform_int_distribution<size_t> eventCount(1, 12);
+  std::uniform_int_distribution<size_t> partner(0, N - 1);
+  std::exponential_distribution<double> dt(1.0);
+
+  const size_t events = eventCount(RNG);
+  for (size_t i(0); i < events; ++i)
+    sorter.push(Event(dt(RNG), INTERACTION, partner(RNG), 0), ID);
+}
+
+void runEvent(FEL& sorter, std::mt19937& RNG)
+{
+  sorter.sort();
+  std::pair<size_t, Event> next = sorter.next();
+  sorter.stream(next.second.dt);
+
+  //Sometimes treat the event as invalid (e.g., lazily deleted), so
+  //the next event in the PEL is used and a replacement is added
+  if (RNG() % 2)
+    {
+      sorter.popNextEvent();
+      std::exponential_distribution<double> dt(1.0);
+      sorter.push(Event(dt(RNG), INTERACTION, 0, 0), next.first);
+      sorter.update(next.first);
+      return;
+    }
+
+  sorter.clearPEL(next.first);
+  addEvents(sorter, next.first, RNG);
+  sorter.update(next.first);
+}
+
+template<class T>
+double benchmark()
+{
+  std::mt19937 RNG(1234);
+  FELBoundedPQ<T> sorter;
+  sorter.resize(N);
+  for (size_t i(0); i < N; ++i)
+    addEvents(sorter, i, RNG);
+  sorter.init(true);
+
+  for (size_t i(0); i < warmupEvents; ++i)
+    runEvent(sorter, RNG);
+
+  const size_t startAllocations = allocations;
+  timespec startTime, endTime;
+  clock_gettime(CLOCK_MONOTONIC, &startTime);
+  for (size_t i(0); i < measuredEvents; ++i)
+    runEvent(sorter, RNG);
+  clock_gettime(CLOCK_MONOTONIC, &endTime);
+  const double seconds = double(endTime.tv_sec) - double(startTime.tv_sec)
+    + 1e-9 * (double(endTime.tv_nsec) - double(startTime.tv_nsec));
+
+  const double allocsPerEvent = double(allocations - startAllocations) / measuredEvents;
+  std::cout << FELBoundedPQName<T>::name()
+	    << ": " << measuredEvents / seconds << " events/s, "
+	    << allocsPerEvent << " allocations/event" << std::endl;
+
+  return allocsPerEvent;
+}
+
+int main()
+{
+  std::cout << "sizeof(Event) = " << sizeof(Event)
+	    << ", sizeof(PELCompactEvent) = " << sizeof(PELCompactEvent) << std::endl;
+
+  benchmark<PELHeap>();
+  benchmark<PELMinMax<8> >();
+
+  if (benchmark<PELCompact<8> >() != 0)
+    throw std::runtime_error("PELCompact made heap allocations in its steady state");
+
+  if (benchmark<PELCompact<4> >() != 0)
+    throw std::runtime_error("PELCompact made heap allocations in its steady state, when spilling events");
+}
@@ -0,0 +1,142 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* A test of the bounding volume hierarchy of LTriangleMesh.
+
+   Particles are fired at a mesh of a closed box and a soup of random
+   triangles, and the event found using the BVH is checked against
+   a test of every triangle. The event time, the triangle and the
+   part of the triangle must all match.
+*/
+
+#include <dynamo/simulation.hpp>
+#include <dynamo/locals/trianglemesh.hpp>
+#include <dynamo/locals/localEvent.hpp>
+#include <dynamo/dynamics/newtonian.hpp>
+#include <dynamo/BC/None.hpp>
+#include <dynamo/ranges/IDRangeAll.hpp>
+#include <iostream>
+#include <stdexcept>
+#include <random>
+
+using namespace dynamo;
+
+std::mt19937 RNG(1234);
+
+//Exposes the BVH and the linear search of the mesh
+class TestMesh: public LTriangleMesh
+{
+public:
+  TestMesh(Simulation* sim, double diameter):
+    LTriangleMesh(sim, 1.0, diameter, "Mesh", new IDRangeAll(sim))
+  {}
+
+  void addTriangle(const Vector& A, const Vector& B, const Vector& C)
+  {
+    const size_t id = _vertices.size();
+    _vertices.push_back(A);
+    _vertices.push_back(B);
+    _vertices.push_back(C);
+    _elements.push_back(TriangleElements(id, id + 1, id + 2));
+  }
+
+  void build() { buildBVH(); }
+
+  using LTriangleMesh::getEventLinear;
+  using LTriangleMesh::getEventBVH;
+};
+
+Vector randomVector(double scale)
+{
+  std::uniform_real_distribution<double> uniform(-scale, scale);
+  return Vector(uniform(RNG), uniform(RNG), uniform(RNG));
+}
+
+int main()
+{
+  Simulation sim;
+  sim.dynamics = shared_ptr<Dynamics>(new DynNewtonian(&sim));
+  sim.BCs = shared_ptr<BoundaryCondition>(new BCNone(&sim));
+
+  TestMesh mesh(&sim, 1.0);
+
+  //The faces of a closed cube of side 20
+  const double L = 10;
+  for (size_t axis(0); axis < 3; ++axis)
+    for (const double side : {-L, L})
+      {
+	Vector corners[4];
+	for (size_t i(0); i < 4; ++i)
+	  {
+	    corners[i][axis] = side;
+	    corners[i][(axis + 1) % 3] = (i & 1) ? L : -L;
+	    corners[i][(axis + 2) % 3] = (i & 2) ? L : -L;
+	  }
+	mesh.addTriangle(corners[0], corners[1], corners[3]);
+	mesh.addTriangle(corners[0], corners[3], corners[2]);
+      }
+
+  //A soup of small random triangles inside the cube, some of which
+  //share an edge or a corner
+  for (size_t i(0); i < 2000; ++i)
+    {
+      const Vector A = randomVector(0.8 * L);
+      const Vector B = A + randomVector(1.0);
+      const Vector C = (i % 3) ? Vector(B + randomVector(1.0)) : Vector(A + 2 * (B - A));
+      if (((B - A) ^ (C - A)).nrm() > 1e-3)
+	mesh.addTriangle(A, B, C);
+    }
+
+  mesh.build();
+
+  size_t mismatches = 0, events = 0;
+  std::normal_distribution<double> normal;
+  for (size_t ID(0); ID < 20000; ++ID)
+    {
+      Vector vel(normal(RNG), normal(RNG), normal(RNG));
+      //Some particles move along an axis, so the rays are parallel
+      //to the faces of the bounding boxes
+      if (ID % 10 == 0)
+	{
+	  vel = Vector(0, 0, 0);
+	  vel[ID % 3] = 1;
+	}
+      const Particle part(randomVector(0.9 * L), vel, ID);
+
+      const LocalEvent bvh = mesh.getEventBVH(part);
+      const LocalEvent linear = mesh.getEventLinear(part);
+
+      if (linear.getdt() != HUGE_VAL) ++events;
+      if ((bvh.getdt() != linear.getdt()) || (bvh.getExtraData() != linear.getExtraData()))
+	{
+	  if (mismatches < 10)
+	    std::cerr << "Particle " << ID << ": the BVH found dt=" << bvh.getdt() 
+		      << " (data " << bvh.getExtraData() << "), a test of every triangle found dt=" 
+		      << linear.getdt() << " (data " << linear.getExtraData() << ")" << std::endl;
+	  ++mismatches;
+	}
+    }
+
+  //Every particle is inside the cube, so it must hit something
+  if (events != 20000)
+    throw std::runtime_error("Particles escaped the closed mesh");
+
+  if (mismatches)
+    throw std::runtime_error("The BVH and the linear search found different events");
+
+  std::cout << "The BVH and the linear search found the same " << events << " events" << std::endl;
+}
@@ -0,0 +1,107 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <magnet/exception.hpp>
+#include <array>
+#include <vector>
+
+namespace magnet {
+  namespace containers {
+    /*! \brief A contiguous container which stores up to N elements
+      without allocating.
+
+      The first N elements are stored in a fixed array inside the
+      container. When more are added, all of the elements are moved
+      to a std::vector, which is then used until the container is
+      cleared. clear() keeps the capacity of the std::vector, so a
+      container which is cleared and refilled stops allocating once
+      it has grown to its largest size.
+
+      \tparam T Stored type, which must be default constructible and
+      copy assignable.
+      \tparam N The number of elements stored without allocating.
+    */
+    template <typename T, std::size_t N>
+    class SmallVector
+    {
+    public:
+      typedef T value_type;
+      typedef T* iterator;
+      typedef const T* const_iterator;
+
+      SmallVector(): _localSize(0) {}
+
+      inline iterator begin() { return _heap.empty() ? _local.data() : _heap.data(); }
+      inline const_iterator begin() const { return _heap.empty() ? _local.data() : _heap.data(); }
+      inline iterator end() { return begin() + size(); }
+      inline const_iterator end() const { return begin() + size(); }
+
+      inline size_t size() const { return _heap.empty() ? _localSize : _heap.size(); }
+      inline bool empty() const { return size() == 0; }
+
+      inline T& operator[](size_t i) { return begin()[i]; }
+      inline const T& operator[](size_t i) const { return begin()[i]; }
+
+      inline T& front() { return *begin(); }
+      inline const T& front() const { return *begin(); }
+      inline T& back() { return *(end() - 1); }
+      inline const T& back() const { return *(end() - 1); }
+
+      inline void push_back(const T& val)
+      {
+	if (_heap.empty())
+	  {
+	    if (_localSize < N)
+	      {
+		_local[_localSize++] = val;
+		return;
+	      }
+
+	    //Move the elements to the heap storage
+	    _heap.reserve(std::max(2 * (N + 1), _heap.capacity()));
+	    _heap.assign(_local.begin(), _local.begin() + _localSize);
+	    _localSize = 0;
+	  }
+
+	_heap.push_back(val);
+      }
+
+      /*! \brief Ensure n elements can be stored without further
+        allocation.
+      */
+      inline void reserve(size_t n)
+      {
+	if (n > N) _heap.reserve(n);
+      }
+
+      /*! \brief Remove all the elements, keeping any allocated storage.
+       */
+      inline void clear()
+      {
+	_localSize = 0;
+	_heap.clear();
+      }
+
+    private:
+      std::array<T, N> _local;
+      size_t _localSize;
+      std::vector<T> _heap;
+    };
+  }
+}
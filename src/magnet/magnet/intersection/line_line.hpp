@@ -18,6 +18,7 @@
 #pragma once
 #include <magnet/math/vector.hpp>
 #include <magnet/math/quaternion.hpp>
+#include <magnet/math/rotatingvector.hpp>
 #include <magnet/math/frenkelroot.hpp>
 
 namespace magnet {
@@ -32,23 +33,27 @@ namespace magnet {
 			 const math::Vector& nw1, const math::Vector& nw2, 
 			 const math::Quaternion& nq1, const math::Quaternion& nq2,
 			 const double& length):
-	  w1(nw1), w2(nw2), q1(nq1), q2(nq2),
+	  w1(nw1), w2(nw2),
 	  w12(nw1 - nw2), r12(nr12), v12(nv12),
-	  _length(length)
+	  u1(nq1 * math::Quaternion::initialDirector()),
+	  u2(nq2 * math::Quaternion::initialDirector()),
+	  _rot1(u1, nw1), _rot2(u2, nw2),
+	  w1xw2(nw1 ^ nw2), _length(length), _evaluated(false)
 	{
-	  u1 = q1 * math::Quaternion::initialDirector();
-	  u2 = q2 * math::Quaternion::initialDirector();
+	  //The bounds on the derivatives do not change as the rods move
+	  _f1max = _length * w12.nrm() + v12.nrm();
+	  _f2max = w12.nrm() 
+	    * ((2 * v12.nrm()) + (_length * (w1.nrm() + w2.nrm())));
 	}
 
 	void stream(const double& dt)
 	{
-	  q1 = math::Quaternion::fromRotationAxis(w1 * dt) * q1;
-	  q1.normalise();
-	  q2 = math::Quaternion::fromRotationAxis(w2 * dt) * q2;
-	  q2.normalise();
+	  _rot1.stream(dt);
+	  _rot2.stream(dt);
 	  r12 += v12 * dt;
-	  u1 = q1 * math::Quaternion::initialDirector();
-	  u2 = q2 * math::Quaternion::initialDirector();
+	  u1 = _rot1.get();
+	  u2 = _rot2.get();
+	  _evaluated = false;
 	}
   
 	std::pair<double, double> getCollisionPoints() const
@@ -61,31 +66,19 @@ namespace magnet {
 				(rijdotuj - (rijdotui * uidotuj)) / (1.0 - uidotuj*uidotuj));
 	}
     
+	/*! \brief The value of the overlap function, or one of its
+	  derivatives.
+
+	  The root finders ask for several derivatives at each time, so
+	  all of them are evaluated together (sharing the dot products
+	  between them) on the first call after the rods are moved.
+	 */
 	template<size_t deriv> 
 	double eval() const
 	{
-	  switch (deriv)
-	    {
-	    case 0:
-	      return ((u1 ^ u2) | r12);
-	    case 1:
-	      return ((u1 | r12) * (w12 | u2)) 
-		+ ((u2 | r12) * (w12 | u1)) 
-		- ((w12 | r12) * (u1 | u2)) 
-		+ (((u1 ^ u2) | v12));
-	    case 2:
-	      return 2.0 
-		* (((u1 | v12) * (w12 | u2)) 
-		   + ((u2 | v12) * (w12 | u1))
-		   - ((u1 | u2) * (w12 | v12)))
-		- ((w12 | r12) * (w12 | (u1 ^ u2))) 
-		+ ((u1 | r12) * (u2 | (w1 ^ w2))) 
-		+ ((u2 | r12) * (u1 | (w1 ^ w2)))
-		+ ((w12 | u1) * (r12 | (w2 ^ u2)))
-		+ ((w12 | u2) * (r12 | (w1 ^ u1))); 
-	    default:
-	      M_throw() << "Invalid access";
-	    }
+	  if (deriv > 2) M_throw() << "Invalid access";
+	  if (!_evaluated) evaluate();
+	  return _f[deriv];
 	}
     
 	template<size_t deriv> 
@@ -94,10 +87,9 @@ namespace magnet {
 	  switch (deriv)
 	    {
 	    case 1:
-	      return _length * w12.nrm() + v12.nrm();
+	      return _f1max;
 	    case 2:
-	      return w12.nrm() 
-		* ((2 * v12.nrm()) + (_length * (w1.nrm() + w2.nrm())));
+	      return _f2max;
 	    default:
 	      M_throw() << "Invalid access";
 	    }
@@ -134,16 +126,44 @@ namespace magnet {
 	}
   
       private:
+	void evaluate() const
+	{
+	  const math::Vector u1xu2 = u1 ^ u2;
+	  const double u1dotr12 = u1 | r12, u2dotr12 = u2 | r12,
+	    w12dotu1 = w12 | u1, w12dotu2 = w12 | u2, 
+	    w12dotr12 = w12 | r12, u1dotu2 = u1 | u2;
+
+	  _f[0] = u1xu2 | r12;
+	  _f[1] = (u1dotr12 * w12dotu2) 
+	    + (u2dotr12 * w12dotu1) 
+	    - (w12dotr12 * u1dotu2) 
+	    + (u1xu2 | v12);
+	  _f[2] = 2.0 
+	    * (((u1 | v12) * w12dotu2) 
+	       + ((u2 | v12) * w12dotu1)
+	       - (u1dotu2 * (w12 | v12)))
+	    - (w12dotr12 * (w12 | u1xu2)) 
+	    + (u1dotr12 * (u2 | w1xw2)) 
+	    + (u2dotr12 * (u1 | w1xw2))
+	    + (w12dotu1 * (r12 | (w2 ^ u2)))
+	    + (w12dotu2 * (r12 | (w1 ^ u1)));
+	  _evaluated = true;
+	}
+
 	const math::Vector& w1;
 	const math::Vector& w2;
-	math::Quaternion q1;
-	math::Quaternion q2;
 	math::Vector w12;
 	math::Vector r12;
 	math::Vector v12;
 	math::Vector u1, u2;
+	math::RotatingVector _rot1, _rot2;
+	math::Vector w1xw2;
 
 	const double _length;
+	double _f1max, _f2max;
+	//! \brief The cached values of the overlap function and its derivatives.
+	mutable double _f[3];
+	mutable bool _evaluated;
       };
     }
 
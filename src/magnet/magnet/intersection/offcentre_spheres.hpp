@@ -18,6 +18,7 @@
 #pragma once
 #include <magnet/math/vector.hpp>
 #include <magnet/math/quaternion.hpp>
+#include <magnet/math/rotatingvector.hpp>
 #include <magnet/intersection/generic_algorithm.hpp>
 
 namespace magnet {
@@ -32,7 +33,8 @@ namespace magnet {
 	OffcentreSpheresOverlapFunction(const math::Vector& rij, const math::Vector& vij, const math::Vector& omegai, const math::Vector& omegaj,
 					const math::Vector& nu1, const math::Vector& nu2, const double diameter1, const double diameter2, 
 					const double maxdist):
-	  w1(omegai), w2(omegaj), u1(nu1), u2(nu2), r12(rij), v12(vij), _diameter1(diameter1), _diameter2(diameter2)
+	  w1(omegai), w2(omegaj), u1(nu1), u2(nu2), _rot1(nu1, omegai), _rot2(nu2, omegaj),
+	  r12(rij), v12(vij), _diameter1(diameter1), _diameter2(diameter2), _evaluated(false)
 	{
 	  double magw1 = w1.nrm(), magw2 = w2.nrm();
 	  double rijmax = u1.nrm() + u2.nrm() + maxdist;
@@ -46,29 +48,27 @@ namespace magnet {
 
 	void stream(const double& dt)
 	{
-	  u1 = Rodrigues(w1 * dt) * math::Vector(u1);
-	  u2 = Rodrigues(w2 * dt) * math::Vector(u2);
+	  _rot1.stream(dt);
+	  _rot2.stream(dt);
+	  u1 = _rot1.get();
+	  u2 = _rot2.get();
 	  r12 += v12 * dt;
+	  _evaluated = false;
 	}
   
+	/*! \brief The value of the overlap function, or one of its
+	  derivatives.
+
+	  All of the derivatives are evaluated together on the first
+	  call after the spheres are moved, as they share the relative
+	  position, velocity and acceleration of the spheres.
+	 */
 	template<size_t deriv> 
 	double eval() const
 	{
-	  double colldiam = 0.5 * (_diameter1 + _diameter2);
-	  const math::Vector rij = r12 + u1 - u2;
-	  const math::Vector vij = v12 + (w1 ^ u1) - (w2 ^ u2);
-	  const math::Vector aij = -w1.nrm2() * u1 + w2.nrm2() * u2;
-	  const math::Vector dotaij = -w1.nrm2() * (w1 ^ u1) + w2.nrm2() * (w2 ^ u2);
-
-	  switch (deriv)
-	    {
-	    case 0: return (rij | rij) - colldiam * colldiam;
-	    case 1: return 2 * (rij | vij);
-	    case 2: return 2 * vij.nrm2() + 2 * (rij | aij);
-	    case 3: return 6 * (vij | aij) + 2 * (rij | dotaij);
-	    default:
-	      M_throw() << "Invalid access";
-	    }
+	  if (deriv > 3) M_throw() << "Invalid access";
+	  if (!_evaluated) evaluate();
+	  return _f[deriv];
 	}
     
 	template<size_t deriv> 
@@ -94,15 +94,36 @@ namespace magnet {
 	bool test_root() const { return true; }
 
       private:
+	void evaluate() const
+	{
+	  double colldiam = 0.5 * (_diameter1 + _diameter2);
+	  const math::Vector w1xu1 = w1 ^ u1;
+	  const math::Vector w2xu2 = w2 ^ u2;
+	  const math::Vector rij = r12 + u1 - u2;
+	  const math::Vector vij = v12 + w1xu1 - w2xu2;
+	  const math::Vector aij = -w1.nrm2() * u1 + w2.nrm2() * u2;
+	  const math::Vector dotaij = -w1.nrm2() * w1xu1 + w2.nrm2() * w2xu2;
+
+	  _f[0] = (rij | rij) - colldiam * colldiam;
+	  _f[1] = 2 * (rij | vij);
+	  _f[2] = 2 * vij.nrm2() + 2 * (rij | aij);
+	  _f[3] = 6 * (vij | aij) + 2 * (rij | dotaij);
+	  _evaluated = true;
+	}
+
 	const math::Vector& w1;
 	const math::Vector& w2;
 	math::Vector u1;
 	math::Vector u2;
+	math::RotatingVector _rot1, _rot2;
 	math::Vector r12;
 	math::Vector v12;
 
 	const double _diameter1, _diameter2;
 	double _f1max, _f2max, _f3max;
+	//! \brief The cached values of the overlap function and its derivatives.
+	mutable double _f[4];
+	mutable bool _evaluated;
       };
 
       /*! \brief The overlap function and its derivatives for two
@@ -114,7 +135,9 @@ namespace magnet {
 	OffcentreGrowingSpheresOverlapFunction(const math::Vector& rij, const math::Vector& vij, const math::Vector& omegai, const math::Vector& omegaj,
 					       const math::Vector& nu1, const math::Vector& nu2, const double diameter1, const double diameter2, 
 					       const double maxdist, const double t, const double invgamma, const double t_max):
-	  w1(omegai), w2(omegaj), u1(nu1), u2(nu2), r12(rij), v12(vij), _diameter1(diameter1), _diameter2(diameter2), _invgamma(invgamma), _t_max(t_max), _t(t)
+	  w1(omegai), w2(omegaj), u1(nu1), u2(nu2), _rot1(nu1, omegai), _rot2(nu2, omegaj),
+	  r12(rij), v12(vij), _diameter1(diameter1), _diameter2(diameter2), _invgamma(invgamma), _t_max(t_max), _t(t),
+	  _evaluated(false)
 	{
 	  double Gmax = std::max(1 + t * invgamma, 1 + (t + t_max) * invgamma);
 	  const double sigmaij = 0.5 * (_diameter1 + _diameter2);
@@ -133,31 +156,22 @@ namespace magnet {
 
 	void stream(const double& dt)
 	{
-	  u1 = Rodrigues(w1 * dt) * math::Vector(u1);
-	  u2 = Rodrigues(w2 * dt) * math::Vector(u2);
+	  _rot1.stream(dt);
+	  _rot2.stream(dt);
+	  u1 = _rot1.get();
+	  u2 = _rot2.get();
 	  _t += dt;
 	  r12 += v12 * dt;
+	  _evaluated = false;
 	}
   
+	//! \sa OffcentreSpheresOverlapFunction::eval()
 	template<size_t deriv> 
 	double eval() const
 	{
-	  const double colldiam = 0.5 * (_diameter1 + _diameter2);
-	  const double growthfactor = 1 + _invgamma * _t;
-	  const math::Vector rij = r12 + growthfactor * (u1 - u2);
-	  const math::Vector vij = v12 + growthfactor * ((w1 ^ u1) - (w2 ^ u2)) + _invgamma * (u1 - u2);
-	  const math::Vector aij = growthfactor * (-w1.nrm2() * u1 + w2.nrm2() * u2) + 2 * _invgamma * ((w1 ^ u1) - (w2 ^ u2));
-	  const math::Vector dotaij = growthfactor * (-w1.nrm2() * (w1 ^ u1) + w2.nrm2() * (w2 ^ u2)) + 3 * _invgamma * (-w1.nrm2() * u1 + w2.nrm2() * u2);
-
-	  switch (deriv)
-	    {
-	    case 0: return (rij | rij) - growthfactor * growthfactor * colldiam * colldiam;
-	    case 1: return 2 * (rij | vij) - 2 * _invgamma * growthfactor * colldiam * colldiam;
-	    case 2: return 2 * vij.nrm2() + 2 * (rij | aij) - 2 * _invgamma * _invgamma * colldiam * colldiam;
-	    case 3: return 6 * (vij | aij) + 2 * (rij | dotaij);
-	    default:
-	      M_throw() << "Invalid access";
-	    }
+	  if (deriv > 3) M_throw() << "Invalid access";
+	  if (!_evaluated) evaluate();
+	  return _f[deriv];
 	}
     
 	template<size_t deriv> 
@@ -183,15 +197,37 @@ namespace magnet {
 	bool test_root() const { return true; }
 
       private:
+	void evaluate() const
+	{
+	  const double colldiam = 0.5 * (_diameter1 + _diameter2);
+	  const double growthfactor = 1 + _invgamma * _t;
+	  const math::Vector w1xu1 = w1 ^ u1;
+	  const math::Vector w2xu2 = w2 ^ u2;
+	  const math::Vector rij = r12 + growthfactor * (u1 - u2);
+	  const math::Vector vij = v12 + growthfactor * (w1xu1 - w2xu2) + _invgamma * (u1 - u2);
+	  const math::Vector aij = growthfactor * (-w1.nrm2() * u1 + w2.nrm2() * u2) + 2 * _invgamma * (w1xu1 - w2xu2);
+	  const math::Vector dotaij = growthfactor * (-w1.nrm2() * w1xu1 + w2.nrm2() * w2xu2) + 3 * _invgamma * (-w1.nrm2() * u1 + w2.nrm2() * u2);
+
+	  _f[0] = (rij | rij) - growthfactor * growthfactor * colldiam * colldiam;
+	  _f[1] = 2 * (rij | vij) - 2 * _invgamma * growthfactor * colldiam * colldiam;
+	  _f[2] = 2 * vij.nrm2() + 2 * (rij | aij) - 2 * _invgamma * _invgamma * colldiam * colldiam;
+	  _f[3] = 6 * (vij | aij) + 2 * (rij | dotaij);
+	  _evaluated = true;
+	}
+
 	const math::Vector& w1;
 	const math::Vector& w2;
 	math::Vector u1;
 	math::Vector u2;
+	math::RotatingVector _rot1, _rot2;
 	math::Vector r12;
 	math::Vector v12;
 
 	const double _diameter1, _diameter2, _invgamma, _t_max;
 	double _t, _f1max, _f2max, _f3max;
+	//! \brief The cached values of the overlap function and its derivatives.
+	mutable double _f[4];
+	mutable bool _evaluated;
       };
     }
 
@@ -0,0 +1,68 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <magnet/math/vector.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace magnet {
+  namespace intersection {
+    /*! \brief A ray->Axis-Aligned-Bounding-Box entry test.
+
+      Unlike ray_AAcube, this test has no back face culling. It is
+      intended for culling tests in bounding volume hierarchies,
+      where a ray which starts inside the box must always be
+      considered as intersecting it.
+
+      \param T The origin of the ray.
+      \param D The direction/velocity of the ray.
+      \param min The lower corner of the box.
+      \param max The upper corner of the box.
+      \return The time until the ray enters the box, zero if the ray
+      starts inside it, or HUGE_VAL if no intersection.
+    */
+    inline double ray_AABB(const math::Vector& T, const math::Vector& D,
+			   const math::Vector& min, const math::Vector& max)
+    {
+      double time_in = 0;
+      double time_out = HUGE_VAL;
+
+      for (size_t i(0); i < 3; ++i)
+	{
+	  if (D[i] == 0)
+	    {//The ray can only intersect if its already in this range
+	      if ((T[i] < min[i]) || (T[i] > max[i]))
+		return HUGE_VAL;
+	      continue;
+	    }
+
+	  double t1 = (min[i] - T[i]) / D[i];
+	  double t2 = (max[i] - T[i]) / D[i];
+	  if (t1 > t2) std::swap(t1, t2);
+
+	  time_in = std::max(time_in, t1);
+	  time_out = std::min(time_out, t2);
+
+	  if (time_in > time_out)
+	    return HUGE_VAL;
+	}
+
+      return time_in;
+    }
+  }
+}
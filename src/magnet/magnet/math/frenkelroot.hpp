@@ -82,14 +82,10 @@ namespace magnet {
 	    if (f0 > 0) halff2max = -halff2max;
 	    
 	    std::pair<double, double> worst_case_roots;
-	    try {
-	      worst_case_roots = quadraticEquation(halff2max, f1, f0);
-	    } catch (NoQuadraticRoots&)
-	      {
-		M_throw() << "When trying to improve the bounds using worst-case estimates, it was "
-		  "found that they could not be improved. This implies there is "
-		  "implementation error (zero max 2nd deriv?) in the passed function.";
-	      }
+	    if (!quadraticEquation(halff2max, f1, f0, worst_case_roots))
+	      M_throw() << "When trying to improve the bounds using worst-case estimates, it was "
+		"found that they could not be improved. This implies there is "
+		"implementation error (zero max 2nd deriv?) in the passed function.";
 
 	    //Sort the roots
 	    if (worst_case_roots.first > worst_case_roots.second) std::swap(worst_case_roots.first, worst_case_roots.second);
@@ -108,11 +104,8 @@ namespace magnet {
 	    
 	    //Now perform the first step of the shooting
 	    std::pair<double, double> estimate_roots;
-	    try {
-	      estimate_roots = quadraticEquation(halff2, f1, f0);
-	    } catch (NoQuadraticRoots&)
-	      //If the shooting fails, restart from the other boundary
-	      { continue; }
+	    //If the shooting fails, restart from the other boundary
+	    if (!quadraticEquation(halff2, f1, f0, estimate_roots)) continue;
 	    
 	    //Sort the roots
 	    if (estimate_roots.first > estimate_roots.second) std::swap(estimate_roots.first, estimate_roots.second);
@@ -154,15 +147,15 @@ namespace magnet {
 
 	      tempfL.stream(deltaT);
 
-	      try {
-		std::pair<double, double> estimate_roots = quadraticEquation(0.5 * tempfL.template eval<2>(), tempfL.template eval<1>(), tempfL.template eval<0>());
-		if (std::abs(estimate_roots.first) < std::abs(estimate_roots.second))
-		  deltaT = estimate_roots.first;
-		else
-		  deltaT = estimate_roots.second;
-	      } catch (NoQuadraticRoots&)
-		//If the shooting fails, quit the loop
-		{ break; }
+	      std::pair<double, double> estimate_roots;
+	      //If the shooting fails, quit the loop
+	      if (!quadraticEquation(0.5 * tempfL.template eval<2>(), tempfL.template eval<1>(), tempfL.template eval<0>(), estimate_roots))
+		break;
+
+	      if (std::abs(estimate_roots.first) < std::abs(estimate_roots.second))
+		deltaT = estimate_roots.first;
+	      else
+		deltaT = estimate_roots.second;
 
 	      if (fabs(deltaT) <  timescale)
 		return std::pair<bool,double>(true, working_time + deltaT);
@@ -63,7 +63,7 @@ namespace magnet {
     }
 
     /*! \brief Solves a quadratic equation of the form
-        \f$a\,x^2+b\,x+c=0\f$ for the real roots.
+        \f$a\,x^2+b\,x+c=0\f$ for the real roots, without throwing.
 
 	This implementation avoids a catastrophic cancellation of
 	errors. See the following link for more details:
@@ -72,42 +72,61 @@ namespace magnet {
 	It also handles the case when the polynomial being a linear
 	function (\f$a=0\f$).
 
-	\throw NoQuadraticRoots If \f$a=0\f$ and \f$b=0\f$ (this equation is
-	not a function of \f$x\f$) or if the roots are complex.
-	
-	\sa quadraticEquationComplex
+	This is intended for inner loops (e.g., root finders) where a
+	missing root is a normal outcome, and throwing an exception
+	would dominate the cost of the solution.
 
-	\return The roots of the quadratic.
+	\param roots Set to the roots of the quadratic, if there are any.
+
+	\return false if \f$a=0\f$ and \f$b=0\f$ (this equation is not a
+	function of \f$x\f$) or if the roots are complex.
      */
-    inline std::pair<double, double>
-    quadraticEquation(const double a, const double b, const double c)
+    inline bool
+    quadraticEquation(const double a, const double b, const double c, std::pair<double, double>& roots)
     {
       if (a == 0)
 	{
-	  if (b == 0) throw NoQuadraticRoots();
+	  if (b == 0) return false;
 	  double root = - c / b;
-	  return std::make_pair(root, root);
+	  roots = std::make_pair(root, root);
+	  return true;
 	}
       
       double discriminant = b * b - 4 * a * c;
-      if (discriminant < 0) throw NoQuadraticRoots();
+      if (discriminant < 0) return false;
       double arg = std::sqrt(discriminant);
       double q = -0.5 * ( b + ((b < 0) ? -arg : arg));
       
-      return std::make_pair(q / a, c / q);
+      roots = std::make_pair(q / a, c / q);
+      return true;
+    }
+
+    /*! \brief Solves a quadratic equation of the form
+        \f$a\,x^2+b\,x+c=0\f$ for the real roots.
+
+	\throw NoQuadraticRoots If \f$a=0\f$ and \f$b=0\f$ (this equation is
+	not a function of \f$x\f$) or if the roots are complex.
+	
+	\sa quadraticEquationComplex
+
+	\return The roots of the quadratic.
+     */
+    inline std::pair<double, double>
+    quadraticEquation(const double a, const double b, const double c)
+    {
+      std::pair<double, double> roots;
+      if (!quadraticEquation(a, b, c, roots)) throw NoQuadraticRoots();
+      return roots;
     }
     
     inline bool 
     quadSolve(const double& C, const double& B, const double& A, 
 	      double& root1, double& root2)
     {
-      try {
-	std::pair<double, double> roots = quadraticEquation(A, B, C);
-	root1 = roots.first; root2 = roots.second;
-	return true;
-      }
-      catch (NoQuadraticRoots&)
-	{ return false; }
+      std::pair<double, double> roots;
+      if (!quadraticEquation(A, B, C, roots)) return false;
+      root1 = roots.first; root2 = roots.second;
+      return true;
     }
   }
 }
@@ -0,0 +1,73 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <magnet/math/vector.hpp>
+#include <cmath>
+
+namespace magnet {
+  namespace math {
+    /*! \brief A vector rotating at a constant angular velocity.
+
+      The vector is split into the parts parallel and perpendicular
+      to the rotation axis when it is created, so the vector at a
+      later time only needs one sine and cosine (Rodrigues' rotation
+      formula). This is cheaper than rotating the vector through
+      each time step with a rotation matrix or quaternion, and the
+      round off error does not accumulate over the steps.
+     */
+    class RotatingVector
+    {
+    public:
+      RotatingVector(const Vector& vec, const Vector& angularVelocity):
+	_angularSpeed(angularVelocity.nrm()), _time(0), _current(vec)
+      {
+	if (_angularSpeed == 0)
+	  {
+	    _parallel = vec;
+	    _cosTerm = Vector(0, 0, 0);
+	    _sinTerm = Vector(0, 0, 0);
+	    return;
+	  }
+
+	const Vector axis = angularVelocity / _angularSpeed;
+	_parallel = axis * (axis | vec);
+	_cosTerm = vec - _parallel;
+	_sinTerm = axis ^ vec;
+      }
+
+      //! \brief Rotate the vector on by a time interval.
+      inline void stream(const double dt)
+      {
+	_time += dt;
+	const double angle = _angularSpeed * _time;
+	_current = _parallel + _cosTerm * std::cos(angle) + _sinTerm * std::sin(angle);
+      }
+
+      //! \brief The current value of the vector.
+      inline const Vector& get() const { return _current; }
+
+    private:
+      double _angularSpeed;
+      double _time;
+      Vector _current;
+      Vector _parallel;
+      Vector _cosTerm;
+      Vector _sinTerm;
+    };
+  }
+}
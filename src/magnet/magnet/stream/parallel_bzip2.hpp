@@ -0,0 +1,218 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <magnet/thread/threadpool.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/filter/bzip2.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace magnet {
+  namespace stream {
+    namespace detail {
+      //! \brief Compresses the data in [begin, end) as a single bzip2 stream.
+      inline void bzip2Block(const char* begin, const char* end, std::string& output)
+      {
+	namespace io = boost::iostreams;
+	io::filtering_ostream os;
+	os.push(io::bzip2_compressor());
+	os.push(io::back_inserter(output));
+	os.write(begin, end - begin);
+	//Flushes and closes the compressor, writing the stream footer
+	os.reset();
+      }
+
+      //! \brief Compresses a block of data, returning the bzip2 stream.
+      inline std::string bzip2Data(std::shared_ptr<const std::vector<char> > data)
+      {
+	std::string output;
+	bzip2Block(data->data(), data->data() + data->size(), output);
+	return output;
+      }
+    }
+
+    /*! \brief An std::ostream which writes a multi-stream bzip2 file
+        to another stream, compressing the blocks in parallel.
+
+      The data written is split into blocks, which are compressed as
+      independent bzip2 streams and written one after another (as
+      pbzip2 does). The result is a valid bzip2 file, which bzip2
+      and the boost iostreams bzip2_decompressor read as the
+      concatenation of the blocks.
+
+      Only a few blocks are held in memory at a time, so the data is
+      never held in memory all at once. Flushing this stream does not
+      end a block, so the blocks, and the file, do not depend on how
+      the data is written or on the number of threads used.
+
+      The blocks are compressed on the ThreadPool, if it has any
+      threads. Each block is waited for individually, so other users
+      of the pool (in other threads) are not affected.
+
+      close() must be called to write the final block, the destructor
+      will close the stream but cannot report errors.
+
+      Warning: This class stores a reference to the underlying
+      ostream, which must not fall out of scope before this stream
+      does.
+     */
+    class ParallelBzip2Stream : public std::ostream
+    {
+      class ParallelBzip2Buffer: public std::streambuf
+      {
+      public:
+	ParallelBzip2Buffer(std::ostream& output, thread::ThreadPool* pool, const size_t blockSize):
+	  _output(output),
+	  _pool((pool && pool->getThreadCount()) ? pool : NULL),
+	  _blockSize(blockSize),
+	  _maxPending(_pool ? 2 * _pool->getThreadCount() : 0),
+	  _blocks(0)
+	{ newBlock(); }
+
+	void close()
+	{
+	  //An empty file is still written as one (empty) bzip2 stream
+	  if ((pptr() != pbase()) || !_blocks)
+	    submitBlock();
+
+	  while (!_pending.empty())
+	    writeBlock();
+	}
+
+      protected:
+	virtual int_type overflow(int_type c)
+	{
+	  submitBlock();
+	  newBlock();
+	  if (!traits_type::eq_int_type(c, traits_type::eof()))
+	    {
+	      *pptr() = traits_type::to_char_type(c);
+	      pbump(1);
+	    }
+	  return traits_type::not_eof(c);
+	}
+
+      private:
+	void newBlock()
+	{
+	  _block.reset(new std::vector<char>(_blockSize));
+	  setp(_block->data(), _block->data() + _blockSize);
+	}
+
+	//! \brief Compresses the current block, writing out the oldest
+	//! compressed blocks if too many are waiting.
+	void submitBlock()
+	{
+	  _block->resize(pptr() - pbase());
+	  setp(NULL, NULL);
+	  std::shared_ptr<const std::vector<char> > block(std::move(_block));
+	  ++_blocks;
+
+	  if (_pool)
+	    {
+	      std::shared_ptr<std::packaged_task<std::string()> >
+		task(new std::packaged_task<std::string()>(std::bind(&detail::bzip2Data, block)));
+	      _pending.push_back(task->get_future());
+	      _pool->queueTask(std::function<void()>(std::bind(&std::packaged_task<std::string()>::operator(), task)));
+	    }
+	  else
+	    {
+	      std::promise<std::string> result;
+	      result.set_value(detail::bzip2Data(block));
+	      _pending.push_back(result.get_future());
+	    }
+
+	  while (_pending.size() > _maxPending)
+	    writeBlock();
+	}
+
+	//! \brief Waits for the oldest block and writes it out.
+	void writeBlock()
+	{
+	  //get() rethrows any exception thrown while compressing
+	  const std::string data = _pending.front().get();
+	  _pending.pop_front();
+	  _output.write(data.data(), data.size());
+	}
+
+	std::ostream& _output;
+	thread::ThreadPool* _pool;
+	const size_t _blockSize;
+	const size_t _maxPending;
+	size_t _blocks;
+	std::unique_ptr<std::vector<char> > _block;
+	std::deque<std::future<std::string> > _pending;
+      };
+
+      ParallelBzip2Buffer _buffer;
+
+    public:
+      /*! \brief Constructor.
+
+	\param output The stream to write the compressed data to.
+	\param pool The ThreadPool to compress the blocks with, or
+	NULL to compress them in the writing thread.
+	\param blockSize The size of the uncompressed blocks. The
+	default matches the largest block of bzip2.
+       */
+      ParallelBzip2Stream(std::ostream& output, thread::ThreadPool* pool = NULL,
+			  const size_t blockSize = 900000):
+	std::ostream(&_buffer),
+	_buffer(output, pool, blockSize)
+      {}
+
+      ~ParallelBzip2Stream()
+      {
+	try { _buffer.close(); }
+	catch (...) {}
+      }
+
+      /*! \brief Compresses and writes out the remaining data, waiting
+	  for all of the blocks to be written.
+
+	No more data may be written after this.
+       */
+      void close()
+      {
+	flush();
+	_buffer.close();
+      }
+    };
+
+    /*! \brief Writes data to a stream as a multi-stream bzip2 file,
+        compressing the blocks in parallel.
+
+      \sa ParallelBzip2Stream
+     */
+    inline void parallelBzip2(std::ostream& os, const std::string& data,
+			      thread::ThreadPool* pool = NULL,
+			      const size_t blockSize = 900000)
+    {
+      ParallelBzip2Stream bz(os, pool, blockSize);
+      bz.write(data.data(), data.size());
+      bz.close();
+    }
+  }
+}
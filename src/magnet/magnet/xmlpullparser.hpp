@@ -0,0 +1,335 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <magnet/xmlreader.hpp>
+#include <cstdio>
+#include <istream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace magnet {
+  namespace xml {
+    /*! \brief A streaming (pull) parser for the tags of an XML file.
+
+      Unlike Document, this does not hold the file in memory or
+      build a tree of the nodes. The tags are read one at a time
+      from a std::istream (which may be a decompressor) using a
+      fixed size buffer, and the storage for the tag names and
+      attributes is reused, so reading a long sequence of similar
+      tags does not allocate.
+
+      This is intended for the large, regular sections of a file
+      (e.g., per particle data). Text content, comments and
+      processing instructions are skipped, and entities in the
+      attribute values are not expanded.
+     */
+    class PullParser
+    {
+    public:
+      PullParser(std::istream& is, size_t bufferSize = 1 << 16):
+	_is(is), _buffer(bufferSize), _pos(0), _end(0), _line(1),
+	_attrCount(0), _endTag(false), _emptyTag(false)
+      {}
+
+      /*! \brief Copies the data from the stream to out, until a
+        start tag with the passed name is found.
+
+        The tag is then parsed, so its attributes are available. The
+        text of the tag itself is not copied to out.
+
+	\return false if the stream ends before the tag is found.
+       */
+      inline bool copyUntilTag(const std::string& tagName, std::string& out)
+      {
+	const std::string marker = "<" + tagName;
+	int c;
+	while ((c = get()) != EOF)
+	  {
+	    out.push_back(c);
+
+	    //Copy comments without looking inside them
+	    if ((c == '-') && (out.size() >= 4) && !out.compare(out.size() - 4, 4, "<!--"))
+	      {
+		copyPast("-->", out);
+		continue;
+	      }
+
+	    if ((c != marker.back()) || (out.size() < marker.size())
+		|| out.compare(out.size() - marker.size(), marker.size(), marker))
+	      continue;
+
+	    //Check this is not just a tag with a longer name
+	    const int next = peek();
+	    if (!isSpace(next) && (next != '/') && (next != '>'))
+	      continue;
+
+	    out.resize(out.size() - marker.size());
+	    _name = tagName;
+	    parseStartTag();
+	    return true;
+	  }
+
+	return false;
+      }
+
+      //! \brief Copies all of the remaining data in the stream to out.
+      inline void copyAll(std::string& out)
+      {
+	int c;
+	while ((c = get()) != EOF)
+	  out.push_back(c);
+      }
+
+      /*! \brief Parse the next start or end tag in the stream.
+
+	\return false if the stream ends before another tag is found.
+       */
+      inline bool nextTag()
+      {
+	for (;;)
+	  {
+	    int c;
+	    while (((c = get()) != EOF) && (c != '<')) {}
+	    if (c == EOF) return false;
+
+	    c = peek();
+	    if (c == '!')
+	      {
+		get();
+		if (peek() == '-')
+		  skipPast("-->");
+		else
+		  skipPast(">");
+		continue;
+	      }
+
+	    if (c == '?')
+	      {
+		skipPast("?>");
+		continue;
+	      }
+
+	    if (c == '/')
+	      {
+		get();
+		readName();
+		skipSpace();
+		if (get() != '>')
+		  M_throw() << "XML error at line " << _line << ": Malformed end tag </" << _name;
+		_endTag = true;
+		_emptyTag = false;
+		_attrCount = 0;
+		return true;
+	      }
+
+	    readName();
+	    parseStartTag();
+	    return true;
+	  }
+      }
+
+      //! \brief The name of the current tag.
+      inline const std::string& name() const { return _name; }
+
+      //! \brief Test if the current tag is an end tag, e.g. </Pt>.
+      inline bool isEndTag() const { return _endTag; }
+
+      //! \brief Test if the current tag is an empty tag, e.g. <Pt/>.
+      inline bool isEmptyTag() const { return _emptyTag; }
+
+      //! \brief The line number of the stream the parser has reached.
+      inline size_t line() const { return _line; }
+
+      //! \brief The number of attributes of the current tag.
+      inline size_t attributeCount() const { return _attrCount; }
+
+      inline const std::string& attributeName(size_t i) const { return _attributes[i].first; }
+
+      inline const std::string& attributeValue(size_t i) const { return _attributes[i].second; }
+
+      /*! \brief Returns the value of an attribute of the current
+          tag, or NULL if the tag does not have it.
+       */
+      inline const std::string* getAttribute(const char* attrName) const
+      {
+	for (size_t i(0); i < _attrCount; ++i)
+	  if (!_attributes[i].first.compare(attrName))
+	    return &_attributes[i].second;
+	return NULL;
+      }
+
+      /*! \brief Converts the value of an attribute of the current tag
+	to a number.
+
+	Throws if the attribute is missing or is not a number.
+       */
+      template<class T>
+      inline T getAttributeAs(const char* attrName) const
+      {
+	const std::string* value = getAttribute(attrName);
+	if (value == NULL)
+	  M_throw() << "XML error at line " << _line << ": The <" << _name
+		    << "> tag is missing the \"" << attrName << "\" attribute";
+
+	T val;
+	if (!parseValue(value->c_str(), val))
+	  M_throw() << "XML error at line " << _line << ": The value \"" << *value
+		    << "\" of the \"" << attrName << "\" attribute of the <" << _name
+		    << "> tag will not cast to the correct type";
+	return val;
+      }
+
+      /*! \brief Returns a copy of the current start tag as an empty
+          tag, e.g. <Pt ID="1"/>.
+       */
+      inline std::string getEmptyTag() const
+      {
+	std::string tag = "<" + _name;
+	for (size_t i(0); i < _attrCount; ++i)
+	  tag += " " + _attributes[i].first + "=\"" + _attributes[i].second + "\"";
+	return tag + "/>";
+      }
+
+    private:
+      inline bool fill()
+      {
+	if (_pos < _end) return true;
+	_is.read(&_buffer[0], _buffer.size());
+	_pos = 0;
+	_end = _is.gcount();
+	return _end != 0;
+      }
+
+      inline int peek()
+      { return fill() ? static_cast<unsigned char>(_buffer[_pos]) : EOF; }
+
+      inline int get()
+      {
+	if (!fill()) return EOF;
+	const int c = static_cast<unsigned char>(_buffer[_pos++]);
+	if (c == '\n') ++_line;
+	return c;
+      }
+
+      static inline bool isSpace(int c)
+      { return (c == ' ') || (c == '\t') || (c == '\n') || (c == '\r'); }
+
+      inline void skipSpace()
+      { while (isSpace(peek())) get(); }
+
+      //! \brief Reads past the next occurrence of marker, appending the data to out (if not NULL).
+      inline void copyPast(const char* marker, std::string* out)
+      {
+	const std::string str(marker);
+	std::string last;
+	while (last != str)
+	  {
+	    const int c = get();
+	    if (c == EOF)
+	      M_throw() << "XML error: Unexpected end of data while looking for \"" << marker << "\"";
+	    if (out) out->push_back(c);
+	    last.push_back(c);
+	    if (last.size() > str.size())
+	      last.erase(last.begin());
+	  }
+      }
+
+      inline void copyPast(const char* marker, std::string& out) { copyPast(marker, &out); }
+
+      inline void skipPast(const char* marker) { copyPast(marker, NULL); }
+
+      inline void readName(std::string& out)
+      {
+	out.clear();
+	for (int c = peek(); (c != EOF) && !isSpace(c) && (c != '/') && (c != '>') && (c != '='); c = peek())
+	  out.push_back(get());
+
+	if (out.empty())
+	  M_throw() << "XML error at line " << _line << ": Expected a name";
+      }
+
+      inline void readName() { readName(_name); }
+
+      /*! \brief Parses the attributes and the end of a start tag,
+          once its name has been read.
+       */
+      inline void parseStartTag()
+      {
+	_endTag = false;
+	_emptyTag = false;
+	_attrCount = 0;
+
+	for (;;)
+	  {
+	    skipSpace();
+	    int c = peek();
+	    if (c == EOF)
+	      M_throw() << "XML error: Unexpected end of data in the <" << _name << "> tag";
+
+	    if (c == '>') { get(); return; }
+
+	    if (c == '/')
+	      {
+		get();
+		if (get() != '>')
+		  M_throw() << "XML error at line " << _line << ": Malformed empty tag <" << _name;
+		_emptyTag = true;
+		return;
+	      }
+
+	    //Reuse the storage of the attributes of previous tags
+	    if (_attrCount == _attributes.size())
+	      _attributes.resize(_attrCount + 1);
+	    std::pair<std::string, std::string>& attr = _attributes[_attrCount++];
+
+	    readName(attr.first);
+	    skipSpace();
+	    if (get() != '=')
+	      M_throw() << "XML error at line " << _line << ": Expected = after the attribute " << attr.first
+			<< " of the <" << _name << "> tag";
+	    skipSpace();
+	    const int quote = get();
+	    if ((quote != '"') && (quote != '\''))
+	      M_throw() << "XML error at line " << _line << ": Expected a quoted value for the attribute " << attr.first
+			<< " of the <" << _name << "> tag";
+
+	    attr.second.clear();
+	    while ((c = get()) != quote)
+	      {
+		if (c == EOF)
+		  M_throw() << "XML error: Unexpected end of data in the <" << _name << "> tag";
+		attr.second.push_back(c);
+	      }
+	  }
+      }
+
+      std::istream& _is;
+      std::vector<char> _buffer;
+      size_t _pos;
+      size_t _end;
+      size_t _line;
+
+      std::string _name;
+      std::vector<std::pair<std::string, std::string> > _attributes;
+      size_t _attrCount;
+      bool _endTag;
+      bool _emptyTag;
+    };
+  }
+}
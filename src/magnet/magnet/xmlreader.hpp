@@ -20,6 +20,9 @@
 #include <magnet/detail/rapidXML/rapidxml.hpp>
 #include <magnet/exception.hpp>
 #include <boost/lexical_cast.hpp>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
 #include <vector>
 
 namespace magnet {
@@ -63,6 +66,52 @@ namespace magnet {
       }
     }
 
+    /*! \brief Fallback for the types without a fast parser.
+
+      \return false, so the caller falls back to boost::lexical_cast.
+     */
+    template<class T>
+    inline bool parseValue(const char*, T&) { return false; }
+
+    /*! \brief Parses a floating point attribute value.
+
+      The value must be a complete number, without leading or
+      trailing characters. strtod is correctly rounded, so values
+      written with enough digits load back exactly.
+
+      \return false if the value is not a valid number.
+     */
+    inline bool parseValue(const char* str, double& val)
+    {
+      if ((*str == '\0') || (*str == ' ') || (*str == '\t') || (*str == '\n') || (*str == '\r'))
+	return false;
+
+      char* end;
+      errno = 0;
+      val = std::strtod(str, &end);
+      return (*end == '\0') && !((errno == ERANGE) && std::isinf(val));
+    }
+
+    /*! \brief Parses an unsigned integer attribute value.
+
+      \return false if the value is not a plain decimal number, or
+      overflows.
+     */
+    inline bool parseValue(const char* str, size_t& val)
+    {
+      if (*str == '\0') return false;
+
+      val = 0;
+      for (; *str != '\0'; ++str)
+	{
+	  if ((*str < '0') || (*str > '9')) return false;
+	  const size_t digit = *str - '0';
+	  if (val > (size_t(-1) - digit) / 10) return false;
+	  val = val * 10 + digit;
+	}
+      return true;
+    }
+
     /*! \brief Represents an Attribute of an XML Document.
      */
     class Attribute {
@@ -70,6 +119,13 @@ namespace magnet {
       //! \brief Converts the attributes value to a type.
       template<class T> inline T as() const 
       { 
+	//The common numeric types are parsed directly, anything the
+	//fast parsers reject is passed on to lexical_cast for the
+	//error reporting.
+	T val;
+	if (parseValue(getValue().c_str(), val))
+	  return val;
+
 	try {
 	  return boost::lexical_cast<T>(getValue());
 	} catch (boost::bad_lexical_cast&)
@@ -54,11 +54,26 @@ namespace magnet {
     
       //! \brief Constructs an XmlStream from a std::ostream object.
       inline XmlStream(std::ostream& _s):
-	state(stateNone), s(_s), prologWritten(false), FormatXML(false) {}
+	state(stateNone), s(_s), prologWritten(false), FormatXML(false), baseDepth(0) {}
     
       //! \brief Copy constructor.
       inline XmlStream(const XmlStream &XML):
-	state(XML.state), s(XML.s), prologWritten(XML.prologWritten), FormatXML(XML.FormatXML) {}
+	state(XML.state), s(XML.s), prologWritten(XML.prologWritten), FormatXML(XML.FormatXML), baseDepth(0) {}
+
+      /*! \brief Constructs an XmlStream which writes the children of
+       * the currently open tag of another XmlStream.
+       *
+       * The output is indented as if it was written to the parent
+       * stream, so blocks of elements can be written to separate
+       * streams (e.g., in parallel) and then written in order to the
+       * underlying stream of the parent. The parent must not be
+       * inside a tag start (use chardata() to close it) and the tags
+       * of the parent are left open when this stream is destroyed.
+       */
+      inline XmlStream(std::ostream& _s, const XmlStream& parent):
+	tags(parent.tags), state(stateNone), s(_s), prologWritten(true), 
+	FormatXML(parent.FormatXML), baseDepth(parent.tags.size()) 
+      {}
     
       //! \brief Destructor.
       inline ~XmlStream()
@@ -67,7 +82,7 @@ namespace magnet {
 	  s << "/>";
 	  state = stateNone;
 	}
-	while (tags.size())
+	while (tags.size() > baseDepth)
 	  endTag(tags.top());
       }
 
@@ -169,6 +184,9 @@ namespace magnet {
       bool	prologWritten;
       std::ostringstream	tagName;
       bool        FormatXML;
+
+      //! \brief The number of tags inherited from a parent XmlStream.
+      size_t	baseDepth;
     
       //! \brief Closes the current tag.
       inline void closeTagStart(bool self_closed = false)
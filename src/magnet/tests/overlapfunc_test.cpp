@@ -0,0 +1,158 @@
+#include <magnet/intersection/line_line.hpp>
+#include <magnet/intersection/offcentre_spheres.hpp>
+#include "overlapfuncs_original.hpp"
+#include <iostream>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <time.h>
+
+using namespace magnet;
+using magnet::math::Vector;
+using magnet::math::Quaternion;
+
+//A random configuration of a pair of rotating particles
+struct Pair
+{
+  Vector r12, v12, w1, w2;
+  Quaternion q1, q2;
+  double t_max;
+};
+
+std::mt19937 RNG(1);
+
+Vector randomVector()
+{
+  std::normal_distribution<double> normal;
+  return Vector(normal(RNG), normal(RNG), normal(RNG));
+}
+
+/*! \brief Generates pairs whose bounding spheres (of diameter range)
+    overlap, as the root finders are only used for these pairs. The
+    search ends when the bounding spheres separate.
+ */
+std::vector<Pair> randomPairs(size_t N, double range)
+{
+  std::uniform_real_distribution<double> uniform(-1, 1);
+  std::vector<Pair> pairs(N);
+  for (Pair& pair : pairs)
+    {
+      do {
+	pair.r12 = range * Vector(uniform(RNG), uniform(RNG), uniform(RNG));
+      } while (pair.r12.nrm() >= range);
+
+      pair.v12 = randomVector();
+      pair.w1 = randomVector();
+      pair.w2 = randomVector();
+      pair.q1 = Quaternion::fromRotationAxis(randomVector());
+      pair.q2 = Quaternion::fromRotationAxis(randomVector());
+
+      const double a = pair.v12.nrm2(), b = 2 * (pair.r12 | pair.v12),
+	c = pair.r12.nrm2() - range * range;
+      pair.t_max = (-b + std::sqrt(b * b - 4 * a * c)) / (2 * a);
+    }
+  return pairs;
+}
+
+double seconds()
+{
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec + 1e-9 * now.tv_nsec;
+}
+
+const double length = 1, diameter = 0.5, offset = 0.5;
+const double maxdist = 2 * (offset + 0.5 * diameter);
+
+std::pair<bool, double> lines(const Pair& p)
+{ return intersection::line_line(p.r12, p.v12, p.w1, p.w2, p.q1, p.q2, length, false, p.t_max); }
+
+std::pair<bool, double> originalLines(const Pair& p)
+{ return original_intersection::line_line(p.r12, p.v12, p.w1, p.w2, p.q1, p.q2, length, false, p.t_max); }
+
+std::pair<bool, double> spheres(const Pair& p)
+{
+  return intersection::offcentre_spheres(p.r12, p.v12, p.w1, p.w2,
+					 p.q1 * Quaternion::initialDirector() * offset,
+					 p.q2 * Quaternion::initialDirector() * -offset,
+					 diameter, diameter, maxdist, p.t_max);
+}
+
+std::pair<bool, double> originalSpheres(const Pair& p)
+{
+  return original_intersection::offcentre_spheres(p.r12, p.v12, p.w1, p.w2,
+						  p.q1 * Quaternion::initialDirector() * offset,
+						  p.q2 * Quaternion::initialDirector() * -offset,
+						  diameter, diameter, maxdist, p.t_max);
+}
+
+std::pair<bool, double> growingSpheres(const Pair& p)
+{
+  return intersection::offcentre_growing_spheres(p.r12, p.v12, p.w1, p.w2,
+						 p.q1 * Quaternion::initialDirector() * offset,
+						 p.q2 * Quaternion::initialDirector() * -offset,
+						 diameter, diameter, maxdist, p.t_max, 0, 0.1);
+}
+
+std::pair<bool, double> originalGrowingSpheres(const Pair& p)
+{
+  return original_intersection::offcentre_growing_spheres(p.r12, p.v12, p.w1, p.w2,
+							  p.q1 * Quaternion::initialDirector() * offset,
+							  p.q2 * Quaternion::initialDirector() * -offset,
+							  diameter, diameter, maxdist, p.t_max, 0, 0.1);
+}
+
+/*! \brief Checks an intersection test gives the same results as
+    the original implementation, and prints the time taken by each.
+ */
+bool compare(const char* name, const std::vector<Pair>& pairs,
+	     std::pair<bool, double> (*test)(const Pair&),
+	     std::pair<bool, double> (*original)(const Pair&))
+{
+  size_t mismatches = 0, roots = 0;
+  for (const Pair& pair : pairs)
+    {
+      const std::pair<bool, double> result = test(pair);
+      const std::pair<bool, double> expected = original(pair);
+      //The orientations are streamed differently, so the roots only
+      //agree to within the tolerance of the root finder
+      if ((result.first != expected.first)
+	  || ((result.second != expected.second)
+	      && (std::abs(result.second - expected.second) > 1e-8 * std::max(1.0, expected.second))))
+	++mismatches;
+      if (result.first) ++roots;
+    }
+
+  //Time each implementation over all the pairs
+  double sum = 0;
+  double start = seconds();
+  for (const Pair& pair : pairs) sum += original(pair).first;
+  const double originalTime = seconds() - start;
+
+  start = seconds();
+  for (const Pair& pair : pairs) sum += test(pair).first;
+  const double time = seconds() - start;
+
+  std::cout << name << ": " << roots << " of " << pairs.size() << " pairs collide, "
+	    << originalTime * 1e9 / pairs.size() << "ns per pair originally, "
+	    << time * 1e9 / pairs.size() << "ns per pair now (speedup "
+	    << originalTime / time << ")" << std::endl;
+
+  if (mismatches)
+    std::cout << name << ": " << mismatches << " pairs differ from the original implementation" << std::endl;
+
+  return !mismatches && (sum == 2 * roots);
+}
+
+int main()
+{
+  const size_t N = 20000;
+  bool passed = true;
+
+  passed &= compare("line_line", randomPairs(N, length), lines, originalLines);
+  passed &= compare("offcentre_spheres", randomPairs(N, maxdist), spheres, originalSpheres);
+  passed &= compare("offcentre_growing_spheres", randomPairs(N, maxdist), growingSpheres, originalGrowingSpheres);
+
+  return !passed;
+}
@@ -0,0 +1,665 @@
+/*  The original, scalar implementations of the overlap functions in
+    magnet/intersection/line_line.hpp and offcentre_spheres.hpp, and
+    of the root finders they use, which evaluate each derivative
+    separately and use exceptions when the quadratic estimates have
+    no roots. They are kept to test and time the current
+    implementations against.
+*/
+#pragma once
+#include <magnet/math/vector.hpp>
+#include <magnet/math/quaternion.hpp>
+#include <magnet/math/quadratic.hpp>
+#include <magnet/math/matrix.hpp>
+
+namespace magnet {
+  namespace original_intersection {
+    using namespace magnet::math;
+
+    /*! \brief Shooting root finder using quadratic estimation.
+  
+      \param toleranceLengthScale should be 10^-10 the typical scale of
+      the function.
+    */
+    template<class T>
+    std::pair<bool,double> quadRootHunter(const T& fL, double& t_low, double& t_high,
+					  const double& toleranceLengthScale)
+    {
+      double working_time = t_low;
+      double timescale = toleranceLengthScale / fL.template max<1>();
+      bool fwdWorking = false;
+
+      size_t w = 0;
+
+      while(t_low < t_high)
+	{
+	  //Always try again from the other side
+	  fwdWorking = !fwdWorking;
+
+	  if(++w > 100)
+	    {
+#ifdef MAGNET_DEBUG
+	      std::cerr << "\nThe Frenkel rootfinder is converging too slowly."
+			<< "\nt_low = " << t_low << ", t_high = " << t_high;
+#endif
+
+	      if(fabs(t_high - t_low) < timescale)
+		{
+#ifdef MAGNET_DEBUG
+		  std::cerr << "\nThe gap is small enough to consider the root solved at t_low";
+#endif
+		  return std::pair<bool,double>(true, t_low);
+		}
+	      else
+		{
+#ifdef MAGNET_DEBUG
+		  std::cerr << "\nThe gap is too large and is converging too slowly."
+			    << "\n This rootfinding attempt will be aborted and a fake collision returned.";
+#endif
+		  return std::pair<bool,double>(false, t_low);
+		}
+	    }
+
+	  working_time = (fwdWorking ? t_low : t_high);
+	  T tempfL(fL);
+	  tempfL.stream(working_time);
+
+	  double deltaT;
+	  {
+	    double f0 = tempfL.template eval<0>(),
+	      f1 = tempfL.template eval<1>(),
+	      halff2 = 0.5 * tempfL.template eval<2>(),
+	      halff2max = 0.5 * tempfL.template max<2>();
+
+	    //This guarantees that the worst-case approximation has
+	    //roots on either side of the current time.
+	    if (f0 > 0) halff2max = -halff2max;
+	    
+	    std::pair<double, double> worst_case_roots;
+	    try {
+	      worst_case_roots = quadraticEquation(halff2max, f1, f0);
+	    } catch (NoQuadraticRoots&)
+	      {
+		M_throw() << "When trying to improve the bounds using worst-case estimates, it was "
+		  "found that they could not be improved. This implies there is "
+		  "implementation error (zero max 2nd deriv?) in the passed function.";
+	      }
+
+	    //Sort the roots
+	    if (worst_case_roots.first > worst_case_roots.second) std::swap(worst_case_roots.first, worst_case_roots.second);
+
+#ifdef MAGNET_DEBUG
+	    if ((worst_case_roots.first > 0) || (worst_case_roots.second < 0))
+	      M_throw() << "The worst case estimates for the root of the function are not either "
+		"side of the current location. This implies there is an implementation "
+		"error or an untreated numerical edge case.";
+#endif
+	    //Improve the current boundary
+	    if (fwdWorking)
+	      t_low += worst_case_roots.second;
+	    else
+	      t_high += worst_case_roots.first;
+	    
+	    //Now perform the first step of the shooting
+	    std::pair<double, double> estimate_roots;
+	    try {
+	      estimate_roots = quadraticEquation(halff2, f1, f0);
+	    } catch (NoQuadraticRoots&)
+	      //If the shooting fails, restart from the other boundary
+	      { continue; }
+	    
+	    //Sort the roots
+	    if (estimate_roots.first > estimate_roots.second) std::swap(estimate_roots.first, estimate_roots.second);
+	    
+	    if (fwdWorking)
+	      {
+		//Check if there are no positive roots (restart from other boundary if so)
+		if (estimate_roots.second < 0) continue;
+		//Set deltaT to the smallest positive root.
+		if (estimate_roots.first > 0)
+		  deltaT = estimate_roots.first;
+		else
+		  deltaT = estimate_roots.second;
+	      }
+	    else
+	      {
+		//Check if there are no negative roots (restart from other boundary if so)
+		if (estimate_roots.first > 0) continue;
+		//Set deltaT to the smallest negative root.
+		if (estimate_roots.second > 0)
+		  deltaT = estimate_roots.first;
+		else
+		  deltaT = estimate_roots.second;
+	      }
+	  }
+
+	  //Check this first step is still within the other bound
+	  if (((working_time + deltaT) > t_high)
+	      || ((working_time + deltaT) < t_low))
+	    continue;
+
+	  // Give it 100 iterations before we try shrinking the windows again
+	  for(size_t i(100); i != 0; --i)
+	    {
+	      working_time += deltaT;
+
+	      if((working_time > t_high) || (working_time < t_low))
+		break;
+
+	      tempfL.stream(deltaT);
+
+	      try {
+		std::pair<double, double> estimate_roots = quadraticEquation(0.5 * tempfL.template eval<2>(), tempfL.template eval<1>(), tempfL.template eval<0>());
+		if (std::abs(estimate_roots.first) < std::abs(estimate_roots.second))
+		  deltaT = estimate_roots.first;
+		else
+		  deltaT = estimate_roots.second;
+	      } catch (NoQuadraticRoots&)
+		//If the shooting fails, quit the loop
+		{ break; }
+
+	      if (fabs(deltaT) <  timescale)
+		return std::pair<bool,double>(true, working_time + deltaT);
+	    }
+	}
+
+      return std::pair<bool,double>(false, HUGE_VAL);
+    }
+
+    /*! \brief A root finder that is guarranteed to find the earliest
+     root in an interval, for functions with known maximum first and
+     second derivatives.
+    
+     First, search for root in main window
+      - If a root is not found, return a failure
+    
+     If a root is found: start a new search in the window just between this root and the lower bound.
+        - If a root is found, restart the search again, in the smaller 
+        - If no root is found, drop out of this inner loop
+      - Check root validity
+        - If root is valid, this is earliest possible root - roll with it
+        - If root is invalid, set new concrete t_low just above this found root and go from the top
+    
+     \param toleranceLengthScale Should be 10^-10 the typical length scale of the system
+
+     If the root finder fails, it will return (false, HUGE_VAL), if it
+     fails due to the iteration count going too high, it will return
+     (false, t_low), where t_low is a lower bound on any possible root.
+
+     Otherwise it will return (true, t) where t is the location of the
+     root.
+    */
+    template<class T>
+    std::pair<bool,double> frenkelRootSearch(const T& fL, double t_low, double t_high,
+					     double toleranceLengthScale)
+    {
+      std::pair<bool,double> root(false,HUGE_VAL);
+
+      while(t_high > t_low)
+	{
+	  root = quadRootHunter<T>(fL, t_low, t_high, toleranceLengthScale);
+	  //If no root was found, it might have only established a
+	  //lower bound, return this lower bound.
+	  if (root.first == false) return root;
+
+	  //We found a root, now check for earlier roots in the same interval
+	  double temp_high = t_high;
+	  do {
+	    //Start a search, stream the function to the root
+	    T tempfL(fL);
+	    tempfL.stream(root.second);
+	    //Calculate the offset for the upper bound
+	    double Fdoubleprimemax = tempfL.template max<2>();
+	    temp_high = root.second - (fabs(2.0 * tempfL.template eval<1>()) / Fdoubleprimemax);
+
+	    //Now check if the upper bound is below the lower bound.
+	    //If so, the current root is the earliest.
+	    if ((temp_high < t_low) || (Fdoubleprimemax == 0)) break;
+
+	    //Search for a root in the new interval
+	    std::pair<bool,double> temp_root = quadRootHunter<T>(fL, t_low, temp_high, toleranceLengthScale);
+
+	    //If there is no root found in the interval, then the current root is fine
+	    if ((!temp_root.first) && (temp_root.second == HUGE_VAL)) break;
+	
+	    //If we have been unable to establish if there is a root
+	    //in the interval, we can use the returned time as a lower
+	    //bound to come back to later
+	    if (!temp_root.first) return temp_root;
+
+	    //Otherwise, the new root is valid, go around and check
+	    //for a root in the remaining interval again.
+	    root = temp_root;
+	  } while(temp_high > t_low);
+
+	  //At this point "root" contains earliest valid root guess.
+	  //We now check if this root is acceptable, if not we'll have
+	  //to go around again. Fortunately all roots are acceptable
+	  //for most algorithms.
+	  T tempfL(fL);
+	  tempfL.stream(root.second);
+
+	  if (tempfL.test_root()) return root;
+
+	  //The root was not valid, set the lower bound to the current root value
+	  t_low = root.second + ((2.0 * fabs(tempfL.template eval<1>())) / tempfL.template max<2>());
+	  //and invalidate the current root, resetting the root
+	  //finding but with a new lower bound.
+	  root.first = false;
+	  root.second = HUGE_VAL;
+	}
+
+      return root;
+    }
+    namespace detail {
+      /*! \brief A class which takes the derivative of an overlap
+	function.
+       */
+      template <class T, int derivative = 1> class OFDerivative
+      {
+      public:
+	OFDerivative(const T& sf): _shapeFunc(sf) {}
+	void stream(const double& dt) { _shapeFunc.stream(dt); }
+	template<size_t d> double eval() const { return _shapeFunc.template eval<d+derivative>(); }
+	template<size_t d> double max() const { return _shapeFunc.template max<d+derivative>(); }
+	bool test_root() const { return true; }	
+      protected:
+	T _shapeFunc;
+      };
+    }
+
+    /*! \brief A generic implementation of the stable EDMD algorithm
+      which uses Frenkel's root finder on overlap functions.
+      
+      \tparam T The type of the overlap function which is being solved.
+      \param f The overlap function.
+      \param err The maximum error on the frenkel root finder
+    */
+    template<class T> std::pair<bool, double> generic_algorithm(T f, double t_max, double err)
+    {
+      double f0 = f.template eval<0>();
+      double f1 = f.template eval<1>();
+
+      //First treat overlapping or in contact particles which are approaching
+      if ((f0 <= 0) && (f1 < 0)) return std::pair<bool, double>(true, 0.0);
+    
+      //Now treat overlapping particles which are not approaching
+      if (f0 < 0)
+	{
+	  //Overlapping but they're moving away from each
+	  //other. Determine when they reach their next maximum
+	  //separation.
+	  detail::OFDerivative<T> fprime(f);
+
+	  std::pair<bool, double> derivroot = frenkelRootSearch(fprime, 0, t_max, err);
+
+	  //Check if they just keep retreating from each other, which means that they never interact
+	  if (derivroot.second == HUGE_VAL) return std::pair<bool, double>(false, HUGE_VAL);
+
+	  //Check if the time returned is not overlapping
+	  T froot(f);
+	  froot.stream(derivroot.second);
+
+	  //If they are still overlapping at this time, it doesn't
+	  //matter if derivroot is a virtual (recalculate) event or
+	  //an actual turning point. We can just return it
+	  if (froot.template eval<0>() < 0) return derivroot;
+
+	  //Real or virtual, the derivroot contains a time before the
+	  //next interaction which is outside the invalid state, we just
+	  //use this as our lower bound
+	  return frenkelRootSearch(f, derivroot.second, t_max, err);
+	}
+
+      //If the particles are in contact, but not approaching, we need to
+      //skip this initial root
+      double t_min = (f0 == 0) ? 2.0 * std::abs(f.template eval<1>()) / f.template max<2>() : 0;
+      return frenkelRootSearch(f, t_min, t_max, err);
+    }
+    namespace detail {
+      /*! \brief The overlap function for two infinitely thin rods,
+          used in the line_line function. */
+      class LinesOverlapFunc
+      {
+      public:
+	LinesOverlapFunc(const math::Vector& nr12, const math::Vector& nv12,
+			 const math::Vector& nw1, const math::Vector& nw2, 
+			 const math::Quaternion& nq1, const math::Quaternion& nq2,
+			 const double& length):
+	  w1(nw1), w2(nw2), q1(nq1), q2(nq2),
+	  w12(nw1 - nw2), r12(nr12), v12(nv12),
+	  _length(length)
+	{
+	  u1 = q1 * math::Quaternion::initialDirector();
+	  u2 = q2 * math::Quaternion::initialDirector();
+	}
+
+	void stream(const double& dt)
+	{
+	  q1 = math::Quaternion::fromRotationAxis(w1 * dt) * q1;
+	  q1.normalise();
+	  q2 = math::Quaternion::fromRotationAxis(w2 * dt) * q2;
+	  q2.normalise();
+	  r12 += v12 * dt;
+	  u1 = q1 * math::Quaternion::initialDirector();
+	  u2 = q2 * math::Quaternion::initialDirector();
+	}
+  
+	std::pair<double, double> getCollisionPoints() const
+	{
+	  double rijdotui = (r12 | u1);
+	  double rijdotuj = (r12 | u2);
+	  double uidotuj = (u1 | u2);
+
+	  return std::make_pair(- (rijdotui - (rijdotuj * uidotuj)) / (1.0 - uidotuj*uidotuj),
+				(rijdotuj - (rijdotui * uidotuj)) / (1.0 - uidotuj*uidotuj));
+	}
+    
+	template<size_t deriv> 
+	double eval() const
+	{
+	  switch (deriv)
+	    {
+	    case 0:
+	      return ((u1 ^ u2) | r12);
+	    case 1:
+	      return ((u1 | r12) * (w12 | u2)) 
+		+ ((u2 | r12) * (w12 | u1)) 
+		- ((w12 | r12) * (u1 | u2)) 
+		+ (((u1 ^ u2) | v12));
+	    case 2:
+	      return 2.0 
+		* (((u1 | v12) * (w12 | u2)) 
+		   + ((u2 | v12) * (w12 | u1))
+		   - ((u1 | u2) * (w12 | v12)))
+		- ((w12 | r12) * (w12 | (u1 ^ u2))) 
+		+ ((u1 | r12) * (u2 | (w1 ^ w2))) 
+		+ ((u2 | r12) * (u1 | (w1 ^ w2)))
+		+ ((w12 | u1) * (r12 | (w2 ^ u2)))
+		+ ((w12 | u2) * (r12 | (w1 ^ u1))); 
+	    default:
+	      M_throw() << "Invalid access";
+	    }
+	}
+    
+	template<size_t deriv> 
+	double max() const
+	{
+	  switch (deriv)
+	    {
+	    case 1:
+	      return _length * w12.nrm() + v12.nrm();
+	    case 2:
+	      return w12.nrm() 
+		* ((2 * v12.nrm()) + (_length * (w1.nrm() + w2.nrm())));
+	    default:
+	      M_throw() << "Invalid access";
+	    }
+	}
+
+	std::pair<double, double> discIntersectionWindow() const
+	{
+	  math::Vector  Ahat = w1 / w1.nrm();
+	  double dotproduct = (w1 | w2) / (w2.nrm() * w1.nrm());
+	  double signChangeTerm = (_length / 2.0) * sqrt(1.0 - pow(dotproduct, 2.0));
+    
+	  std::pair<double,double> 
+	    retVal(((-1.0 * (r12 | Ahat)) - signChangeTerm) / (v12 | Ahat),
+		   ((-1.0 * (r12 | Ahat)) + signChangeTerm) / (v12 | Ahat));
+  
+	  if(retVal.second < retVal.first) std::swap(retVal.first, retVal.second);
+
+	  return retVal;
+	}
+
+	const math::Vector& getu1() const { return u1; }
+	const math::Vector& getu2() const { return u2; }
+	const math::Vector& getw1() const { return w1; }
+	const math::Vector& getw2() const { return w2; }
+	const math::Vector& getw12() const { return w12; }
+	const math::Vector& getr12() const { return r12; }
+	const math::Vector& getv12() const { return v12; }
+
+	bool test_root() const
+	{
+	  std::pair<double,double> cp = getCollisionPoints();
+    
+	  return (fabs(cp.first) < _length / 2.0 && fabs(cp.second) < _length / 2.0);
+	}
+  
+      private:
+	const math::Vector& w1;
+	const math::Vector& w2;
+	math::Quaternion q1;
+	math::Quaternion q2;
+	math::Vector w12;
+	math::Vector r12;
+	math::Vector v12;
+	math::Vector u1, u2;
+
+	const double _length;
+      };
+    }
+
+    /*! \brief A line-line intersection test.
+     */
+    inline std::pair<bool, double> 
+    line_line(const math::Vector& rij, const math::Vector& vij,
+	      const math::Vector& angvi, const math::Vector& angvj,
+	      const math::Quaternion& orientationi, const math::Quaternion& orientationj,
+	      const double& length, bool skip_zero, double t_max)
+    {
+      detail::LinesOverlapFunc fL(rij, vij, angvi, angvj, orientationi, orientationj, length);
+      
+      //Shift the lower bound up so we don't find the same root again
+      double t_min = skip_zero ? fabs(2.0 * fL.eval<1>()) / fL.max<2>() : 0;
+    
+      //Find window delimited by discs
+      std::pair<double,double> dtw = fL.discIntersectionWindow();
+      t_min = std::max(dtw.first, t_min);
+      t_max = std::min(dtw.second, t_max);
+      return frenkelRootSearch(fL, t_min, t_max, length * 1e-10);
+    }
+    namespace detail {
+      /*! \brief The overlap function and its derivatives for two
+	offcentre spheres rotating about an individual point.
+      */
+      class OffcentreSpheresOverlapFunction
+      {
+      public:
+	OffcentreSpheresOverlapFunction(const math::Vector& rij, const math::Vector& vij, const math::Vector& omegai, const math::Vector& omegaj,
+					const math::Vector& nu1, const math::Vector& nu2, const double diameter1, const double diameter2, 
+					const double maxdist):
+	  w1(omegai), w2(omegaj), u1(nu1), u2(nu2), r12(rij), v12(vij), _diameter1(diameter1), _diameter2(diameter2)
+	{
+	  double magw1 = w1.nrm(), magw2 = w2.nrm();
+	  double rijmax = u1.nrm() + u2.nrm() + maxdist;
+	  double vijmax = v12.nrm() + magw1 * u1.nrm() + magw2 * u2.nrm();
+	  double aijmax = w1.nrm2() * u1.nrm() + w2.nrm2() * u2.nrm();
+	  double dotaijmax = magw1 * w1.nrm2() * u1.nrm() + magw2 * w2.nrm2() * u2.nrm();
+	  _f1max = 2 * rijmax * vijmax;
+	  _f2max = 2 * vijmax * vijmax + 2 * rijmax * aijmax;
+	  _f3max = 6 * vijmax * aijmax + 2 * rijmax * dotaijmax;
+	}
+
+	void stream(const double& dt)
+	{
+	  u1 = Rodrigues(w1 * dt) * math::Vector(u1);
+	  u2 = Rodrigues(w2 * dt) * math::Vector(u2);
+	  r12 += v12 * dt;
+	}
+  
+	template<size_t deriv> 
+	double eval() const
+	{
+	  double colldiam = 0.5 * (_diameter1 + _diameter2);
+	  const math::Vector rij = r12 + u1 - u2;
+	  const math::Vector vij = v12 + (w1 ^ u1) - (w2 ^ u2);
+	  const math::Vector aij = -w1.nrm2() * u1 + w2.nrm2() * u2;
+	  const math::Vector dotaij = -w1.nrm2() * (w1 ^ u1) + w2.nrm2() * (w2 ^ u2);
+
+	  switch (deriv)
+	    {
+	    case 0: return (rij | rij) - colldiam * colldiam;
+	    case 1: return 2 * (rij | vij);
+	    case 2: return 2 * vij.nrm2() + 2 * (rij | aij);
+	    case 3: return 6 * (vij | aij) + 2 * (rij | dotaij);
+	    default:
+	      M_throw() << "Invalid access";
+	    }
+	}
+    
+	template<size_t deriv> 
+	double max() const
+	{
+	  switch (deriv)
+	    {
+	    case 1: return _f1max;
+	    case 2: return _f2max;
+	    case 3: return _f3max;
+	    default:
+	      M_throw() << "Invalid access";
+	    }
+	}
+
+	const math::Vector& getu1() const { return u1; }
+	const math::Vector& getu2() const { return u2; }
+	const math::Vector& getw1() const { return w1; }
+	const math::Vector& getw2() const { return w2; }
+	const math::Vector& getr12() const { return r12; }
+	const math::Vector& getv12() const { return v12; }
+  
+	bool test_root() const { return true; }
+
+      private:
+	const math::Vector& w1;
+	const math::Vector& w2;
+	math::Vector u1;
+	math::Vector u2;
+	math::Vector r12;
+	math::Vector v12;
+
+	const double _diameter1, _diameter2;
+	double _f1max, _f2max, _f3max;
+      };
+
+      /*! \brief The overlap function and its derivatives for two
+	offcentre spheres rotating about an individual point.
+      */
+      class OffcentreGrowingSpheresOverlapFunction
+      {
+      public:
+	OffcentreGrowingSpheresOverlapFunction(const math::Vector& rij, const math::Vector& vij, const math::Vector& omegai, const math::Vector& omegaj,
+					       const math::Vector& nu1, const math::Vector& nu2, const double diameter1, const double diameter2, 
+					       const double maxdist, const double t, const double invgamma, const double t_max):
+	  w1(omegai), w2(omegaj), u1(nu1), u2(nu2), r12(rij), v12(vij), _diameter1(diameter1), _diameter2(diameter2), _invgamma(invgamma), _t_max(t_max), _t(t)
+	{
+	  double Gmax = std::max(1 + t * invgamma, 1 + (t + t_max) * invgamma);
+	  const double sigmaij = 0.5 * (_diameter1 + _diameter2);
+	  const double sigmaij2 = sigmaij * sigmaij;
+	  double magw1 = w1.nrm(), magw2 = w2.nrm();
+	  double rijmax = Gmax * maxdist;
+	  double magu1 = u1.nrm(), magu2 = u2.nrm();
+	  double vijmax = v12.nrm() + Gmax * (magu1 * magw1 + magu2 * magw2) + std::abs(invgamma) * (magu1 + magu2);
+	  double aijmax = Gmax * (magu1 * magw1 * magw1 + magu2 * magw2 * magw2) + 2 * std::abs(invgamma) * (magu1 * magw1 + magu2 * magw2);
+	  double dotaijmax = Gmax * (magu1 * magw1 * magw1 * magw1 + magu2 * magw2 * magw2 * magw2) + 3 * std::abs(invgamma) * (magu1 * magw1 * magw1 + magu2 * magw2 * magw2);
+
+	  _f1max = 2 * rijmax * vijmax + 2 * Gmax * std::abs(invgamma) * sigmaij2;
+	  _f2max = 2 * vijmax * vijmax + 2 * rijmax * aijmax + 2 * invgamma * invgamma * sigmaij2;
+	  _f3max = 6 * vijmax * aijmax + 2 * rijmax * dotaijmax;
+	}
+
+	void stream(const double& dt)
+	{
+	  u1 = Rodrigues(w1 * dt) * math::Vector(u1);
+	  u2 = Rodrigues(w2 * dt) * math::Vector(u2);
+	  _t += dt;
+	  r12 += v12 * dt;
+	}
+  
+	template<size_t deriv> 
+	double eval() const
+	{
+	  const double colldiam = 0.5 * (_diameter1 + _diameter2);
+	  const double growthfactor = 1 + _invgamma * _t;
+	  const math::Vector rij = r12 + growthfactor * (u1 - u2);
+	  const math::Vector vij = v12 + growthfactor * ((w1 ^ u1) - (w2 ^ u2)) + _invgamma * (u1 - u2);
+	  const math::Vector aij = growthfactor * (-w1.nrm2() * u1 + w2.nrm2() * u2) + 2 * _invgamma * ((w1 ^ u1) - (w2 ^ u2));
+	  const math::Vector dotaij = growthfactor * (-w1.nrm2() * (w1 ^ u1) + w2.nrm2() * (w2 ^ u2)) + 3 * _invgamma * (-w1.nrm2() * u1 + w2.nrm2() * u2);
+
+	  switch (deriv)
+	    {
+	    case 0: return (rij | rij) - growthfactor * growthfactor * colldiam * colldiam;
+	    case 1: return 2 * (rij | vij) - 2 * _invgamma * growthfactor * colldiam * colldiam;
+	    case 2: return 2 * vij.nrm2() + 2 * (rij | aij) - 2 * _invgamma * _invgamma * colldiam * colldiam;
+	    case 3: return 6 * (vij | aij) + 2 * (rij | dotaij);
+	    default:
+	      M_throw() << "Invalid access";
+	    }
+	}
+    
+	template<size_t deriv> 
+	double max() const
+	{
+	  switch (deriv)
+	    {
+	    case 1: return _f1max;
+	    case 2: return _f2max;
+	    case 3: return _f3max;
+	    default:
+	      M_throw() << "Invalid access";
+	    }
+	}
+
+	const math::Vector& getu1() const { return u1; }
+	const math::Vector& getu2() const { return u2; }
+	const math::Vector& getw1() const { return w1; }
+	const math::Vector& getw2() const { return w2; }
+	const math::Vector& getr12() const { return r12; }
+	const math::Vector& getv12() const { return v12; }
+  
+	bool test_root() const { return true; }
+
+      private:
+	const math::Vector& w1;
+	const math::Vector& w2;
+	math::Vector u1;
+	math::Vector u2;
+	math::Vector r12;
+	math::Vector v12;
+
+	const double _diameter1, _diameter2, _invgamma, _t_max;
+	double _t, _f1max, _f2max, _f3max;
+      };
+    }
+
+    /*! \brief Intersection test for offcentre spheres.
+     */
+    inline std::pair<bool, double> 
+    offcentre_spheres(const math::Vector& rij, const math::Vector& vij, const math::Vector& angvi, const math::Vector& angvj,
+		      const math::Vector& relativeposi, const math::Vector& relativeposj,
+		      const double diameteri, const double diameterj, double maxdist, double t_max)
+    {
+#ifdef MAGNET_DEBUG
+      if (std::isinf(t_max)) M_throw() << "Cannot perform root search in infinite intervals";
+#endif
+
+      detail::OffcentreSpheresOverlapFunction f(rij, vij, angvi, angvj, relativeposi, relativeposj, diameteri, diameterj, maxdist);
+      return generic_algorithm(f, t_max, std::min(diameteri, diameterj) * 1e-10);
+    }
+
+    /*! \brief Intersection test for growing offcentre spheres.
+     */
+    inline std::pair<bool, double> 
+    offcentre_growing_spheres(const math::Vector& rij, const math::Vector& vij, const math::Vector& angvi, const math::Vector& angvj,
+			      const math::Vector& relativeposi, const math::Vector& relativeposj,
+			      const double diameteri, const double diameterj, double maxdist, double t_max, double t, double invgamma)
+    {
+#ifdef MAGNET_DEBUG
+      if (std::isinf(t_max)) M_throw() << "Cannot perform root search in infinite interval";
+#endif
+
+      detail::OffcentreGrowingSpheresOverlapFunction f(rij, vij, angvi, angvj, relativeposi, relativeposj, diameteri, diameterj, maxdist, t, invgamma, t_max);
+      return generic_algorithm(f, t_max, std::min(diameteri, diameterj) * 1e-10);
+    }
+  }
+}
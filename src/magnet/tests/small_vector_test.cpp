@@ -0,0 +1,37 @@
+#include <magnet/containers/small_vector.hpp>
+#include <iostream>
+
+int main()
+{
+  magnet::containers::SmallVector<int, 2> vec;
+
+  if (!vec.empty())
+    { std::cout << "A new SmallVector is not empty"; return 1; }
+
+  for (int i(0); i < 5; ++i)
+    {
+      vec.push_back(i);
+      if (vec.size() != size_t(i + 1))
+	{ std::cout << "Wrong size after push_back"; return 1; }
+
+      //Check the elements survive moving to the heap storage
+      int expected = 0;
+      for (const int val : vec)
+	if (val != expected++)
+	  { std::cout << "Wrong element after push_back"; return 1; }
+    }
+
+  magnet::containers::SmallVector<int, 2> copy(vec);
+  if ((copy.size() != 5) || (copy[4] != 4))
+    { std::cout << "Copy is wrong"; return 1; }
+
+  vec.clear();
+  if (!vec.empty() || (vec.begin() != vec.end()))
+    { std::cout << "Cleared SmallVector is not empty"; return 1; }
+
+  vec.push_back(7);
+  if ((vec.size() != 1) || (vec.front() != 7) || (vec.back() != 7))
+    { std::cout << "Refilled SmallVector is wrong"; return 1; }
+
+  return 0;
+}
@@ -0,0 +1,60 @@
+#include <magnet/xmlpullparser.hpp>
+#include <iostream>
+#include <sstream>
+
+int main()
+{
+  std::istringstream is("<?xml version=\"1.0\"?>\n"
+			"<Root a=\"1\">\n"
+			"  <Head/>\n"
+			"  <!-- <Data> in a comment --->\n"
+			"  <DataX/>\n"
+			"  <Data N='2'>\n"
+			"    <Pt ID=\"0\" Mass=\"1.5e-3\"><P x=\"1\" y=\"-2.25\" z=\"3e2\"/></Pt>\n"
+			"    <Pt ID=\"1\" Mass=\"bad\"/>\n"
+			"  </Data>\n"
+			"</Root>\n");
+
+  //Use a tiny buffer, so tags are split over reads
+  magnet::xml::PullParser parser(is, 7);
+
+  std::string header;
+  if (!parser.copyUntilTag("Data", header))
+    { std::cout << "Failed to find the Data tag"; return 1; }
+
+  if (header.find("<DataX/>") == std::string::npos || header.find("<Data ") != std::string::npos)
+    { std::cout << "Wrong header copied:\n" << header; return 1; }
+
+  if ((parser.name() != "Data") || parser.isEmptyTag() || (parser.getEmptyTag() != "<Data N=\"2\"/>"))
+    { std::cout << "Wrong Data tag " << parser.getEmptyTag(); return 1; }
+
+  if (!parser.nextTag() || (parser.name() != "Pt") || (parser.getAttributeAs<size_t>("ID") != 0)
+      || (parser.getAttributeAs<double>("Mass") != 1.5e-3))
+    { std::cout << "Wrong first Pt tag"; return 1; }
+
+  if (!parser.nextTag() || (parser.name() != "P") || !parser.isEmptyTag()
+      || (parser.getAttributeAs<double>("y") != -2.25) || (parser.getAttributeAs<double>("z") != 300))
+    { std::cout << "Wrong P tag"; return 1; }
+
+  if (!parser.nextTag() || !parser.isEndTag() || (parser.name() != "Pt"))
+    { std::cout << "Wrong Pt end tag"; return 1; }
+
+  if (!parser.nextTag() || (parser.name() != "Pt") || !parser.isEmptyTag() || (parser.getAttribute("Missing") != NULL))
+    { std::cout << "Wrong second Pt tag"; return 1; }
+
+  try {
+    parser.getAttributeAs<double>("Mass");
+    std::cout << "A bad value was parsed"; 
+    return 1;
+  } catch (std::exception&) {}
+
+  if (!parser.nextTag() || !parser.isEndTag() || (parser.name() != "Data")
+      || !parser.nextTag() || !parser.isEndTag() || (parser.name() != "Root")
+      || parser.nextTag())
+    { std::cout << "Wrong end of the data"; return 1; }
+
+  if (parser.line() != 11)
+    { std::cout << "Wrong line count " << parser.line(); return 1; }
+
+  return 0;
+}
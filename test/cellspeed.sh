@@ -0,0 +1,68 @@
+#!/bin/bash
+# Sweeps the settings of the cell neighbour list (OverLink, Oversize
+# and Overlap) for hard sphere systems at several densities, and
+# compares the event rates to the AutoTune mode of the cells.
+#
+# The results are appended to cellspeed.dat, one line per run:
+#   density overlink oversize overlap events/s
+dynamod="../bin/dynamod"
+dynarun="../bin/dynarun"
+
+NCOLL=1000000
+CELLS=20
+AUTOTUNE=50000
+
+#Adds the passed attributes to the cells of config.out.xml.bz2
+function setcells {
+    bzcat config.out.xml.bz2 \
+	| sed "s/<Global Type=\"Cells\"/<Global Type=\"Cells\" $1/" \
+	| bzip2 > cellspeed.xml.bz2
+}
+
+function speed {
+    $dynarun cellspeed.xml.bz2 -c $NCOLL -o cellspeed.out.xml.bz2 \
+	--out-data-file cellspeed.data.xml.bz2 \
+	| grep "Avg Events/s" | awk '{print $3}'
+}
+
+for dens in 0.1 0.5 0.8 1.0; do
+    $dynamod -m 0 -d $dens -C $CELLS -o config.out.xml.bz2 > /dev/null
+
+    for overlink in 1 2 3; do
+	for oversize in 1.0 1.2 1.5 2.0; do
+	    for overlap in 0.9 0.5 0.1; do
+		echo -n "Running density $dens, OverLink $overlink, Oversize $oversize, Overlap $overlap...."
+		setcells "OverLink=\"$overlink\" Oversize=\"$oversize\" Overlap=\"$overlap\""
+		val=$(speed)
+		echo $val
+		echo $dens $overlink $oversize $overlap $val >> cellspeed.dat
+	    done
+	done
+    done
+
+    echo -n "Running density $dens, AutoTune $AUTOTUNE...."
+    setcells "AutoTune=\"$AUTOTUNE\""
+    val=$(speed)
+    echo $val
+    #The tuned settings are saved in the output configuration
+    bzcat cellspeed.out.xml.bz2 | grep -m 1 "<Global Type=\"Cells\""
+    echo $dens auto auto auto $val >> cellspeed.dat
+done
+
+#A system so small that the loaded grid is 3x3x3 cells with
+#OverLink=1, so one neighbourhood of cells spans the system. The
+#tuning must still complete (the trials are advanced by the event
+#count, not by the cell transitions), skipping the degenerate trials.
+echo -n "Running a 3x3x3 cell grid, AutoTune 1000...."
+$dynamod -m 0 -d 1.0 -C 2 -o config.out.xml.bz2 > /dev/null
+setcells "AutoTune=\"1000\""
+if ! timeout 300 $dynarun cellspeed.xml.bz2 -c 100000 -o cellspeed.out.xml.bz2 \
+    --out-data-file cellspeed.data.xml.bz2 > cellspeed.log; then
+    echo "Failed"
+    exit 1
+fi
+if ! grep -q "Auto-tuning complete" cellspeed.log; then
+    echo "The tuning did not complete"
+    exit 1
+fi
+echo "Passed"
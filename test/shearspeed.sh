@@ -0,0 +1,41 @@
+#!/bin/bash
+# Compares the event rates of two builds of dynarun for sheared
+# (Lees-Edwards) hard sphere systems of increasing width, to measure
+# the cost of the neighbourhoods across the shearing boundaries.
+#
+# Usage: shearspeed.sh <old bin dir> <new bin dir>
+#
+# The results are appended to shearspeed.dat, one line per system:
+#   width overlink old-events/s new-events/s
+if [ $# -ne 2 ]; then
+    echo "Usage: $0 <old bin dir> <new bin dir>"
+    exit 1
+fi
+old="$1"
+new="$2"
+
+NCOLL=1000000
+
+function speed {
+    $1/dynarun shearspeed.xml.bz2 -c $NCOLL -o shearspeed.out.xml.bz2 \
+	--out-data-file shearspeed.data.xml.bz2 \
+	| grep "Avg Events/s" | awk '{print $3}'
+}
+
+for width in 6 12 24 48 96; do
+    $new/dynamod -m 4 -x $width -y 6 -z 6 --rectangular-box --f1 0.9 \
+	-o config.out.xml.bz2 > /dev/null
+
+    for overlink in 1 2; do
+	bzcat config.out.xml.bz2 \
+	    | sed "s/<Global Type=\"Cells\"/<Global Type=\"Cells\" OverLink=\"$overlink\"/" \
+	    | bzip2 > shearspeed.xml.bz2
+
+	echo -n "Running width $width, OverLink $overlink...."
+	#Older builds cannot shear with overlinking
+	oldval=$(speed $old)
+	newval=$(speed $new)
+	echo "old ${oldval:-failed} new $newval"
+	echo $width $overlink ${oldval:-failed} $newval >> shearspeed.dat
+    done
+done
@@ -714,6 +714,117 @@ function BinaryThermalisedGranulate {
     rm -Rf output.xml.bz2 config.out.xml.bz2 run.log
 }
 
+function BinaryConfigRoundTrip {
+#Converts a configuration to XML directly and via the binary format,
+#the two must be identical
+    > run.log
+
+    ./dynamod -s 1 -m $1 -C 5 -o start.xml >> run.log 2>&1
+    ./dynamod start.xml -o direct.xml >> run.log 2>&1
+    ./dynamod start.xml -o config.dbin >> run.log 2>&1
+    ./dynamod config.dbin -o roundtrip.xml >> run.log 2>&1
+
+    if cmp -s direct.xml roundtrip.xml; then
+	echo "BinaryConfigRoundTrip mode $1 -: PASSED"
+    else
+	echo "BinaryConfigRoundTrip mode $1 -: FAILED"
+	exit 1
+    fi
+
+#Cleanup
+    rm -Rf start.xml direct.xml config.dbin roundtrip.xml run.log
+}
+
+function HS_kernel_test {
+#Runs monodisperse hard spheres with the specialised event kernel,
+#and again with the diameter stored per-particle, which forces the
+#generic path. The trajectories must be identical.
+    > run.log
+
+    ./dynamod -s 1 -m 0 -C 7 -o kernel.xml.bz2 >> run.log 2>&1
+
+    bzcat kernel.xml.bz2 | $Xml ed \
+	-u '//Interaction[@Type="HardSphere"]/@Diameter' -v "D" \
+	-s '/DynamOconfig/Properties' -t elem -n Property -v "" \
+	-s '/DynamOconfig/Properties/Property' -t attr -n Type -v "PerParticle" \
+	-s '/DynamOconfig/Properties/Property' -t attr -n Name -v "D" \
+	-s '/DynamOconfig/Properties/Property' -t attr -n Units -v "Length" \
+	-s '//Pt' -t attr -n D -v 1 \
+	| bzip2 > generic.xml.bz2
+
+    ./dynarun -c 200000 kernel.xml.bz2 -o kernel.end.xml.bz2 > kernel.log 2>&1
+    ./dynarun -c 200000 generic.xml.bz2 -o generic.end.xml.bz2 > generic.log 2>&1
+    cat kernel.log generic.log >> run.log
+
+    if [ $(grep -c "Using the monodisperse kernel" kernel.log) != "1" ] \
+	|| [ $(grep -c "Using the monodisperse kernel" generic.log) != "0" ]; then
+	echo "HS_kernel_test -: FAILED, the kernel was not selected exactly once"
+	exit 1
+    fi
+
+    bzcat kernel.end.xml.bz2 | $Xml sel -t -c '//ParticleData' > kernel.dat
+    bzcat generic.end.xml.bz2 | $Xml ed -d '//Pt/@D' | $Xml sel -t -c '//ParticleData' > generic.dat
+
+    if cmp -s kernel.dat generic.dat; then
+	echo "HS_kernel_test -: PASSED"
+    else
+	echo "HS_kernel_test -: FAILED"
+	exit 1
+    fi
+
+#Cleanup
+    rm -Rf kernel.xml.bz2 generic.xml.bz2 kernel.end.xml.bz2 generic.end.xml.bz2 \
+	kernel.dat generic.dat kernel.log generic.log output.xml.bz2 run.log
+}
+
+function HashCaptureStoreTest {
+#Selects the hashed capture store of a square well system through an
+#empty CaptureMap, which must be rebuilt from the particle positions.
+#The trajectory must match the default store loaded with the pairs.
+    > run.log
+
+    ./dynamod -s 1 -m 1 -C 5 -o map.xml.bz2 >> run.log 2>&1
+
+    bzcat map.xml.bz2 | $Xml ed \
+	-d '//Interaction/CaptureMap/Pair' \
+	-s '//Interaction/CaptureMap' -t attr -n Store -v "Hash" \
+	| bzip2 > hash.xml.bz2
+
+    ./dynarun -c 100000 map.xml.bz2 -o map.end.xml.bz2 > map.log 2>&1
+    ./dynarun -c 100000 hash.xml.bz2 -o hash.end.xml.bz2 > hash.log 2>&1
+    cat map.log hash.log >> run.log
+
+    if [ $(bzcat hash.end.xml.bz2 | $Xml sel -t -v 'count(//Interaction/CaptureMap[@Store="Hash"]/Pair)') == "0" ]; then
+	echo "HashCaptureStoreTest -: FAILED, the hashed capture map is empty"
+	exit 1
+    fi
+
+    bzcat map.end.xml.bz2 | $Xml sel -t -c '//ParticleData' -c '//Interaction/CaptureMap/Pair' > map.dat
+    bzcat hash.end.xml.bz2 | $Xml sel -t -c '//ParticleData' -c '//Interaction/CaptureMap/Pair' > hash.dat
+
+    if cmp -s map.dat hash.dat; then
+	echo "HashCaptureStoreTest -: PASSED"
+    else
+	echo "HashCaptureStoreTest -: FAILED"
+	exit 1
+    fi
+
+#Cleanup
+    rm -Rf map.xml.bz2 hash.xml.bz2 map.end.xml.bz2 hash.end.xml.bz2 \
+	map.dat hash.dat map.log hash.log output.xml.bz2 run.log
+}
+
+echo "CONFIGURATION FILES"
+echo "Testing the binary format round trip of hard spheres"
+BinaryConfigRoundTrip 0
+echo "Testing the binary format round trip of square wells (capture maps)"
+BinaryConfigRoundTrip 1
+echo "Testing the binary format round trip of lines (orientation data)"
+BinaryConfigRoundTrip 9
+echo "Testing the binary format round trip of polydisperse spheres (particle properties)"
+BinaryConfigRoundTrip 26
+
+echo ""
 echo "SCHEDULER AND SORTER TESTING"
 echo "Testing basic system, zero + infinite time events, hard spheres, PBC, Dumb Scheduler, CBT"
 cannon "Dumb" "CBT"
@@ -726,12 +837,16 @@ cannon "NeighbourList" "BoundedPQ"
 
 echo ""
 echo "INTERACTIONS+Dynamod Systems"
+echo "Testing the monodisperse hard sphere kernel against the generic path"
+HS_kernel_test
 echo "Testing Hard Spheres, NeighbourLists and BoundedPQ's"
 HardSphereTest
 echo "Testing binary hard spheres, NeighbourLists and BoundedPQ's"
 BinarySphereTest "Cells"
 echo "Testing Square Wells, Thermostats, NeighbourLists and BoundedPQ's"
 SquareWellTest
+echo "Testing the hashed capture store of square wells, selected by an empty CaptureMap"
+HashCaptureStoreTest
 echo "Testing infinitely heavy particles"
 HeavySphereTest
 echo "Testing Lines, NeighbourLists and BoundedPQ's"
@@ -788,3 +903,7 @@ echo "Testing replica exchange of hard spheres"
 HS_replex_test "NeighbourList"
 echo "Testing replica exchange of hard spheres with 3 threads"
 HS_replex_test "NeighbourList" "-N3"
+echo "Testing asynchronous replica exchange of hard spheres with 3 threads"
+HS_replex_test "NeighbourList" "-N3 --replex-async"
+echo "Testing asynchronous replica exchange with adaptive exchange intervals"
+HS_replex_test "NeighbourList" "-N3 --replex-async --replex-adaptive"